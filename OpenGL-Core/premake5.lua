@@ -44,6 +44,9 @@ project "OpenGL-Core"
 		"opengl32.lib"
 	}
 
+	filter "options:track-allocations"
+		defines "GLCORE_TRACK_ALLOCATIONS"
+
 	filter "system:windows"
 		systemversion "latest"
 
@@ -0,0 +1,182 @@
+#include "glpch.h"
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace GLCore {
+
+	static thread_local AllocationStats t_Stats;
+
+	struct ScopeEntry
+	{
+		AllocationScopeStats Stats;
+		AllocationStats Current;
+		bool RanThisFrame = false;
+	};
+
+	// Fixed storage, so recording a scope never allocates itself
+	static constexpr size_t MaxScopes = 64;
+	static std::mutex s_ScopeMutex;
+	static ScopeEntry s_Scopes[MaxScopes];
+	static size_t s_ScopeCount = 0;
+
+	bool AllocationTracker::IsEnabled()
+	{
+#ifdef GLCORE_TRACK_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	AllocationStats AllocationTracker::GetThreadStats()
+	{
+		return t_Stats;
+	}
+
+	void AllocationTracker::NewFrame()
+	{
+		std::lock_guard<std::mutex> lock(s_ScopeMutex);
+		for (size_t i = 0; i < s_ScopeCount; i++)
+		{
+			ScopeEntry& entry = s_Scopes[i];
+			entry.Stats.LastFrame = entry.Current;
+			entry.Stats.Frames += entry.RanThisFrame ? 1 : 0;
+			entry.Current = AllocationStats();
+			entry.RanThisFrame = false;
+		}
+	}
+
+	void AllocationTracker::GetScopeStats(std::vector<AllocationScopeStats>& out)
+	{
+		out.clear();
+		std::lock_guard<std::mutex> lock(s_ScopeMutex);
+		for (size_t i = 0; i < s_ScopeCount; i++)
+			out.push_back(s_Scopes[i].Stats);
+	}
+
+	void AllocationTracker::RecordScope(const char* name, const AllocationStats& stats)
+	{
+		if (!IsEnabled())
+			return;
+
+		std::lock_guard<std::mutex> lock(s_ScopeMutex);
+		ScopeEntry* entry = nullptr;
+		for (size_t i = 0; i < s_ScopeCount && !entry; i++)
+		{
+			if (s_Scopes[i].Stats.Name == name || strcmp(s_Scopes[i].Stats.Name, name) == 0)
+				entry = &s_Scopes[i];
+		}
+		if (!entry)
+		{
+			if (s_ScopeCount == MaxScopes)
+				return;
+			entry = &s_Scopes[s_ScopeCount++];
+			entry->Stats.Name = name;
+		}
+
+		entry->Current += stats;
+		entry->Stats.Total += stats;
+		entry->RanThisFrame = true;
+	}
+
+}
+
+#ifdef GLCORE_TRACK_ALLOCATIONS
+
+// Replacements for the global allocation functions. They count, then
+// forward to the C runtime.
+
+static void* CountedAllocate(size_t size)
+{
+	GLCore::t_Stats.Count++;
+	GLCore::t_Stats.Bytes += size;
+	return malloc(size ? size : 1);
+}
+
+static void* CountedAllocateAligned(size_t size, size_t alignment)
+{
+	GLCore::t_Stats.Count++;
+	GLCore::t_Stats.Bytes += size;
+#ifdef GLCORE_PLATFORM_WINDOWS
+	return _aligned_malloc(size ? size : 1, alignment);
+#else
+	void* memory = nullptr;
+	if (posix_memalign(&memory, std::max(alignment, sizeof(void*)), size ? size : 1) != 0)
+		return nullptr;
+	return memory;
+#endif
+}
+
+static void CountedFree(void* memory)
+{
+	if (!memory)
+		return;
+	GLCore::t_Stats.FreeCount++;
+	free(memory);
+}
+
+static void CountedFreeAligned(void* memory)
+{
+	if (!memory)
+		return;
+	GLCore::t_Stats.FreeCount++;
+#ifdef GLCORE_PLATFORM_WINDOWS
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
+void* operator new(size_t size)
+{
+	if (void* memory = CountedAllocate(size))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	if (void* memory = CountedAllocate(size))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	if (void* memory = CountedAllocateAligned(size, (size_t)alignment))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	if (void* memory = CountedAllocateAligned(size, (size_t)alignment))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocateAligned(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocateAligned(size, (size_t)alignment); }
+
+void operator delete(void* memory) noexcept { CountedFree(memory); }
+void operator delete[](void* memory) noexcept { CountedFree(memory); }
+void operator delete(void* memory, size_t) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, size_t) noexcept { CountedFree(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { CountedFree(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept { CountedFreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { CountedFreeAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { CountedFreeAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { CountedFreeAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { CountedFreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { CountedFreeAligned(memory); }
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Core.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GLCore {
+
+	struct AllocationStats
+	{
+		uint64_t Count = 0;       // Calls to the global operator new
+		uint64_t Bytes = 0;       // Bytes requested by those calls
+		uint64_t FreeCount = 0;   // Calls to the global operator delete
+
+		inline AllocationStats operator-(const AllocationStats& other) const
+		{
+			return { Count - other.Count, Bytes - other.Bytes, FreeCount - other.FreeCount };
+		}
+
+		inline AllocationStats& operator+=(const AllocationStats& other)
+		{
+			Count += other.Count;
+			Bytes += other.Bytes;
+			FreeCount += other.FreeCount;
+			return *this;
+		}
+	};
+
+	struct AllocationScopeStats
+	{
+		const char* Name = nullptr;
+		AllocationStats LastFrame;
+		AllocationStats Total;
+		uint64_t Frames = 0;   // Frames in which the scope ran
+	};
+
+	// Counts heap allocations per thread. Counting is opt-in: building with
+	// GLCORE_TRACK_ALLOCATIONS replaces the global operator new and delete,
+	// otherwise IsEnabled returns false and every count stays zero.
+	class AllocationTracker
+	{
+	public:
+		static bool IsEnabled();
+
+		// Running totals for the calling thread, so workers never show up in
+		// the main thread's numbers
+		static AllocationStats GetThreadStats();
+
+		// Closes the frame for every scope. Called by the application.
+		static void NewFrame();
+		static void GetScopeStats(std::vector<AllocationScopeStats>& out);
+	private:
+		static void RecordScope(const char* name, const AllocationStats& stats);
+
+		friend class AllocationScope;
+	};
+
+	// Counts the allocations the current thread makes while the scope is
+	// alive, and adds them to the scope's per-frame totals
+	class AllocationScope
+	{
+	public:
+		AllocationScope(const char* name)
+			: m_Name(name), m_Start(AllocationTracker::GetThreadStats()) {}
+		~AllocationScope() { AllocationTracker::RecordScope(m_Name, GetStats()); }
+
+		AllocationScope(const AllocationScope&) = delete;
+		AllocationScope& operator=(const AllocationScope&) = delete;
+
+		inline AllocationStats GetStats() const { return AllocationTracker::GetThreadStats() - m_Start; }
+	private:
+		const char* m_Name;
+		AllocationStats m_Start;
+	};
+
+}
+
+#define GLCORE_ALLOCATION_SCOPE_CONCAT_IMPL(a, b) a##b
+#define GLCORE_ALLOCATION_SCOPE_CONCAT(a, b) GLCORE_ALLOCATION_SCOPE_CONCAT_IMPL(a, b)
+// The name must be a string literal or otherwise outlive the program's use of the tracker
+#define GLCORE_ALLOCATION_SCOPE(name) ::GLCore::AllocationScope GLCORE_ALLOCATION_SCOPE_CONCAT(allocationScope, __LINE__)(name)
@@ -5,7 +5,7 @@
 
 #include "Input.h"
 
-#include <glfw/glfw3.h>
+#include "GLCore/Util/OpenGLDebug.h"
 
 namespace GLCore {
 
@@ -15,17 +15,28 @@ namespace GLCore {
 
 	Application::Application(const std::string& name, uint32_t width, uint32_t height)
 	{
-		if (!s_Instance)
-		{
-			// Initialize core
+		// Initialize core, unless the client already configured logging
+		if (!Log::IsInitialized())
 			Log::Init();
-		}
 
 		GLCORE_ASSERT(!s_Instance, "Application already exists!");
 		s_Instance = this;
 
 		m_Window = std::unique_ptr<Window>(Window::Create({ name, width, height }));
 		m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
+		m_DeletionQueue = std::make_unique<Utils::GLDeletionQueue>();
+		m_FramePacer = std::make_unique<FramePacer>(*m_Window);
+		m_FrameUniforms = std::make_unique<Utils::FrameUniformBuffer>();
+		m_FrameGraph = std::make_unique<Utils::FrameGraph>(m_FrameAllocator);
+		m_JobSystem = std::make_unique<JobSystem>();
+		m_FrameCapture = std::make_unique<Utils::FrameCapture>(*m_JobSystem);
+
+		// A pack, when present, shadows the loose files it was built from
+		m_FileSystem = std::make_unique<VirtualFileSystem>();
+		m_FileSystem->MountDirectory(".");
+		if (m_FileSystem->Exists("assets.pak"))
+			m_FileSystem->MountPack("assets.pak");
+		m_Assets = std::make_unique<Utils::AssetManager>(*m_FileSystem);
 
 		// Renderer::Init();
 
@@ -33,6 +44,20 @@ namespace GLCore {
 		PushOverlay(m_ImGuiLayer);
 	}
 
+	Application::~Application()
+	{
+		// Release GL objects while the context and the log still exist, so the
+		// deletion queue can delete them and report whatever is left
+		m_LayerStack.Clear();
+		m_FrameCapture.reset();
+		m_FrameGraph.reset();
+		m_FrameUniforms.reset();
+		m_DeletionQueue.reset();
+
+		Utils::LogGLDebugReport();
+		Log::Shutdown();
+	}
+
 	void Application::PushLayer(Layer* layer)
 	{
 		m_LayerStack.PushLayer(layer);
@@ -45,8 +70,14 @@ namespace GLCore {
 
 	void Application::OnEvent(Event& e)
 	{
+		Input::OnEvent(e);
+
+		// UI may react to any event, and it takes a frame or two to settle
+		m_PendingRedraws = 2;
+
 		EventDispatcher dispatcher(e);
 		dispatcher.Dispatch<WindowCloseEvent>(BIND_EVENT_FN(OnWindowClose));
+		dispatcher.Dispatch<WindowResizeEvent>(BIND_EVENT_FN(OnWindowResize));
 
 		for (auto it = m_LayerStack.end(); it != m_LayerStack.begin(); )
 		{
@@ -60,20 +91,105 @@ namespace GLCore {
 	{
 		while (m_Running)
 		{
-			float time = (float)glfwGetTime();
-			Timestep timestep = time - m_LastFrameTime;
-			m_LastFrameTime = time;
+			AllocationStats frameStart = AllocationTracker::GetThreadStats();
+
+			m_FramePacer->BeginFrame();
+			m_Window->PollEvents();
+
+			m_FrameClock.Tick();
+			Timestep timestep = m_FrameClock.GetTimestep();
+
+			Input::NewFrame();
+
+			RunFixedUpdates();
+
+			if (m_Minimized || (m_OnDemandRendering && m_PendingRedraws == 0 && m_Damage.IsEmpty()))
+			{
+				// Nothing to show: skip the frame and sleep until an event or the next simulation step
+				uint64_t untilNextStep = m_FixedUpdatePeriod - m_FixedUpdateAccumulator;
+				m_FramePacer->SkipFrame();
+				m_Window->WaitEvents(untilNextStep * 1e-9);
+				continue;
+			}
+			if (m_PendingRedraws > 0)
+				m_PendingRedraws--;
+
+			m_FrameUniforms->SetTime(m_FrameClock.GetTime(), timestep);
+			m_FrameUniforms->SetViewport(m_Window->GetWidth(), m_Window->GetHeight());
+
+			m_FrameAllocator.Reset();
+			m_FrameGraph->BeginFrame(m_Window->GetWidth(), m_Window->GetHeight());
+			{
+				GLCORE_ALLOCATION_SCOPE("Layer updates");
+				for (Layer* layer : m_LayerStack)
+					layer->OnUpdate(timestep);
+			}
+			{
+				GLCORE_ALLOCATION_SCOPE("Frame graph");
+				m_FrameGraph->Compile();
+				m_FrameGraph->Execute();
+			}
+			m_FrameCapture->Capture(0, m_Window->GetWidth(), m_Window->GetHeight());
+
+			{
+				GLCORE_ALLOCATION_SCOPE("ImGui");
+				m_ImGuiLayer->Begin();
+				for (Layer* layer : m_LayerStack)
+					layer->OnImGuiRender();
+				m_ImGuiLayer->End();
+			}
+
+			m_Window->SwapBuffers();
+			m_DeletionQueue->EndFrame();
+			m_FramePacer->EndFrame();
+			m_Damage.Clear();
+
+			Utils::NewGLDebugFrame();
+			m_FrameAllocations = AllocationTracker::GetThreadStats() - frameStart;
+			AllocationTracker::NewFrame();
+		}
+	}
 
-			for (Layer* layer : m_LayerStack)
-				layer->OnUpdate(timestep);
+	void Application::SetFixedUpdateRate(float hz)
+	{
+		m_FixedUpdatePeriod = (uint64_t)(1e9 / std::max(hz, 1.0f));
+		m_FixedUpdateAccumulator = 0;
+	}
+
+	void Application::RunFixedUpdates()
+	{
+		m_FixedUpdateAccumulator += m_FrameClock.GetDeltaNanoseconds();
+
+		Timestep fixedTimestep = Timestep::FromNanoseconds(m_FixedUpdatePeriod);
+		uint32_t steps = 0;
+		while (m_FixedUpdateAccumulator >= m_FixedUpdatePeriod)
+		{
+			if (steps == m_MaxFixedUpdateSteps)
+			{
+				// Too far behind; drop the backlog but keep the phase
+				m_FixedUpdateAccumulator %= m_FixedUpdatePeriod;
+				break;
+			}
 
-			m_ImGuiLayer->Begin();
 			for (Layer* layer : m_LayerStack)
-				layer->OnImGuiRender();
-			m_ImGuiLayer->End();
+				layer->OnFixedUpdate(fixedTimestep);
 
-			m_Window->OnUpdate();
+			m_FixedUpdateAccumulator -= m_FixedUpdatePeriod;
+			steps++;
 		}
+
+		m_FixedUpdateAlpha = (float)((double)m_FixedUpdateAccumulator / (double)m_FixedUpdatePeriod);
+	}
+
+	bool Application::OnWindowResize(WindowResizeEvent& e)
+	{
+		// A minimized window has no area to render into
+		m_Minimized = e.GetWidth() == 0 || e.GetHeight() == 0;
+		if (!m_Minimized)
+			glViewport(0, 0, e.GetWidth(), e.GetHeight());
+
+		// Layers still need to see the event
+		return false;
 	}
 
 	bool Application::OnWindowClose(WindowCloseEvent& e)
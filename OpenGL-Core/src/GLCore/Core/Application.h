@@ -3,13 +3,25 @@
 #include "Core.h"
 
 #include "Window.h"
+#include "FramePacer.h"
+#include "FrameClock.h"
+#include "DamageTracker.h"
 #include "LayerStack.h"
+#include "JobSystem.h"
+#include "Memory.h"
+#include "AllocationTracker.h"
+#include "VirtualFileSystem.h"
 #include "../Events/Event.h"
 #include "../Events/ApplicationEvent.h"
 
 #include "Timestep.h"
 
 #include "../ImGui/ImGuiLayer.h"
+#include "../Util/FrameUniforms.h"
+#include "../Util/FrameGraph.h"
+#include "../Util/FrameCapture.h"
+#include "../Util/AssetManager.h"
+#include "../Util/GLResource.h"
 
 namespace GLCore {
 
@@ -17,7 +29,7 @@ namespace GLCore {
 	{
 	public:
 		Application(const std::string& name = "Simple Village", uint32_t width = 1280, uint32_t height = 720);
-		virtual ~Application() = default;
+		virtual ~Application();
 
 		void Run();
 
@@ -27,16 +39,79 @@ namespace GLCore {
 		void PushOverlay(Layer* layer);
 
 		inline Window& GetWindow() { return *m_Window; }
+		inline FramePacer& GetFramePacer() { return *m_FramePacer; }
+		inline FrameClock& GetFrameClock() { return m_FrameClock; }
+		// Scratch memory for the frame being built. Reset at the start of every
+		// rendered frame, so nothing allocated from it may be kept longer.
+		inline LinearAllocator& GetFrameAllocator() { return m_FrameAllocator; }
+		// Heap allocations the main thread made during the last rendered frame.
+		// Always zero unless built with GLCORE_TRACK_ALLOCATIONS.
+		inline const AllocationStats& GetFrameAllocations() const { return m_FrameAllocations; }
+		// Time and viewport are set every frame; layers set their camera and upload before drawing
+		inline Utils::FrameUniformBuffer& GetFrameUniforms() { return *m_FrameUniforms; }
+		// Layers add passes in OnUpdate; the graph runs after all layers have updated, before ImGui
+		inline Utils::FrameGraph& GetFrameGraph() { return *m_FrameGraph; }
+		// Worker threads for CPU work that doesn't touch OpenGL
+		inline JobSystem& GetJobSystem() { return *m_JobSystem; }
+		// Captures the window after the frame graph has run, so ImGui is never recorded
+		inline Utils::FrameCapture& GetFrameCapture() { return *m_FrameCapture; }
+		// The working directory, overlaid by assets.pak when one exists
+		inline VirtualFileSystem& GetFileSystem() { return *m_FileSystem; }
+		inline Utils::AssetManager& GetAssets() { return *m_Assets; }
+		// Owns the GL objects released by handles until the GPU is done with them
+		inline Utils::GLDeletionQueue& GetDeletionQueue() { return *m_DeletionQueue; }
+
+		// Simulation rate for Layer::OnFixedUpdate, decoupled from the display rate
+		void SetFixedUpdateRate(float hz);
+		inline float GetFixedUpdateRate() const { return (float)(1e9 / m_FixedUpdatePeriod); }
+		// Upper bound on fixed steps per frame; any further backlog is dropped
+		inline void SetMaxFixedUpdateSteps(uint32_t steps) { m_MaxFixedUpdateSteps = steps; }
+		inline uint32_t GetMaxFixedUpdateSteps() const { return m_MaxFixedUpdateSteps; }
+		// How far rendering is between the last fixed step and the next one, in [0, 1)
+		inline float GetFixedUpdateAlpha() const { return m_FixedUpdateAlpha; }
+
+		// When enabled, frames are only rendered after input or when layers
+		// report damage; otherwise the loop sleeps until the next event or
+		// simulation step
+		inline void SetOnDemandRendering(bool enabled) { m_OnDemandRendering = enabled; RequestRedraw(); }
+		inline bool IsOnDemandRendering() const { return m_OnDemandRendering; }
+		// Layers add the screen regions they changed; cleared after each rendered frame
+		inline DamageTracker& GetDamage() { return m_Damage; }
+		inline void RequestRedraw() { m_PendingRedraws = std::max(m_PendingRedraws, 1u); }
+
+		inline void Close() { m_Running = false; }
 
 		inline static Application& Get() { return *s_Instance; }
 	private:
 		bool OnWindowClose(WindowCloseEvent& e);
+		bool OnWindowResize(WindowResizeEvent& e);
+		void RunFixedUpdates();
 	private:
 		std::unique_ptr<Window> m_Window;
+		std::unique_ptr<Utils::GLDeletionQueue> m_DeletionQueue;
+		std::unique_ptr<FramePacer> m_FramePacer;
+		LinearAllocator m_FrameAllocator{ 256 * 1024 };
+		AllocationStats m_FrameAllocations;
+		std::unique_ptr<Utils::FrameUniformBuffer> m_FrameUniforms;
+		std::unique_ptr<Utils::FrameGraph> m_FrameGraph;
+		std::unique_ptr<JobSystem> m_JobSystem;
+		std::unique_ptr<Utils::FrameCapture> m_FrameCapture;
+		std::unique_ptr<VirtualFileSystem> m_FileSystem;
+		std::unique_ptr<Utils::AssetManager> m_Assets;
 		ImGuiLayer* m_ImGuiLayer;
 		bool m_Running = true;
+		bool m_Minimized = false;
 		LayerStack m_LayerStack;
-		float m_LastFrameTime = 0.0f;
+		FrameClock m_FrameClock;
+
+		uint64_t m_FixedUpdatePeriod = 1000000000 / 60;
+		uint64_t m_FixedUpdateAccumulator = 0;
+		uint32_t m_MaxFixedUpdateSteps = 5;
+		float m_FixedUpdateAlpha = 0.0f;
+
+		bool m_OnDemandRendering = false;
+		DamageTracker m_Damage;
+		uint32_t m_PendingRedraws = 1;
 	private:
 		static Application* s_Instance;
 	};
@@ -15,4 +15,18 @@
 
 #define BIT(x) (1 << x)
 
-#define GLCORE_BIND_EVENT_FN(fn) std::bind(&fn, this, std::placeholders::_1)
\ No newline at end of file
+#define GLCORE_BIND_EVENT_FN(fn) std::bind(&fn, this, std::placeholders::_1)
+
+namespace GLCore {
+
+	// Shared ownership handle; the resource is released with the last reference
+	template<typename T>
+	using Ref = std::shared_ptr<T>;
+
+	template<typename T, typename... Args>
+	constexpr Ref<T> CreateRef(Args&&... args)
+	{
+		return std::make_shared<T>(std::forward<Args>(args)...);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "glpch.h"
+#include "DamageTracker.h"
+
+#include <limits>
+
+namespace GLCore {
+
+	void DamageTracker::Add(const DamageRect& rect)
+	{
+		if (m_Full || rect.IsEmpty())
+			return;
+
+		// Absorb every rect the new one touches; the union may then touch others
+		DamageRect merged = rect;
+		bool mergedAny = true;
+		while (mergedAny)
+		{
+			mergedAny = false;
+			for (size_t i = 0; i < m_Count; i++)
+			{
+				if (!merged.Overlaps(m_Rects[i]))
+					continue;
+
+				merged = merged.Union(m_Rects[i]);
+				m_Rects[i] = m_Rects[--m_Count];
+				mergedAny = true;
+				break;
+			}
+		}
+
+		if (m_Count < MaxRects)
+		{
+			m_Rects[m_Count++] = merged;
+			return;
+		}
+
+		// Out of slots: grow whichever rect needs the least extra area
+		size_t best = 0;
+		float bestGrowth = std::numeric_limits<float>::max();
+		for (size_t i = 0; i < m_Count; i++)
+		{
+			float growth = m_Rects[i].Union(merged).GetArea() - m_Rects[i].GetArea();
+			if (growth < bestGrowth)
+			{
+				bestGrowth = growth;
+				best = i;
+			}
+		}
+		m_Rects[best] = m_Rects[best].Union(merged);
+	}
+
+	void DamageTracker::Clear()
+	{
+		m_Count = 0;
+		m_Full = false;
+	}
+
+}
\ No newline at end of file
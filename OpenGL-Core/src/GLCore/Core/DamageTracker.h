@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Core.h"
+
+#include <algorithm>
+#include <array>
+
+namespace GLCore {
+
+	struct DamageRect
+	{
+		float MinX = 0.0f, MinY = 0.0f, MaxX = 0.0f, MaxY = 0.0f;
+
+		DamageRect() = default;
+		DamageRect(float minX, float minY, float maxX, float maxY)
+			: MinX(minX), MinY(minY), MaxX(maxX), MaxY(maxY) {}
+
+		inline bool IsEmpty() const { return MaxX <= MinX || MaxY <= MinY; }
+		inline float GetArea() const { return IsEmpty() ? 0.0f : (MaxX - MinX) * (MaxY - MinY); }
+
+		inline bool Overlaps(const DamageRect& other) const
+		{
+			return MinX <= other.MaxX && other.MinX <= MaxX && MinY <= other.MaxY && other.MinY <= MaxY;
+		}
+
+		inline DamageRect Union(const DamageRect& other) const
+		{
+			return { std::min(MinX, other.MinX), std::min(MinY, other.MinY), std::max(MaxX, other.MaxX), std::max(MaxY, other.MaxY) };
+		}
+	};
+
+	// Collects the regions that changed since the last presented frame.
+	// Overlapping rects are merged, and the list is kept to a handful of
+	// rects so scissored redraws stay cheap.
+	class DamageTracker
+	{
+	public:
+		static constexpr size_t MaxRects = 8;
+
+		void Add(const DamageRect& rect);
+		// Damages everything, e.g. after a resize or camera move
+		inline void AddFull() { m_Full = true; }
+		void Clear();
+
+		inline bool IsEmpty() const { return !m_Full && m_Count == 0; }
+		inline bool IsFull() const { return m_Full; }
+
+		inline size_t GetRectCount() const { return m_Count; }
+		inline const DamageRect& GetRect(size_t index) const { return m_Rects[index]; }
+	private:
+		std::array<DamageRect, MaxRects> m_Rects;
+		size_t m_Count = 0;
+		bool m_Full = false;
+	};
+
+}
\ No newline at end of file
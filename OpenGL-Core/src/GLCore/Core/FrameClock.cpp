@@ -0,0 +1,77 @@
+#include "glpch.h"
+#include "FrameClock.h"
+
+#include <chrono>
+
+namespace GLCore {
+
+	FrameClock::FrameClock()
+		: m_LastTick(Now())
+	{
+	}
+
+	uint64_t FrameClock::Now()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void FrameClock::Tick()
+	{
+		uint64_t now = Now();
+		m_RawDelta = now - m_LastTick;
+		m_LastTick = now;
+		m_FrameIndex++;
+
+		m_History[m_HistoryIndex] = m_RawDelta;
+		m_HistoryIndex = (m_HistoryIndex + 1) % HistorySize;
+		m_HistoryCount = std::min(m_HistoryCount + 1, HistorySize);
+
+		if (m_Paused)
+		{
+			m_Delta = 0;
+		}
+		else if (m_TimeScale == 1.0)
+		{
+			m_Delta = m_RawDelta;
+		}
+		else
+		{
+			// Carry the fractional nanosecond so scaled time doesn't drift
+			double scaled = m_RawDelta * m_TimeScale + m_ScaleRemainder;
+			m_Delta = (uint64_t)scaled;
+			m_ScaleRemainder = scaled - (double)m_Delta;
+		}
+		m_Elapsed += m_Delta;
+	}
+
+	Timestep FrameClock::GetSmoothedTimestep() const
+	{
+		if (m_Paused || m_HistoryCount == 0)
+			return Timestep();
+
+		size_t count = std::min(m_HistoryCount, SmoothingWindow);
+		uint64_t sum = 0;
+		for (size_t age = 0; age < count; age++)
+			sum += GetHistory(age);
+
+		return Timestep::FromNanoseconds((uint64_t)((sum / count) * m_TimeScale));
+	}
+
+	uint64_t FrameClock::GetHistory(size_t age) const
+	{
+		if (age >= m_HistoryCount)
+			return 0;
+
+		return m_History[(m_HistoryIndex + HistorySize - 1 - age) % HistorySize];
+	}
+
+	size_t FrameClock::CopyHistoryMilliseconds(float* out, size_t count) const
+	{
+		count = std::min(count, m_HistoryCount);
+		for (size_t i = 0; i < count; i++)
+			out[i] = GetHistory(count - 1 - i) * 1e-6f;
+		return count;
+	}
+
+}
\ No newline at end of file
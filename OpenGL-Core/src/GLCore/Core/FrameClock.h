@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Core.h"
+#include "Timestep.h"
+
+#include <array>
+
+namespace GLCore {
+
+	// Frame timing on a 64-bit monotonic nanosecond counter. Deltas are exact
+	// integers no matter how long the application has been running.
+	class FrameClock
+	{
+	public:
+		static constexpr size_t HistorySize = 256;
+		static constexpr size_t SmoothingWindow = 16;
+
+		FrameClock();
+
+		static uint64_t Now();
+
+		// Advances to the next frame. Called once per frame by the application.
+		void Tick();
+
+		inline uint64_t GetFrameIndex() const { return m_FrameIndex; }
+
+		// Wall-clock time between the last two ticks
+		inline uint64_t GetRawDeltaNanoseconds() const { return m_RawDelta; }
+		// Raw delta after pause and time scale are applied
+		inline uint64_t GetDeltaNanoseconds() const { return m_Delta; }
+		// Scaled time accumulated since the clock started
+		inline uint64_t GetElapsedNanoseconds() const { return m_Elapsed; }
+		inline double GetTime() const { return m_Elapsed * 1e-9; }
+
+		inline Timestep GetTimestep() const { return Timestep::FromNanoseconds(m_Delta); }
+		inline Timestep GetRawTimestep() const { return Timestep::FromNanoseconds(m_RawDelta); }
+		// Average of the last few raw deltas, with pause and time scale applied
+		Timestep GetSmoothedTimestep() const;
+
+		void SetPaused(bool paused) { m_Paused = paused; }
+		inline bool IsPaused() const { return m_Paused; }
+		void SetTimeScale(double scale) { m_TimeScale = scale > 0.0 ? scale : 0.0; }
+		inline double GetTimeScale() const { return m_TimeScale; }
+
+		// Raw delta 'age' frames ago, 0 being the most recent
+		uint64_t GetHistory(size_t age) const;
+		inline size_t GetHistoryCount() const { return m_HistoryCount; }
+		// Writes up to 'count' raw deltas in milliseconds, oldest first. Returns the number written.
+		size_t CopyHistoryMilliseconds(float* out, size_t count) const;
+	private:
+		uint64_t m_LastTick;
+		uint64_t m_FrameIndex = 0;
+		uint64_t m_RawDelta = 0, m_Delta = 0, m_Elapsed = 0;
+
+		bool m_Paused = false;
+		double m_TimeScale = 1.0;
+		double m_ScaleRemainder = 0.0;
+
+		std::array<uint64_t, HistorySize> m_History{};
+		size_t m_HistoryIndex = 0, m_HistoryCount = 0;
+	};
+
+}
\ No newline at end of file
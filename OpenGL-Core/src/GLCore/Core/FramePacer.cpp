@@ -0,0 +1,155 @@
+#include "glpch.h"
+#include "FramePacer.h"
+
+#include "FrameClock.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#ifdef GLCORE_PLATFORM_WINDOWS
+	#include <timeapi.h>
+	#pragma comment(lib, "winmm.lib")
+#endif
+
+namespace GLCore {
+
+	// Sleeping is only trusted up to this far before a deadline, the rest is spun
+	static constexpr uint64_t SpinThreshold = 2000000;
+	// Extra headroom when predicting how long a frame takes in low-latency mode
+	static constexpr uint64_t LowLatencyMargin = 1000000;
+
+	FramePacer::FramePacer(Window& window)
+		: m_Window(window)
+	{
+		SetTargetRate(m_TargetRate);
+	}
+
+	FramePacer::~FramePacer()
+	{
+#ifdef GLCORE_PLATFORM_WINDOWS
+		if (m_HighResolutionSleep)
+			timeEndPeriod(1);
+#endif
+	}
+
+	void FramePacer::SetMode(FramePacingMode mode)
+	{
+		m_Mode = mode;
+
+		switch (mode)
+		{
+			case FramePacingMode::VSync:         m_Window.SetVSyncMode(VSyncMode::On); break;
+			case FramePacingMode::AdaptiveVSync: m_Window.SetVSyncMode(VSyncMode::Adaptive); break;
+			default:                             m_Window.SetVSyncMode(VSyncMode::Off); break;
+		}
+
+		bool limited = mode == FramePacingMode::Limited || mode == FramePacingMode::LowLatency;
+#ifdef GLCORE_PLATFORM_WINDOWS
+		// The default ~15.6ms scheduler tick is far too coarse for the limiter
+		if (limited && !m_HighResolutionSleep)
+			timeBeginPeriod(1);
+		else if (!limited && m_HighResolutionSleep)
+			timeEndPeriod(1);
+#endif
+		m_HighResolutionSleep = limited;
+		m_NextPresent = 0;
+	}
+
+	void FramePacer::SetTargetRate(float hz)
+	{
+		m_TargetRate = std::max(hz, 1.0f);
+		m_TargetPeriod = (uint64_t)(1e9 / m_TargetRate);
+		m_NextPresent = 0;
+	}
+
+	void FramePacer::BeginFrame()
+	{
+		if (m_Mode == FramePacingMode::LowLatency && m_NextPresent != 0)
+		{
+			uint64_t lead = m_WorkEstimate + LowLatencyMargin;
+			if (m_NextPresent > lead)
+				WaitUntil(m_NextPresent - lead);
+		}
+
+		m_InputTime = FrameClock::Now();
+	}
+
+	void FramePacer::EndFrame()
+	{
+		if (m_Mode == FramePacingMode::Limited && m_NextPresent != 0)
+			WaitUntil(m_NextPresent);
+
+		uint64_t now = FrameClock::Now();
+
+		// Exponential moving average, 1/8 weight for the new sample
+		uint64_t work = now - m_InputTime;
+		m_WorkEstimate = m_WorkEstimate == 0 ? work : m_WorkEstimate - m_WorkEstimate / 8 + work / 8;
+
+		if (m_LastPresent != 0)
+			UpdateStats(now - m_LastPresent);
+		m_LastPresent = now;
+
+		// Schedule against absolute deadlines so rounding doesn't accumulate,
+		// but don't try to catch up after a long stall
+		if (m_NextPresent == 0 || now > m_NextPresent + m_TargetPeriod)
+			m_NextPresent = now + m_TargetPeriod;
+		else
+			m_NextPresent += m_TargetPeriod;
+	}
+
+	void FramePacer::SkipFrame()
+	{
+		m_LastPresent = 0;
+		m_NextPresent = 0;
+	}
+
+	void FramePacer::WaitUntil(uint64_t deadline)
+	{
+		uint64_t now = FrameClock::Now();
+		if (deadline > now + SpinThreshold)
+			std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now - SpinThreshold));
+
+		while (FrameClock::Now() < deadline)
+			std::this_thread::yield();
+	}
+
+	void FramePacer::UpdateStats(uint64_t interval)
+	{
+		m_Intervals[m_IntervalIndex] = interval;
+		m_IntervalIndex = (m_IntervalIndex + 1) % IntervalHistorySize;
+		m_IntervalCount = std::min(m_IntervalCount + 1, IntervalHistorySize);
+
+		double sum = 0.0;
+		for (size_t i = 0; i < m_IntervalCount; i++)
+			sum += (double)m_Intervals[i];
+		double mean = sum / m_IntervalCount;
+
+		double variance = 0.0, maxDeviation = 0.0;
+		for (size_t i = 0; i < m_IntervalCount; i++)
+		{
+			double deviation = (double)m_Intervals[i] - mean;
+			variance += deviation * deviation;
+			maxDeviation = std::max(maxDeviation, std::abs(deviation));
+		}
+		variance /= m_IntervalCount;
+
+		m_Stats.AverageIntervalMs = (float)(mean * 1e-6);
+		m_Stats.JitterMs = (float)(std::sqrt(variance) * 1e-6);
+		m_Stats.MaxDeviationMs = (float)(maxDeviation * 1e-6);
+	}
+
+	const char* FramePacer::GetModeName(FramePacingMode mode)
+	{
+		switch (mode)
+		{
+			case FramePacingMode::VSync:         return "VSync";
+			case FramePacingMode::AdaptiveVSync: return "Adaptive VSync";
+			case FramePacingMode::Uncapped:      return "Uncapped";
+			case FramePacingMode::Limited:       return "Frame limiter";
+			case FramePacingMode::LowLatency:    return "Low latency";
+		}
+		return "Unknown";
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Core.h"
+#include "Window.h"
+
+#include <array>
+
+namespace GLCore {
+
+	enum class FramePacingMode
+	{
+		VSync = 0,
+		AdaptiveVSync,
+		Uncapped,
+		// Present at the target rate: sleep, then spin the last stretch, after the swap
+		Limited,
+		// Present at the target rate, but do the waiting before input is polled so
+		// input is sampled as late as possible before the frame is built
+		LowLatency
+	};
+
+	struct FramePacingStats
+	{
+		float AverageIntervalMs = 0.0f;
+		float JitterMs = 0.0f;         // Standard deviation of present-to-present intervals
+		float MaxDeviationMs = 0.0f;   // Worst interval's distance from the average
+	};
+
+	class FramePacer
+	{
+	public:
+		FramePacer(Window& window);
+		~FramePacer();
+
+		void SetMode(FramePacingMode mode);
+		inline FramePacingMode GetMode() const { return m_Mode; }
+
+		void SetTargetRate(float hz);
+		inline float GetTargetRate() const { return m_TargetRate; }
+
+		// Called right before the window is polled for input
+		void BeginFrame();
+		// Called right after the buffers have been swapped
+		void EndFrame();
+		// Called instead of EndFrame when nothing was rendered. The idle time
+		// until the next rendered frame is kept out of the stats and the schedule.
+		void SkipFrame();
+
+		inline const FramePacingStats& GetStats() const { return m_Stats; }
+
+		static const char* GetModeName(FramePacingMode mode);
+	private:
+		void WaitUntil(uint64_t deadline);
+		void UpdateStats(uint64_t interval);
+	private:
+		Window& m_Window;
+		FramePacingMode m_Mode = FramePacingMode::VSync;
+		float m_TargetRate = 60.0f;
+		uint64_t m_TargetPeriod = 0;
+
+		uint64_t m_NextPresent = 0;
+		uint64_t m_LastPresent = 0;
+		uint64_t m_InputTime = 0;
+		uint64_t m_WorkEstimate = 0;   // Smoothed time from input polling to present
+
+		static constexpr size_t IntervalHistorySize = 120;
+		std::array<uint64_t, IntervalHistorySize> m_Intervals{};
+		size_t m_IntervalCount = 0, m_IntervalIndex = 0;
+		FramePacingStats m_Stats;
+
+		bool m_HighResolutionSleep = false;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "glpch.h"
+#include "Input.h"
+
+#include "GLCore/Events/KeyEvent.h"
+#include "GLCore/Events/MouseEvent.h"
+
+namespace GLCore {
+
+	InputSnapshot Input::s_Current;
+	InputSnapshot Input::s_Previous;
+	InputSnapshot Input::s_Pending;
+	InputSnapshot Input::s_Latched;
+
+	void Input::NewFrame()
+	{
+		s_Previous = s_Current;
+
+		s_Current.Keys = s_Pending.Keys | s_Latched.Keys;
+		s_Current.MouseButtons = s_Pending.MouseButtons | s_Latched.MouseButtons;
+		s_Current.MouseX = s_Pending.MouseX;
+		s_Current.MouseY = s_Pending.MouseY;
+
+		s_Latched.Keys.reset();
+		s_Latched.MouseButtons.reset();
+	}
+
+	void Input::SetSnapshot(const InputSnapshot& snapshot)
+	{
+		s_Current = snapshot;
+	}
+
+	void Input::OnEvent(Event& e)
+	{
+		switch (e.GetEventType())
+		{
+			case EventType::KeyPressed:
+			{
+				int keycode = static_cast<KeyPressedEvent&>(e).GetKeyCode();
+				if (IsValidKey(keycode))
+				{
+					s_Pending.Keys.set(keycode);
+					s_Latched.Keys.set(keycode);
+				}
+				break;
+			}
+			case EventType::KeyReleased:
+			{
+				int keycode = static_cast<KeyReleasedEvent&>(e).GetKeyCode();
+				if (IsValidKey(keycode))
+					s_Pending.Keys.reset(keycode);
+				break;
+			}
+			case EventType::MouseButtonPressed:
+			{
+				int button = static_cast<MouseButtonPressedEvent&>(e).GetMouseButton();
+				if (IsValidMouseButton(button))
+				{
+					s_Pending.MouseButtons.set(button);
+					s_Latched.MouseButtons.set(button);
+				}
+				break;
+			}
+			case EventType::MouseButtonReleased:
+			{
+				int button = static_cast<MouseButtonReleasedEvent&>(e).GetMouseButton();
+				if (IsValidMouseButton(button))
+					s_Pending.MouseButtons.reset(button);
+				break;
+			}
+			case EventType::MouseMoved:
+			{
+				auto& moved = static_cast<MouseMovedEvent&>(e);
+				s_Pending.MouseX = moved.GetX();
+				s_Pending.MouseY = moved.GetY();
+				break;
+			}
+			default:
+				break;
+		}
+	}
+
+}
\ No newline at end of file
@@ -1,32 +1,59 @@
 #pragma once
 
 #include "Core.h"
+#include "KeyCodes.h"
+#include "MouseButtonCodes.h"
+#include "../Events/Event.h"
+
+#include <bitset>
 
 namespace GLCore {
 
+	// Keyboard/mouse state as seen by one frame. Snapshots are plain values,
+	// so they can be recorded and fed back through Input::SetSnapshot for replay.
+	struct InputSnapshot
+	{
+		std::bitset<HZ_KEY_LAST + 1> Keys;
+		std::bitset<HZ_MOUSE_BUTTON_LAST + 1> MouseButtons;
+		float MouseX = 0.0f, MouseY = 0.0f;
+	};
+
 	class Input
 	{
-	protected:
-		Input() = default;
 	public:
-		Input(const Input&) = delete;
-		Input& operator=(const Input&) = delete;
-
-		inline static bool IsKeyPressed(int keycode) { return s_Instance->IsKeyPressedImpl(keycode); }
-
-		inline static bool IsMouseButtonPressed(int button) { return s_Instance->IsMouseButtonPressedImpl(button); }
-		inline static std::pair<float, float> GetMousePosition() { return s_Instance->GetMousePositionImpl(); }
-		inline static float GetMouseX() { return s_Instance->GetMouseXImpl(); }
-		inline static float GetMouseY() { return s_Instance->GetMouseYImpl(); }
-	protected:
-		virtual bool IsKeyPressedImpl(int keycode) = 0;
-
-		virtual bool IsMouseButtonPressedImpl(int button) = 0;
-		virtual std::pair<float, float> GetMousePositionImpl() = 0;
-		virtual float GetMouseXImpl() = 0;
-		virtual float GetMouseYImpl() = 0;
+		Input() = delete;
+
+		// Latches the state gathered from events since the last call.
+		// Called once per frame by the application before layers update.
+		static void NewFrame();
+		static void OnEvent(Event& e);
+
+		inline static bool IsKeyPressed(int keycode) { return IsValidKey(keycode) && s_Current.Keys[keycode]; }
+		inline static bool IsKeyPressedThisFrame(int keycode) { return IsValidKey(keycode) && s_Current.Keys[keycode] && !s_Previous.Keys[keycode]; }
+		inline static bool IsKeyReleasedThisFrame(int keycode) { return IsValidKey(keycode) && !s_Current.Keys[keycode] && s_Previous.Keys[keycode]; }
+
+		inline static bool IsMouseButtonPressed(int button) { return IsValidMouseButton(button) && s_Current.MouseButtons[button]; }
+		inline static bool IsMouseButtonPressedThisFrame(int button) { return IsValidMouseButton(button) && s_Current.MouseButtons[button] && !s_Previous.MouseButtons[button]; }
+		inline static bool IsMouseButtonReleasedThisFrame(int button) { return IsValidMouseButton(button) && !s_Current.MouseButtons[button] && s_Previous.MouseButtons[button]; }
+
+		inline static std::pair<float, float> GetMousePosition() { return { s_Current.MouseX, s_Current.MouseY }; }
+		inline static float GetMouseX() { return s_Current.MouseX; }
+		inline static float GetMouseY() { return s_Current.MouseY; }
+
+		inline static const InputSnapshot& GetSnapshot() { return s_Current; }
+		// Replaces the current frame's state, e.g. with a recorded snapshot.
+		static void SetSnapshot(const InputSnapshot& snapshot);
 	private:
-		static Input* s_Instance;
+		inline static bool IsValidKey(int keycode) { return keycode >= 0 && keycode <= HZ_KEY_LAST; }
+		inline static bool IsValidMouseButton(int button) { return button >= 0 && button <= HZ_MOUSE_BUTTON_LAST; }
+	private:
+		static InputSnapshot s_Current;
+		static InputSnapshot s_Previous;
+
+		// State accumulated from events between frames. Presses are also latched
+		// separately so a key tapped within a single frame is still seen as down.
+		static InputSnapshot s_Pending;
+		static InputSnapshot s_Latched;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "glpch.h"
+#include "JobSystem.h"
+
+namespace GLCore {
+
+	JobSystem::JobSystem(uint32_t workerCount)
+	{
+		if (workerCount == 0)
+			workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+		m_Workers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; i++)
+			m_Workers.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		// Queued jobs still run; they may own resources that need releasing
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+		}
+		m_JobAvailable.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	void JobSystem::Submit(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Queue.push_back(std::move(job));
+			m_Pending++;
+		}
+		m_JobAvailable.notify_one();
+	}
+
+	void JobSystem::Wait()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_AllDone.wait(lock, [this] { return m_Pending == 0; });
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& job)
+	{
+		if (count == 0)
+			return;
+
+		// Helpers may only start after the caller has returned, so the shared
+		// state outlives the call. They only touch 'job' for an index they claimed,
+		// and the caller can't return before that index is finished.
+		struct Batch
+		{
+			std::atomic<uint32_t> Next{ 0 };
+			uint32_t Done = 0;
+			std::mutex Mutex;
+			std::condition_variable Finished;
+		};
+		Ref<Batch> batch = CreateRef<Batch>();
+
+		auto run = [batch, count, &job]()
+		{
+			uint32_t finished = 0;
+			for (uint32_t index = batch->Next++; index < count; index = batch->Next++)
+			{
+				job(index);
+				finished++;
+			}
+			if (finished == 0)
+				return;
+
+			std::lock_guard<std::mutex> lock(batch->Mutex);
+			batch->Done += finished;
+			if (batch->Done == count)
+				batch->Finished.notify_all();
+		};
+
+		uint32_t helpers = std::min(count - 1, GetWorkerCount());
+		for (uint32_t i = 0; i < helpers; i++)
+			Submit(run);
+		run();
+
+		std::unique_lock<std::mutex> lock(batch->Mutex);
+		batch->Finished.wait(lock, [&batch, count] { return batch->Done == count; });
+	}
+
+	size_t JobSystem::GetPendingCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Pending;
+	}
+
+	void JobSystem::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_JobAvailable.wait(lock, [this] { return m_Stopping || !m_Queue.empty(); });
+				if (m_Queue.empty())
+					return;
+
+				job = std::move(m_Queue.front());
+				m_Queue.pop_front();
+			}
+
+			job();
+
+			bool allDone;
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				allDone = --m_Pending == 0;
+			}
+			if (allDone)
+				m_AllDone.notify_all();
+		}
+	}
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GLCore {
+
+	// A fixed pool of worker threads that run submitted jobs in FIFO order.
+	// Jobs must not touch OpenGL; hand results back to the main thread instead.
+	class JobSystem
+	{
+	public:
+		// Zero picks one worker per hardware thread, minus the main thread
+		JobSystem(uint32_t workerCount = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		void Submit(std::function<void()> job);
+		// Blocks until every submitted job has finished
+		void Wait();
+		// Runs job(0) to job(count - 1) on the workers and the calling thread,
+		// returning once all of them have finished. Other queued jobs aren't
+		// waited for, and the caller keeps working even if every worker is busy.
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& job);
+
+		inline uint32_t GetWorkerCount() const { return (uint32_t)m_Workers.size(); }
+		// Jobs submitted but not finished yet
+		size_t GetPendingCount() const;
+	private:
+		void WorkerLoop();
+	private:
+		std::vector<std::thread> m_Workers;
+		std::deque<std::function<void()>> m_Queue;
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_JobAvailable;
+		std::condition_variable m_AllDone;
+		size_t m_Pending = 0;
+		bool m_Stopping = false;
+	};
+
+	// Carries results from jobs back to the thread that submitted them. Jobs
+	// push through a Sink, which shares the queue, so a job that finishes
+	// after the owner is gone pushes into a queue nobody reads.
+	template<typename T>
+	class JobResults
+	{
+		struct Queue
+		{
+			std::mutex Mutex;
+			std::vector<T> Completed;
+		};
+	public:
+		class Sink
+		{
+		public:
+			void Push(T result) const
+			{
+				std::lock_guard<std::mutex> lock(m_Queue->Mutex);
+				m_Queue->Completed.push_back(std::move(result));
+			}
+		private:
+			Sink(const Ref<Queue>& queue)
+				: m_Queue(queue) {}
+
+			Ref<Queue> m_Queue;
+
+			friend class JobResults;
+		};
+
+		JobResults()
+			: m_Queue(CreateRef<Queue>()) {}
+
+		// Copied into each job
+		inline Sink GetSink() const { return Sink(m_Queue); }
+
+		// Replaces results with everything pushed since the last call. The
+		// vectors are swapped, so passing the same one each time reuses both
+		// buffers instead of allocating.
+		void Collect(std::vector<T>& results)
+		{
+			results.clear();
+			std::lock_guard<std::mutex> lock(m_Queue->Mutex);
+			results.swap(m_Queue->Completed);
+		}
+	private:
+		Ref<Queue> m_Queue;
+	};
+
+}
@@ -122,4 +122,6 @@
 #define HZ_KEY_RIGHT_CONTROL      345
 #define HZ_KEY_RIGHT_ALT          346
 #define HZ_KEY_RIGHT_SUPER        347
-#define HZ_KEY_MENU               348
\ No newline at end of file
+#define HZ_KEY_MENU               348
+
+#define HZ_KEY_LAST               HZ_KEY_MENU
\ No newline at end of file
@@ -8,9 +8,16 @@ namespace GLCore {
 	}
 
 	LayerStack::~LayerStack()
+	{
+		Clear();
+	}
+
+	void LayerStack::Clear()
 	{
 		for (Layer* layer : m_Layers)
 			delete layer;
+		m_Layers.clear();
+		m_LayerInsertIndex = 0;
 	}
 
 	void LayerStack::PushLayer(Layer* layer)
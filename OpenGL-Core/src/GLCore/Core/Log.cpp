@@ -1,17 +1,68 @@
 #include "glpch.h"
 #include "Log.h"
 
+#include "spdlog/async.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/sinks/rotating_file_sink.h"
 
 namespace GLCore {
 
 	std::shared_ptr<spdlog::logger> Log::s_Logger;
 
-	void Log::Init()
+	static spdlog::level::level_enum ActiveSpdlogLevel()
 	{
-		spdlog::set_pattern("%^[%T] %n: %v%$");
-		s_Logger = spdlog::stdout_color_mt("GLCORE");
-		s_Logger->set_level(spdlog::level::trace);
+		switch (GLCORE_ACTIVE_LOG_LEVEL)
+		{
+			case GLCORE_LOG_LEVEL_TRACE:    return spdlog::level::trace;
+			case GLCORE_LOG_LEVEL_INFO:     return spdlog::level::info;
+			case GLCORE_LOG_LEVEL_WARN:     return spdlog::level::warn;
+			case GLCORE_LOG_LEVEL_ERROR:    return spdlog::level::err;
+			case GLCORE_LOG_LEVEL_CRITICAL: return spdlog::level::critical;
+		}
+		return spdlog::level::off;
+	}
+
+	void Log::Init(const LogProps& props)
+	{
+		std::vector<spdlog::sink_ptr> sinks;
+		sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+		if (!props.FilePath.empty())
+			sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(props.FilePath, props.MaxFileSize, props.MaxFiles));
+
+		if (props.Async)
+		{
+			// spdlog's thread pool queue is a fixed-size ring buffer allocated up front
+			spdlog::init_thread_pool(props.QueueSize, 1);
+			auto policy = props.OverflowPolicy == LogOverflowPolicy::Block
+				? spdlog::async_overflow_policy::block
+				: spdlog::async_overflow_policy::overrun_oldest;
+			s_Logger = std::make_shared<spdlog::async_logger>("GLCORE", sinks.begin(), sinks.end(), spdlog::thread_pool(), policy);
+		}
+		else
+		{
+			s_Logger = std::make_shared<spdlog::logger>("GLCORE", sinks.begin(), sinks.end());
+		}
+
+		s_Logger->set_pattern("%^[%T] %n: %v%$");
+		s_Logger->set_level(ActiveSpdlogLevel());
+		s_Logger->flush_on(spdlog::level::err);
+		spdlog::register_logger(s_Logger);
+
+		if (props.Async || !props.FilePath.empty())
+			spdlog::flush_every(std::chrono::seconds(1));
+	}
+
+	void Log::Shutdown()
+	{
+		if (!s_Logger)
+			return;
+
+		// Drains the async queue and joins the background thread
+		s_Logger->flush();
+		spdlog::shutdown();
+		// Later LOG_* calls are dropped instead of reaching a logger whose
+		// thread pool is gone
+		s_Logger.reset();
 	}
 
 }
\ No newline at end of file
@@ -4,13 +4,60 @@
 #include "spdlog/spdlog.h"
 #include "spdlog/fmt/ostr.h"
 
+// Compile-time minimum log level. Macros below it expand to nothing, so their
+// arguments are not evaluated. Define GLCORE_ACTIVE_LOG_LEVEL to override.
+#define GLCORE_LOG_LEVEL_TRACE     0
+#define GLCORE_LOG_LEVEL_INFO      1
+#define GLCORE_LOG_LEVEL_WARN      2
+#define GLCORE_LOG_LEVEL_ERROR     3
+#define GLCORE_LOG_LEVEL_CRITICAL  4
+#define GLCORE_LOG_LEVEL_OFF       5
+
+#ifndef GLCORE_ACTIVE_LOG_LEVEL
+	#ifdef GLCORE_RELEASE
+		#define GLCORE_ACTIVE_LOG_LEVEL GLCORE_LOG_LEVEL_WARN
+	#else
+		#define GLCORE_ACTIVE_LOG_LEVEL GLCORE_LOG_LEVEL_TRACE
+	#endif
+#endif
+
 namespace GLCore {
 
+	enum class LogOverflowPolicy
+	{
+		Block = 0,       // Caller waits for room in the queue
+		OverrunOldest    // Oldest queued message is discarded
+	};
+
+	struct LogProps
+	{
+		// Messages are queued into a preallocated ring buffer and written by a
+		// background thread instead of on the calling thread.
+		bool Async;
+		size_t QueueSize;
+		LogOverflowPolicy OverflowPolicy;
+
+		// Optional rotating log file, in addition to the console.
+		std::string FilePath;
+		size_t MaxFileSize;
+		size_t MaxFiles;
+
+		LogProps(bool async = false,
+			     const std::string& filePath = "",
+			     LogOverflowPolicy overflowPolicy = LogOverflowPolicy::OverrunOldest)
+			: Async(async), QueueSize(8192), OverflowPolicy(overflowPolicy),
+			  FilePath(filePath), MaxFileSize(5 * 1024 * 1024), MaxFiles(3)
+		{
+		}
+	};
+
 	class Log
 	{
 	public:
-		static void Init();
+		static void Init(const LogProps& props = LogProps());
+		static void Shutdown();
 
+		inline static bool IsInitialized() { return (bool)s_Logger; }
 		inline static std::shared_ptr<spdlog::logger>& GetLogger() { return s_Logger; }
 	private:
 		static std::shared_ptr<spdlog::logger> s_Logger;
@@ -18,9 +65,37 @@ namespace GLCore {
 
 }
 
-// Client log macros
-#define LOG_TRACE(...)         ::GLCore::Log::GetLogger()->trace(__VA_ARGS__)
-#define LOG_INFO(...)          ::GLCore::Log::GetLogger()->info(__VA_ARGS__)
-#define LOG_WARN(...)          ::GLCore::Log::GetLogger()->warn(__VA_ARGS__)
-#define LOG_ERROR(...)         ::GLCore::Log::GetLogger()->error(__VA_ARGS__)
-#define LOG_CRITICAL(...)      ::GLCore::Log::GetLogger()->critical(__VA_ARGS__)
+// Client log macros. Calls made before Init or after Shutdown, e.g. from
+// destructors that run once the application has shut the log down, are dropped.
+#define GLCORE_LOG_CALL(method, ...) \
+	do { if (::GLCore::Log::IsInitialized()) ::GLCore::Log::GetLogger()->method(__VA_ARGS__); } while (0)
+
+#if GLCORE_ACTIVE_LOG_LEVEL <= GLCORE_LOG_LEVEL_TRACE
+	#define LOG_TRACE(...)     GLCORE_LOG_CALL(trace, __VA_ARGS__)
+#else
+	#define LOG_TRACE(...)     (void)0
+#endif
+
+#if GLCORE_ACTIVE_LOG_LEVEL <= GLCORE_LOG_LEVEL_INFO
+	#define LOG_INFO(...)      GLCORE_LOG_CALL(info, __VA_ARGS__)
+#else
+	#define LOG_INFO(...)      (void)0
+#endif
+
+#if GLCORE_ACTIVE_LOG_LEVEL <= GLCORE_LOG_LEVEL_WARN
+	#define LOG_WARN(...)      GLCORE_LOG_CALL(warn, __VA_ARGS__)
+#else
+	#define LOG_WARN(...)      (void)0
+#endif
+
+#if GLCORE_ACTIVE_LOG_LEVEL <= GLCORE_LOG_LEVEL_ERROR
+	#define LOG_ERROR(...)     GLCORE_LOG_CALL(error, __VA_ARGS__)
+#else
+	#define LOG_ERROR(...)     (void)0
+#endif
+
+#if GLCORE_ACTIVE_LOG_LEVEL <= GLCORE_LOG_LEVEL_CRITICAL
+	#define LOG_CRITICAL(...)  GLCORE_LOG_CALL(critical, __VA_ARGS__)
+#else
+	#define LOG_CRITICAL(...)  (void)0
+#endif
@@ -0,0 +1,96 @@
+#include "glpch.h"
+#include "MappedFile.h"
+
+#ifndef GLCORE_PLATFORM_WINDOWS
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace GLCore {
+
+#ifdef GLCORE_PLATFORM_WINDOWS
+
+	Ref<MappedFile> MappedFile::Open(const std::string& path)
+	{
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return nullptr;
+
+		Ref<MappedFile> mapped(new MappedFile());
+		mapped->m_File = file;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+			return nullptr;
+		mapped->m_Size = (size_t)size.QuadPart;
+
+		// Empty files can't be mapped, but they are still valid files
+		if (mapped->m_Size == 0)
+			return mapped;
+
+		mapped->m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapped->m_Mapping)
+			return nullptr;
+
+		mapped->m_Data = static_cast<const uint8_t*>(MapViewOfFile(mapped->m_Mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!mapped->m_Data)
+			return nullptr;
+
+		return mapped;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		if (m_Mapping)
+			CloseHandle(m_Mapping);
+		if (m_File)
+			CloseHandle(m_File);
+	}
+
+#else
+
+	Ref<MappedFile> MappedFile::Open(const std::string& path)
+	{
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return nullptr;
+
+		struct stat info;
+		if (fstat(file, &info) != 0)
+		{
+			close(file);
+			return nullptr;
+		}
+
+		Ref<MappedFile> mapped(new MappedFile());
+		mapped->m_Size = (size_t)info.st_size;
+		if (mapped->m_Size > 0)
+		{
+			void* data = mmap(nullptr, mapped->m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (data == MAP_FAILED)
+			{
+				close(file);
+				return nullptr;
+			}
+			mapped->m_Data = static_cast<const uint8_t*>(data);
+		}
+
+		// The mapping keeps the file alive on its own
+		close(file);
+		return mapped;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_Data)
+			munmap(const_cast<uint8_t*>(m_Data), m_Size);
+	}
+
+#endif
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Core.h"
+
+#include <cstdint>
+#include <string>
+
+namespace GLCore {
+
+	// A whole file mapped read-only into memory. Pages are loaded by the OS
+	// on first touch, so nothing is copied or read up front.
+	class MappedFile
+	{
+	public:
+		// Returns null if the file can't be opened or mapped
+		static Ref<MappedFile> Open(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		inline const uint8_t* GetData() const { return m_Data; }
+		inline size_t GetSize() const { return m_Size; }
+	private:
+		MappedFile() = default;
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+#ifdef GLCORE_PLATFORM_WINDOWS
+		void* m_File = nullptr;
+		void* m_Mapping = nullptr;
+#endif
+	};
+
+}
@@ -0,0 +1,201 @@
+#include "glpch.h"
+#include "Memory.h"
+
+namespace GLCore {
+
+	static size_t AlignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	////////////////////////////////////////////////////////////
+	// LinearAllocator /////////////////////////////////////////
+	////////////////////////////////////////////////////////////
+
+	LinearAllocator::LinearAllocator(size_t capacity)
+		: m_Capacity(capacity)
+	{
+		m_Buffer = static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(alignof(std::max_align_t))));
+	}
+
+	LinearAllocator::~LinearAllocator()
+	{
+		Reset();
+		::operator delete(m_Buffer, std::align_val_t(alignof(std::max_align_t)));
+	}
+
+	void* LinearAllocator::Allocate(size_t size, size_t alignment)
+	{
+		GLCORE_ASSERT((alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+
+		size_t offset = AlignUp(m_Offset, alignment);
+		if (offset + size <= m_Capacity)
+		{
+			m_Offset = offset + size;
+			m_Peak = std::max(m_Peak, GetUsed());
+			return m_Buffer + offset;
+		}
+
+		alignment = std::max(alignment, alignof(std::max_align_t));
+		void* memory = ::operator new(std::max<size_t>(size, 1), std::align_val_t(alignment));
+		m_Overflow.push_back({ memory, alignment });
+		m_OverflowBytes += size;
+		m_OverflowCount++;
+		m_Peak = std::max(m_Peak, GetUsed());
+		return memory;
+	}
+
+	void LinearAllocator::Reset()
+	{
+		if (!m_Overflow.empty())
+		{
+			for (auto [memory, alignment] : m_Overflow)
+				::operator delete(memory, std::align_val_t(alignment));
+			m_Overflow.clear();
+
+			// Make room for the whole cycle next time
+			size_t capacity = std::max(m_Capacity * 2, AlignUp(m_Peak, 4096));
+			::operator delete(m_Buffer, std::align_val_t(alignof(std::max_align_t)));
+			m_Buffer = static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(alignof(std::max_align_t))));
+			m_Capacity = capacity;
+		}
+
+		m_Offset = 0;
+		m_OverflowBytes = 0;
+	}
+
+	////////////////////////////////////////////////////////////
+	// PoolAllocator ///////////////////////////////////////////
+	////////////////////////////////////////////////////////////
+
+	PoolAllocator::PoolAllocator(size_t blockSize, size_t blocksPerPage, size_t alignment)
+		: m_BlocksPerPage(std::max<size_t>(blocksPerPage, 1)), m_Alignment(std::max(alignment, alignof(FreeBlock)))
+	{
+		// Free blocks hold the list link, and every block keeps the alignment
+		m_BlockSize = AlignUp(std::max(blockSize, sizeof(FreeBlock)), m_Alignment);
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		GLCORE_ASSERT(m_AllocatedCount == 0, "Pool destroyed with blocks still allocated");
+		for (void* page : m_Pages)
+			::operator delete(page, std::align_val_t(m_Alignment));
+	}
+
+	void* PoolAllocator::Allocate()
+	{
+		if (!m_FreeList)
+			AddPage();
+
+		FreeBlock* block = m_FreeList;
+		m_FreeList = block->Next;
+		m_AllocatedCount++;
+		return block;
+	}
+
+	void PoolAllocator::Free(void* block)
+	{
+		FreeBlock* freed = static_cast<FreeBlock*>(block);
+		freed->Next = m_FreeList;
+		m_FreeList = freed;
+		m_AllocatedCount--;
+	}
+
+	void PoolAllocator::AddPage()
+	{
+		uint8_t* page = static_cast<uint8_t*>(::operator new(m_BlockSize * m_BlocksPerPage, std::align_val_t(m_Alignment)));
+		m_Pages.push_back(page);
+
+		// Thread the new blocks onto the free list, lowest address first
+		for (size_t i = m_BlocksPerPage; i-- > 0; )
+		{
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(page + i * m_BlockSize);
+			block->Next = m_FreeList;
+			m_FreeList = block;
+		}
+	}
+
+	////////////////////////////////////////////////////////////
+	// RangeAllocator //////////////////////////////////////////
+	////////////////////////////////////////////////////////////
+
+	RangeAllocator::RangeAllocator(uint64_t capacity)
+		: m_Capacity(capacity)
+	{
+		if (capacity > 0)
+			AddFreeRange(0, capacity);
+	}
+
+	uint64_t RangeAllocator::Allocate(uint64_t size, uint64_t alignment)
+	{
+		if (size == 0)
+			return InvalidOffset;
+		alignment = std::max<uint64_t>(alignment, 1);
+
+		// Smallest first; a range may still be too small once its start is aligned
+		for (auto it = m_FreeBySize.lower_bound(size); it != m_FreeBySize.end(); ++it)
+		{
+			uint64_t rangeOffset = it->second, rangeSize = it->first;
+			uint64_t offset = (rangeOffset + alignment - 1) / alignment * alignment;
+			uint64_t padding = offset - rangeOffset;
+			if (padding + size > rangeSize)
+				continue;
+
+			RemoveFreeRange(m_FreeByOffset.find(rangeOffset));
+			if (padding > 0)
+				AddFreeRange(rangeOffset, padding);
+			if (padding + size < rangeSize)
+				AddFreeRange(offset + size, rangeSize - padding - size);
+
+			m_Used += size;
+			return offset;
+		}
+		return InvalidOffset;
+	}
+
+	void RangeAllocator::Free(uint64_t offset, uint64_t size)
+	{
+		GLCORE_ASSERT(offset + size <= m_Capacity, "Range is outside the allocator");
+		m_Used -= size;
+
+		// Merge with the free ranges on either side
+		auto next = m_FreeByOffset.lower_bound(offset);
+		if (next != m_FreeByOffset.end() && next->first == offset + size)
+		{
+			size += next->second;
+			RemoveFreeRange(next++);
+		}
+		if (next != m_FreeByOffset.begin())
+		{
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset)
+			{
+				offset = previous->first;
+				size += previous->second;
+				RemoveFreeRange(previous);
+			}
+		}
+		AddFreeRange(offset, size);
+	}
+
+	void RangeAllocator::AddFreeRange(uint64_t offset, uint64_t size)
+	{
+		m_FreeByOffset.emplace(offset, size);
+		m_FreeBySize.emplace(size, offset);
+	}
+
+	void RangeAllocator::RemoveFreeRange(std::map<uint64_t, uint64_t>::iterator range)
+	{
+		auto [first, last] = m_FreeBySize.equal_range(range->second);
+		for (auto it = first; it != last; ++it)
+		{
+			if (it->second == range->first)
+			{
+				m_FreeBySize.erase(it);
+				break;
+			}
+		}
+		m_FreeByOffset.erase(range);
+	}
+
+}
\ No newline at end of file
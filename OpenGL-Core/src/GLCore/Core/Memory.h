@@ -0,0 +1,181 @@
+#pragma once
+
+#include "Core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace GLCore {
+
+	// Bump allocator for memory that lives until the next Reset. Allocation
+	// is a pointer increment and nothing is freed individually. Requests
+	// past the capacity fall back to the heap, and the next Reset grows the
+	// buffer so a steady workload stops overflowing.
+	class LinearAllocator
+	{
+	public:
+		LinearAllocator(size_t capacity);
+		~LinearAllocator();
+
+		LinearAllocator(const LinearAllocator&) = delete;
+		LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		// Objects are never destroyed, so only trivially destructible types fit
+		template<typename T, typename... Args>
+		T* New(Args&&... args)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "Linear allocations are never destroyed");
+			return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		T* AllocateArray(size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "Linear allocations are never destroyed");
+			return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		// Invalidates everything allocated so far
+		void Reset();
+
+		inline size_t GetUsed() const { return m_Offset + m_OverflowBytes; }
+		inline size_t GetCapacity() const { return m_Capacity; }
+		// Most memory any single cycle has used since the allocator was created
+		inline size_t GetPeak() const { return m_Peak; }
+		inline uint32_t GetOverflowCount() const { return m_OverflowCount; }
+	private:
+		uint8_t* m_Buffer = nullptr;
+		size_t m_Capacity = 0;
+		size_t m_Offset = 0;
+		size_t m_Peak = 0;
+
+		std::vector<std::pair<void*, size_t>> m_Overflow;   // Memory and alignment
+		size_t m_OverflowBytes = 0;
+		uint32_t m_OverflowCount = 0;
+	};
+
+	// Standard allocator interface over a LinearAllocator, for containers
+	// that only live as long as the allocator's current cycle
+	template<typename T>
+	class LinearStdAllocator
+	{
+	public:
+		using value_type = T;
+
+		LinearStdAllocator(LinearAllocator& allocator) : m_Allocator(&allocator) {}
+		template<typename U>
+		LinearStdAllocator(const LinearStdAllocator<U>& other) : m_Allocator(other.GetAllocator()) {}
+
+		T* allocate(size_t count) { return static_cast<T*>(m_Allocator->Allocate(sizeof(T) * count, alignof(T))); }
+		void deallocate(T*, size_t) {}
+
+		inline LinearAllocator* GetAllocator() const { return m_Allocator; }
+
+		template<typename U>
+		bool operator==(const LinearStdAllocator<U>& other) const { return m_Allocator == other.GetAllocator(); }
+		template<typename U>
+		bool operator!=(const LinearStdAllocator<U>& other) const { return m_Allocator != other.GetAllocator(); }
+	private:
+		LinearAllocator* m_Allocator;
+	};
+
+	template<typename T>
+	using LinearVector = std::vector<T, LinearStdAllocator<T>>;
+
+	// Fixed-size blocks carved from pages and recycled through a free list.
+	// Pages are only released when the pool is destroyed.
+	class PoolAllocator
+	{
+	public:
+		PoolAllocator(size_t blockSize, size_t blocksPerPage = 64, size_t alignment = alignof(std::max_align_t));
+		~PoolAllocator();
+
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+		void* Allocate();
+		void Free(void* block);
+
+		inline size_t GetBlockSize() const { return m_BlockSize; }
+		inline size_t GetAllocatedCount() const { return m_AllocatedCount; }
+		inline size_t GetCapacity() const { return m_Pages.size() * m_BlocksPerPage; }
+	private:
+		void AddPage();
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+
+		size_t m_BlockSize, m_BlocksPerPage, m_Alignment;
+		FreeBlock* m_FreeList = nullptr;
+		std::vector<void*> m_Pages;
+		size_t m_AllocatedCount = 0;
+	};
+
+	// Typed front end for a PoolAllocator
+	template<typename T>
+	class ObjectPool
+	{
+	public:
+		ObjectPool(size_t objectsPerPage = 64)
+			: m_Pool(sizeof(T), objectsPerPage, alignof(T)) {}
+
+		template<typename... Args>
+		T* Create(Args&&... args)
+		{
+			return new (m_Pool.Allocate()) T(std::forward<Args>(args)...);
+		}
+
+		void Destroy(T* object)
+		{
+			if (!object)
+				return;
+			object->~T();
+			m_Pool.Free(object);
+		}
+
+		inline size_t GetCount() const { return m_Pool.GetAllocatedCount(); }
+		inline size_t GetCapacity() const { return m_Pool.GetCapacity(); }
+	private:
+		PoolAllocator m_Pool;
+	};
+
+	// Hands out ranges of an address space it doesn't own, such as a GPU
+	// buffer. Free ranges are kept by offset, so neighbours merge on free,
+	// and by size, so allocation picks the smallest range that fits.
+	class RangeAllocator
+	{
+	public:
+		static constexpr uint64_t InvalidOffset = ~0ull;
+
+		RangeAllocator(uint64_t capacity = 0);
+
+		// Returns InvalidOffset if no free range is large enough. Alignment
+		// need not be a power of two, so ranges can be aligned to a vertex
+		// stride; 0 is treated as 1.
+		uint64_t Allocate(uint64_t size, uint64_t alignment = 1);
+		// Size must match the size passed to Allocate
+		void Free(uint64_t offset, uint64_t size);
+
+		inline uint64_t GetCapacity() const { return m_Capacity; }
+		inline uint64_t GetUsed() const { return m_Used; }
+		inline size_t GetFreeRangeCount() const { return m_FreeByOffset.size(); }
+		inline uint64_t GetLargestFreeRange() const { return m_FreeBySize.empty() ? 0 : m_FreeBySize.rbegin()->first; }
+	private:
+		void AddFreeRange(uint64_t offset, uint64_t size);
+		void RemoveFreeRange(std::map<uint64_t, uint64_t>::iterator range);
+	private:
+		uint64_t m_Capacity, m_Used = 0;
+		std::map<uint64_t, uint64_t> m_FreeByOffset;
+		std::multimap<uint64_t, uint64_t> m_FreeBySize;
+	};
+
+}
\ No newline at end of file
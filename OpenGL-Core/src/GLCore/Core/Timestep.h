@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace GLCore {
 
 	class Timestep
@@ -10,6 +12,8 @@ namespace GLCore {
 		{
 		}
 
+		static Timestep FromNanoseconds(uint64_t nanoseconds) { return Timestep((float)(nanoseconds * 1e-9)); }
+
 		operator float() const { return m_Time; }
 
 		float GetSeconds() const { return m_Time; }
@@ -0,0 +1,314 @@
+#include "glpch.h"
+#include "VirtualFileSystem.h"
+#include "MappedFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace GLCore {
+
+	// Pack layout, little-endian:
+	//   PackHeader
+	//   file data, each file aligned to PackAlignment
+	//   PackEntry[EntryCount], sorted by Hash
+	//   path strings, not terminated
+	static constexpr char PackMagic[4] = { 'G', 'L', 'P', 'K' };
+	static constexpr uint32_t PackVersion = 1;
+	static constexpr uint64_t PackAlignment = 16;
+
+	struct PackHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Reserved;
+		uint64_t TocOffset;
+		uint64_t StringsOffset;
+		uint64_t StringsSize;
+	};
+	static_assert(sizeof(PackHeader) == 40, "Pack header layout changed");
+
+	struct PackEntry
+	{
+		uint64_t Hash;
+		uint64_t Offset;
+		uint64_t Size;
+		uint32_t NameOffset;
+		uint32_t NameLength;
+	};
+	static_assert(sizeof(PackEntry) == 32, "Pack entry layout changed");
+
+	struct VirtualFileSystem::Pack
+	{
+		Ref<MappedFile> File;
+		const PackEntry* Entries = nullptr;
+		uint32_t EntryCount = 0;
+		const char* Strings = nullptr;
+	};
+
+	VirtualFileSystem::VirtualFileSystem() = default;
+	VirtualFileSystem::~VirtualFileSystem() = default;
+
+	uint64_t VirtualFileSystem::HashPath(std::string_view path)
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : path)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::string VirtualFileSystem::NormalizePath(std::string_view path)
+	{
+		std::string normalized(path);
+		std::replace(normalized.begin(), normalized.end(), '\\', '/');
+		while (normalized.compare(0, 2, "./") == 0)
+			normalized.erase(0, 2);
+		return normalized;
+	}
+
+	void VirtualFileSystem::MountDirectory(const std::string& directory)
+	{
+		m_Mounts.push_back({ directory, nullptr });
+	}
+
+	bool VirtualFileSystem::MountPack(const std::string& path)
+	{
+		Ref<MappedFile> file = MappedFile::Open(path);
+		if (!file)
+			return false;
+
+		const uint8_t* data = file->GetData();
+		size_t size = file->GetSize();
+		if (size < sizeof(PackHeader))
+		{
+			LOG_ERROR("'{0}' is too small to be a pack", path);
+			return false;
+		}
+
+		PackHeader header;
+		memcpy(&header, data, sizeof(header));
+		if (memcmp(header.Magic, PackMagic, sizeof(PackMagic)) != 0 || header.Version != PackVersion
+			|| header.TocOffset % alignof(PackEntry) != 0
+			|| header.TocOffset + (uint64_t)header.EntryCount * sizeof(PackEntry) > size
+			|| header.StringsOffset + header.StringsSize > size)
+		{
+			LOG_ERROR("'{0}' is not a valid pack", path);
+			return false;
+		}
+
+		Ref<Pack> pack = CreateRef<Pack>();
+		pack->File = file;
+		pack->Entries = reinterpret_cast<const PackEntry*>(data + header.TocOffset);
+		pack->EntryCount = header.EntryCount;
+		pack->Strings = reinterpret_cast<const char*>(data + header.StringsOffset);
+
+		for (uint32_t i = 0; i < pack->EntryCount; i++)
+		{
+			const PackEntry& entry = pack->Entries[i];
+			if (entry.Offset + entry.Size > size || (uint64_t)entry.NameOffset + entry.NameLength > header.StringsSize)
+			{
+				LOG_ERROR("'{0}' has a corrupt table of contents", path);
+				return false;
+			}
+		}
+
+		m_Mounts.push_back({ std::string(), pack });
+		LOG_INFO("Mounted pack '{0}' ({1} files)", path, pack->EntryCount);
+		return true;
+	}
+
+	FileData VirtualFileSystem::FindInPack(const Ref<Pack>& pack, std::string_view path, uint64_t hash)
+	{
+		const PackEntry* begin = pack->Entries;
+		const PackEntry* end = pack->Entries + pack->EntryCount;
+		const PackEntry* entry = std::lower_bound(begin, end, hash,
+			[](const PackEntry& e, uint64_t value) { return e.Hash < value; });
+
+		// Different paths may share a hash, so compare names within the run
+		for (; entry != end && entry->Hash == hash; ++entry)
+		{
+			std::string_view name(pack->Strings + entry->NameOffset, entry->NameLength);
+			if (name != path)
+				continue;
+
+			FileData result;
+			result.m_Data = pack->File->GetData() + entry->Offset;
+			result.m_Size = (size_t)entry->Size;
+			result.m_Owner = pack;
+			result.m_Valid = true;
+			return result;
+		}
+		return FileData();
+	}
+
+	FileData VirtualFileSystem::Read(std::string_view path) const
+	{
+		std::string normalized = NormalizePath(path);
+		uint64_t hash = HashPath(normalized);
+
+		for (auto it = m_Mounts.rbegin(); it != m_Mounts.rend(); ++it)
+		{
+			if (it->Archive)
+			{
+				FileData data = FindInPack(it->Archive, normalized, hash);
+				if (data)
+				{
+					m_PackReads++;
+					return data;
+				}
+				continue;
+			}
+
+			FileData data = ReadLooseFile(it->Directory.empty() ? normalized : it->Directory + "/" + normalized);
+			if (data)
+			{
+				m_LooseReads++;
+				return data;
+			}
+		}
+
+		m_Misses++;
+		LOG_ERROR("Could not find file '{0}'", normalized);
+		return FileData();
+	}
+
+	bool VirtualFileSystem::Exists(std::string_view path) const
+	{
+		std::string normalized = NormalizePath(path);
+		uint64_t hash = HashPath(normalized);
+
+		for (auto it = m_Mounts.rbegin(); it != m_Mounts.rend(); ++it)
+		{
+			if (it->Archive ? FindInPack(it->Archive, normalized, hash).IsValid()
+				: std::filesystem::is_regular_file(it->Directory.empty() ? normalized : it->Directory + "/" + normalized))
+				return true;
+		}
+		return false;
+	}
+
+	FileSystemStats VirtualFileSystem::GetStats() const
+	{
+		return { m_PackReads.load(), m_LooseReads.load(), m_Misses.load() };
+	}
+
+	FileData VirtualFileSystem::ReadLooseFile(const std::string& path)
+	{
+		// One open and one read straight into the final buffer
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file)
+			return FileData();
+
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if (size < 0)
+		{
+			fclose(file);
+			return FileData();
+		}
+
+		auto buffer = std::make_shared<std::vector<uint8_t>>((size_t)size);
+		size_t read = fread(buffer->data(), 1, buffer->size(), file);
+		fclose(file);
+		if (read != buffer->size())
+			return FileData();
+
+		FileData result;
+		result.m_Data = buffer->data();
+		result.m_Size = buffer->size();
+		result.m_Owner = buffer;
+		result.m_Valid = true;
+		return result;
+	}
+
+	bool VirtualFileSystem::WritePack(const std::string& path, const std::string& directory, const std::string& virtualPrefix)
+	{
+		namespace fs = std::filesystem;
+
+		std::error_code error;
+		std::vector<std::pair<std::string, fs::path>> files;
+		for (const fs::directory_entry& item : fs::recursive_directory_iterator(directory, error))
+		{
+			if (!item.is_regular_file())
+				continue;
+
+			std::string name = fs::relative(item.path(), directory).generic_string();
+			if (!virtualPrefix.empty())
+				name = virtualPrefix + "/" + name;
+			files.emplace_back(NormalizePath(name), item.path());
+		}
+		if (error)
+		{
+			LOG_ERROR("Could not list '{0}': {1}", directory, error.message());
+			return false;
+		}
+
+		FILE* out = fopen(path.c_str(), "wb");
+		if (!out)
+		{
+			LOG_ERROR("Could not create pack '{0}'", path);
+			return false;
+		}
+
+		std::vector<PackEntry> entries;
+		std::string strings;
+		uint64_t offset = sizeof(PackHeader);
+		fseek(out, (long)offset, SEEK_SET);
+
+		bool ok = true;
+		for (const auto& [name, source] : files)
+		{
+			FileData data = ReadLooseFile(source.string());
+			if (!data)
+			{
+				LOG_ERROR("Could not read '{0}'", source.string());
+				ok = false;
+				break;
+			}
+
+			uint64_t aligned = (offset + PackAlignment - 1) & ~(PackAlignment - 1);
+			static const uint8_t padding[PackAlignment] = {};
+			ok = ok && fwrite(padding, 1, (size_t)(aligned - offset), out) == aligned - offset;
+			ok = ok && fwrite(data.GetData(), 1, data.GetSize(), out) == data.GetSize();
+
+			PackEntry& entry = entries.emplace_back();
+			entry.Hash = HashPath(name);
+			entry.Offset = aligned;
+			entry.Size = data.GetSize();
+			entry.NameOffset = (uint32_t)strings.size();
+			entry.NameLength = (uint32_t)name.size();
+			strings += name;
+
+			offset = aligned + data.GetSize();
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const PackEntry& a, const PackEntry& b) { return a.Hash < b.Hash; });
+
+		PackHeader header = {};
+		memcpy(header.Magic, PackMagic, sizeof(PackMagic));
+		header.Version = PackVersion;
+		header.EntryCount = (uint32_t)entries.size();
+		header.TocOffset = (offset + PackAlignment - 1) & ~(PackAlignment - 1);
+		header.StringsOffset = header.TocOffset + entries.size() * sizeof(PackEntry);
+		header.StringsSize = strings.size();
+
+		static const uint8_t padding[PackAlignment] = {};
+		ok = ok && fwrite(padding, 1, (size_t)(header.TocOffset - offset), out) == header.TocOffset - offset;
+		ok = ok && fwrite(entries.data(), sizeof(PackEntry), entries.size(), out) == entries.size();
+		ok = ok && fwrite(strings.data(), 1, strings.size(), out) == strings.size();
+		ok = ok && fseek(out, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, out) == 1;
+		ok = fclose(out) == 0 && ok;
+
+		if (ok)
+			LOG_INFO("Packed {0} files from '{1}' into '{2}'", entries.size(), directory, path);
+		else
+			LOG_ERROR("Could not write pack '{0}'", path);
+		return ok;
+	}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GLCore {
+
+	class MappedFile;
+
+	// Read-only bytes of a file. Data from a pack points straight into the
+	// mapped archive; the FileData keeps whatever backs it alive.
+	class FileData
+	{
+	public:
+		FileData() = default;
+
+		inline bool IsValid() const { return m_Valid; }
+		inline explicit operator bool() const { return m_Valid; }
+
+		inline const uint8_t* GetData() const { return m_Data; }
+		inline size_t GetSize() const { return m_Size; }
+		inline std::string_view GetText() const { return { reinterpret_cast<const char*>(m_Data), m_Size }; }
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+		std::shared_ptr<const void> m_Owner;
+		bool m_Valid = false;
+
+		friend class VirtualFileSystem;
+	};
+
+	struct FileSystemStats
+	{
+		uint32_t PackReads = 0;
+		uint32_t LooseReads = 0;
+		uint32_t Misses = 0;
+	};
+
+	// Resolves paths such as "assets/shaders/test.vert.glsl" against mounted
+	// directories and pack files, newest mount first. A pack is a single
+	// memory-mapped archive with a table of contents sorted by path hash,
+	// so a lookup is a binary search and a read never opens a file.
+	//
+	// Mount from one thread before reading; reads are thread safe.
+	class VirtualFileSystem
+	{
+	public:
+		VirtualFileSystem();
+		~VirtualFileSystem();
+
+		VirtualFileSystem(const VirtualFileSystem&) = delete;
+		VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+		// Virtual paths are resolved relative to the directory
+		void MountDirectory(const std::string& directory);
+		// Returns false if the file is missing or isn't a valid pack
+		bool MountPack(const std::string& path);
+
+		FileData Read(std::string_view path) const;
+		bool Exists(std::string_view path) const;
+
+		FileSystemStats GetStats() const;
+
+		// Reads a file from disk without going through any mount
+		static FileData ReadLooseFile(const std::string& path);
+
+		// Packs every file under directory; each is stored under
+		// virtualPrefix/<path relative to directory>
+		static bool WritePack(const std::string& path, const std::string& directory, const std::string& virtualPrefix);
+
+		static uint64_t HashPath(std::string_view path);
+	private:
+		struct Pack;
+		struct Mount
+		{
+			std::string Directory;
+			Ref<Pack> Archive;
+		};
+
+		static std::string NormalizePath(std::string_view path);
+		static FileData FindInPack(const Ref<Pack>& pack, std::string_view path, uint64_t hash);
+	private:
+		std::vector<Mount> m_Mounts;
+
+		mutable std::atomic<uint32_t> m_PackReads{ 0 }, m_LooseReads{ 0 }, m_Misses{ 0 };
+	};
+
+}
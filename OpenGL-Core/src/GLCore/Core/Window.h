@@ -21,6 +21,15 @@ namespace GLCore {
 		}
 	};
 
+	enum class VSyncMode
+	{
+		Off = 0,
+		On,
+		// Syncs when on time, tears instead of waiting a full interval when late.
+		// Falls back to On where the swap_control_tear extension is missing.
+		Adaptive
+	};
+
 	// Interface representing a desktop system based Window
 	class Window
 	{
@@ -29,7 +38,12 @@ namespace GLCore {
 
 		virtual ~Window() = default;
 
+		// Polls events and swaps buffers
 		virtual void OnUpdate() = 0;
+		virtual void PollEvents() = 0;
+		// Blocks until an event arrives or the timeout expires, then processes events
+		virtual void WaitEvents(double timeoutSeconds) = 0;
+		virtual void SwapBuffers() = 0;
 
 		virtual uint32_t GetWidth() const = 0;
 		virtual uint32_t GetHeight() const = 0;
@@ -38,6 +52,8 @@ namespace GLCore {
 		virtual void SetEventCallback(const EventCallbackFn& callback) = 0;
 		virtual void SetVSync(bool enabled) = 0;
 		virtual bool IsVSync() const = 0;
+		virtual void SetVSyncMode(VSyncMode mode) = 0;
+		virtual VSyncMode GetVSyncMode() const = 0;
 
 		virtual void* GetNativeWindow() const = 0;
 
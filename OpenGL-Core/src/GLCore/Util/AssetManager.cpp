@@ -0,0 +1,204 @@
+#include "glpch.h"
+#include "AssetManager.h"
+#include "ShaderPreprocessor.h"
+
+namespace GLCore::Utils {
+
+	AssetManager::AssetManager(VirtualFileSystem& fileSystem)
+		: m_FileSystem(fileSystem)
+	{
+	}
+
+	Ref<Shader> AssetManager::LoadShader(const std::string& vertexPath, const std::string& fragmentPath)
+	{
+		// Looked up before the sources are read; a miss is counted by LoadShaderVariants
+		std::string key = vertexPath + '\n' + fragmentPath;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (Ref<Shader> shader = m_Shaders[key].lock())
+			{
+				m_Stats.Requests++;
+				m_Stats.Hits++;
+				return shader;
+			}
+		}
+
+		Ref<ShaderVariants> variants = LoadShaderVariants(vertexPath, fragmentPath);
+		if (!variants)
+			return nullptr;
+		Ref<Shader> shader = variants->Get();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Shaders[key] = shader;
+		return shader;
+	}
+
+	Ref<ShaderVariants> AssetManager::LoadShaderVariants(const std::string& vertexPath, const std::string& fragmentPath,
+		std::vector<std::string> keywords)
+	{
+		std::string key = vertexPath + '\n' + fragmentPath;
+		for (const std::string& keyword : keywords)
+			key += '\n' + keyword;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Stats.Requests++;
+			m_VariantsLoaded.wait(lock, [this, &key] { return m_LoadingVariants.count(key) == 0; });
+			if (Ref<ShaderVariants> variants = m_Variants[key].lock())
+			{
+				m_Stats.Hits++;
+				return variants;
+			}
+			m_LoadingVariants.insert(key);
+		}
+
+		// Shader sources are only needed until the programs are compiled, so
+		// they aren't kept in the file cache
+		uint32_t fileReads = 0;
+		ShaderPreprocessor preprocessor([this, &fileReads](const std::string& path)
+		{
+			fileReads++;
+			return m_FileSystem.Read(path);
+		});
+
+		// The preprocessor logs what went wrong. Nothing is cached, so whoever
+		// was waiting for this load, and the next request, tries again.
+		std::string vertexSource, fragmentSource;
+		Ref<ShaderVariants> variants;
+		if (preprocessor.Process(vertexPath, {}, vertexSource) && preprocessor.Process(fragmentPath, {}, fragmentSource))
+			variants.reset(new ShaderVariants(*this, std::move(vertexSource), std::move(fragmentSource), std::move(keywords)));
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stats.FileReads += fileReads;
+			if (variants)
+				m_Variants[key] = variants;
+			m_LoadingVariants.erase(key);
+		}
+		m_VariantsLoaded.notify_all();
+		return variants;
+	}
+
+	Ref<Shader> AssetManager::LoadComputeShader(const std::string& path)
+	{
+		uint32_t fileReads = 0;
+		ShaderPreprocessor preprocessor([this, &fileReads](const std::string& file)
+		{
+			fileReads++;
+			return m_FileSystem.Read(file);
+		});
+
+		std::string source;
+		if (!preprocessor.Process(path, {}, source))
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stats.Requests++;
+			m_Stats.FileReads += fileReads;
+			return nullptr;
+		}
+
+		// Shares the program cache; a compute source never hashes like a vertex/fragment pair
+		ProgramKey key = { ShaderPreprocessor::Hash(source), 0 };
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stats.Requests++;
+			m_Stats.FileReads += fileReads;
+			if (Ref<Shader> shader = m_Programs[key].lock())
+			{
+				m_Stats.Hits++;
+				return shader;
+			}
+		}
+
+		Ref<Shader> shader = Shader::FromGLSLComputeSource(source);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stats.CompiledPrograms++;
+		m_Programs[key] = shader;
+		return shader;
+	}
+
+	Ref<Shader> AssetManager::GetProgram(const ShaderVariants& variants, uint32_t mask)
+	{
+		ProgramKey key = { variants.GetSourceHash(), mask };
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (Ref<Shader> shader = m_Programs[key].lock())
+			{
+				m_Stats.Hits++;
+				return shader;
+			}
+		}
+
+		std::vector<std::string> defines = variants.GetDefines(mask);
+		Ref<Shader> shader = Shader::FromGLSLSource(
+			ShaderPreprocessor::InjectDefines(variants.m_VertexSource, defines),
+			ShaderPreprocessor::InjectDefines(variants.m_FragmentSource, defines));
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stats.CompiledPrograms++;
+		m_Programs[key] = shader;
+		return shader;
+	}
+
+	FileData AssetManager::LoadFile(const std::string& path)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stats.Requests++;
+			auto it = m_Files.find(path);
+			if (it != m_Files.end())
+			{
+				m_Stats.Hits++;
+				return it->second;
+			}
+		}
+
+		// Read outside the lock; if two threads race, the first one stored wins
+		FileData data = m_FileSystem.Read(path);
+		if (!data)
+			return data;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stats.FileReads++;
+		return m_Files.try_emplace(path, data).first->second;
+	}
+
+	void AssetManager::ReleaseUnused()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Files.clear();
+		for (auto it = m_Variants.begin(); it != m_Variants.end();)
+		{
+			if (it->second.expired())
+				it = m_Variants.erase(it);
+			else
+				++it;
+		}
+		for (auto it = m_Shaders.begin(); it != m_Shaders.end();)
+		{
+			if (it->second.expired())
+				it = m_Shaders.erase(it);
+			else
+				++it;
+		}
+		for (auto it = m_Programs.begin(); it != m_Programs.end();)
+		{
+			if (it->second.expired())
+				it = m_Programs.erase(it);
+			else
+				++it;
+		}
+	}
+
+	AssetStats AssetManager::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		AssetStats stats = m_Stats;
+		stats.LoadedShaders = 0;
+		for (const auto& [key, shader] : m_Programs)
+			stats.LoadedShaders += shader.expired() ? 0 : 1;
+		stats.CachedFiles = (uint32_t)m_Files.size();
+		return stats;
+	}
+
+}
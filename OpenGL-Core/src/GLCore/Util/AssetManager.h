@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Shader.h"
+#include "ShaderVariants.h"
+#include "../Core/VirtualFileSystem.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	struct AssetStats
+	{
+		uint32_t Requests = 0;
+		// Requests answered by an asset that was already loaded
+		uint32_t Hits = 0;
+		uint32_t FileReads = 0;
+		uint32_t LoadedShaders = 0;
+		uint32_t CachedFiles = 0;
+		// Programs compiled since startup; a permutation compiled twice means
+		// every reference to it was dropped in between
+		uint32_t CompiledPrograms = 0;
+	};
+
+	// Loads assets through the virtual file system and hands out shared
+	// references. Asking twice for the same asset returns the same object
+	// for as long as anyone still holds it; the asset is released with the
+	// last reference.
+	//
+	// Shaders must be loaded on the thread that owns the GL context. Files
+	// may be loaded from any thread. Shader sources are only read and
+	// preprocessed by one caller at a time; others asking for the same pair
+	// wait for it and share the result.
+	class AssetManager
+	{
+	public:
+		AssetManager(VirtualFileSystem& fileSystem);
+
+		// Shader loads return null when a source can't be read or preprocessed
+		Ref<Shader> LoadShader(const std::string& vertexPath, const std::string& fragmentPath);
+		// Both stages are preprocessed (see ShaderPreprocessor); programs are
+		// compiled per keyword combination when first requested
+		Ref<ShaderVariants> LoadShaderVariants(const std::string& vertexPath, const std::string& fragmentPath,
+			std::vector<std::string> keywords = {});
+		Ref<Shader> LoadComputeShader(const std::string& path);
+
+		// Cached until ReleaseUnused; the data stays valid for as long as the
+		// returned FileData is held
+		FileData LoadFile(const std::string& path);
+
+		// Drops cached files and expired shader entries nobody references
+		void ReleaseUnused();
+
+		AssetStats GetStats() const;
+		inline VirtualFileSystem& GetFileSystem() { return m_FileSystem; }
+	private:
+		// Compiled programs are shared by every ShaderVariants with the same
+		// preprocessed source, keyed by (source hash, keyword mask)
+		Ref<Shader> GetProgram(const ShaderVariants& variants, uint32_t mask);
+
+		struct ProgramKey
+		{
+			uint64_t SourceHash;
+			uint32_t Mask;
+
+			bool operator==(const ProgramKey& other) const { return SourceHash == other.SourceHash && Mask == other.Mask; }
+		};
+
+		struct ProgramKeyHash
+		{
+			size_t operator()(const ProgramKey& key) const { return (size_t)(key.SourceHash ^ ((uint64_t)key.Mask * 0x9e3779b97f4a7c15ull)); }
+		};
+	private:
+		VirtualFileSystem& m_FileSystem;
+
+		mutable std::mutex m_Mutex;
+		std::unordered_map<std::string, std::weak_ptr<ShaderVariants>> m_Variants;
+		// LoadShader drops its ShaderVariants once it has the program, so the
+		// program is cached by source paths as well
+		std::unordered_map<std::string, std::weak_ptr<Shader>> m_Shaders;
+		// Variants keys whose sources are being read and preprocessed
+		std::unordered_set<std::string> m_LoadingVariants;
+		std::condition_variable m_VariantsLoaded;
+		std::unordered_map<ProgramKey, std::weak_ptr<Shader>, ProgramKeyHash> m_Programs;
+		std::unordered_map<std::string, FileData> m_Files;
+		AssetStats m_Stats;
+
+		friend class ShaderVariants;
+	};
+
+}
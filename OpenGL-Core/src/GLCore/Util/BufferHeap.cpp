@@ -0,0 +1,159 @@
+#include "glpch.h"
+#include "BufferHeap.h"
+
+namespace GLCore::Utils {
+
+	BufferHeap::BufferHeap(uint64_t pageSize)
+		: m_PageSize(pageSize)
+	{
+	}
+
+	BufferHeap::Page BufferHeap::CreatePage(uint64_t size)
+	{
+		Page page;
+		page.Buffer = CreateGLBuffer();
+		page.Ranges = RangeAllocator(size);
+		glNamedBufferStorage(page.Buffer, (GLsizeiptr)size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+		return page;
+	}
+
+	void BufferHeap::Place(std::vector<Page>& pages, Slot& slot)
+	{
+		for (uint32_t i = 0; i < (uint32_t)pages.size(); i++)
+		{
+			uint64_t offset = pages[i].Ranges.Allocate(slot.Size, slot.Alignment);
+			if (offset == RangeAllocator::InvalidOffset)
+				continue;
+
+			slot.Page = i;
+			slot.Offset = offset;
+			pages[i].AllocationCount++;
+			return;
+		}
+
+		// Room for the alignment padding too, in case the range doesn't start at 0
+		Page& page = pages.emplace_back(CreatePage(std::max(m_PageSize, slot.Size + slot.Alignment)));
+		slot.Page = (uint32_t)pages.size() - 1;
+		slot.Offset = page.Ranges.Allocate(slot.Size, slot.Alignment);
+		page.AllocationCount++;
+		m_Revision++;
+	}
+
+	BufferHeap::Allocation BufferHeap::Allocate(uint64_t size, uint64_t alignment)
+	{
+		if (size == 0)
+			return InvalidAllocation;
+
+		uint32_t index;
+		if (!m_FreeSlots.empty())
+		{
+			index = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			index = (uint32_t)m_Slots.size();
+			m_Slots.emplace_back();
+		}
+
+		Slot& slot = m_Slots[index];
+		slot.Size = size;
+		slot.Alignment = std::max<uint64_t>(alignment, 1);
+		slot.Live = true;
+		Place(m_Pages, slot);
+		return index + 1;
+	}
+
+	void BufferHeap::Free(Allocation allocation)
+	{
+		if (allocation == InvalidAllocation)
+			return;
+
+		Slot& slot = m_Slots[allocation - 1];
+		GLCORE_ASSERT(slot.Live, "Allocation was already freed");
+
+		// Empty pages are kept until the next Defragment, so a free followed
+		// by an allocation doesn't recreate the buffer
+		Page& page = m_Pages[slot.Page];
+		page.Ranges.Free(slot.Offset, slot.Size);
+		page.AllocationCount--;
+
+		slot.Live = false;
+		m_FreeSlots.push_back(allocation - 1);
+	}
+
+	void BufferHeap::Upload(Allocation allocation, const void* data, uint64_t size, uint64_t offset)
+	{
+		const Slot& slot = m_Slots[allocation - 1];
+		GLCORE_ASSERT(offset + size <= slot.Size, "Upload is larger than the allocation");
+		glNamedBufferSubData(m_Pages[slot.Page].Buffer, (GLintptr)(slot.Offset + offset), (GLsizeiptr)size, data);
+	}
+
+	BufferRange BufferHeap::GetRange(Allocation allocation) const
+	{
+		const Slot& slot = m_Slots[allocation - 1];
+		return { m_Pages[slot.Page].Buffer, slot.Page, slot.Offset, slot.Size };
+	}
+
+	uint64_t BufferHeap::Defragment()
+	{
+		BufferHeapStats stats = GetStats();
+		bool emptyPages = std::any_of(m_Pages.begin(), m_Pages.end(), [](const Page& page) { return page.AllocationCount == 0; });
+		if (stats.Fragmentation == 0.0f && !emptyPages)
+			return 0;
+
+		// Largest first packs tightest with first-fit
+		std::vector<uint32_t> order;
+		order.reserve(m_Slots.size());
+		for (uint32_t i = 0; i < (uint32_t)m_Slots.size(); i++)
+		{
+			if (m_Slots[i].Live)
+				order.push_back(i);
+		}
+		std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return m_Slots[a].Size > m_Slots[b].Size; });
+
+		std::vector<Page> pages;
+		uint64_t moved = 0;
+		for (uint32_t index : order)
+		{
+			Slot& slot = m_Slots[index];
+			Slot previous = slot;
+			Place(pages, slot);
+
+			glCopyNamedBufferSubData(m_Pages[previous.Page].Buffer, pages[slot.Page].Buffer,
+				(GLintptr)previous.Offset, (GLintptr)slot.Offset, (GLsizeiptr)slot.Size);
+			moved += slot.Size;
+		}
+
+		// The copies are queued on the GPU before the old pages are deleted
+		m_Pages = std::move(pages);
+		m_Revision++;
+		m_LastDefragmentMovedBytes = moved;
+		return moved;
+	}
+
+	BufferHeapStats BufferHeap::GetStats() const
+	{
+		BufferHeapStats stats;
+		stats.Pages = (uint32_t)m_Pages.size();
+		stats.LastDefragmentMovedBytes = m_LastDefragmentMovedBytes;
+
+		uint64_t free = 0, largestPerPage = 0;
+		for (const Page& page : m_Pages)
+		{
+			stats.Allocations += page.AllocationCount;
+			stats.Capacity += page.Ranges.GetCapacity();
+			stats.Used += page.Ranges.GetUsed();
+			stats.FreeRanges += (uint32_t)page.Ranges.GetFreeRangeCount();
+			stats.LargestFreeRange = std::max(stats.LargestFreeRange, page.Ranges.GetLargestFreeRange());
+
+			free += page.Ranges.GetCapacity() - page.Ranges.GetUsed();
+			largestPerPage += page.Ranges.GetLargestFreeRange();
+		}
+
+		// Free space no single range in its page can use
+		stats.Fragmentation = free > 0 ? 1.0f - (float)((double)largestPerPage / (double)free) : 0.0f;
+		return stats;
+	}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "GLResource.h"
+#include "../Core/Memory.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	struct BufferRange
+	{
+		GLuint Buffer = 0;
+		uint32_t Page = 0;
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+	};
+
+	struct BufferHeapStats
+	{
+		uint32_t Pages = 0;
+		uint32_t Allocations = 0;
+		uint64_t Capacity = 0;
+		uint64_t Used = 0;
+		uint32_t FreeRanges = 0;
+		uint64_t LargestFreeRange = 0;
+		// 0 when all free space in each page is one range, towards 1 as it splinters
+		float Fragmentation = 0.0f;
+		uint64_t LastDefragmentMovedBytes = 0;
+	};
+
+	// Sub-allocates ranges of a few large immutable GL buffers ("pages"), so
+	// many small meshes share one binding instead of owning a buffer each.
+	// Allocations are referred to by id because Defragment moves them: it
+	// repacks every live range into as few fresh pages as possible with
+	// GPU-side copies, and the old pages go through the deletion queue.
+	class BufferHeap
+	{
+	public:
+		using Allocation = uint32_t;
+		static constexpr Allocation InvalidAllocation = 0;
+
+		BufferHeap(uint64_t pageSize = 4 * 1024 * 1024);
+
+		BufferHeap(const BufferHeap&) = delete;
+		BufferHeap& operator=(const BufferHeap&) = delete;
+
+		// Requests larger than the page size get a page of their own
+		Allocation Allocate(uint64_t size, uint64_t alignment = 4);
+		void Free(Allocation allocation);
+
+		void Upload(Allocation allocation, const void* data, uint64_t size, uint64_t offset = 0);
+
+		// Only valid until the revision changes
+		BufferRange GetRange(Allocation allocation) const;
+
+		inline size_t GetPageCount() const { return m_Pages.size(); }
+		inline GLuint GetPageBuffer(uint32_t page) const { return m_Pages[page].Buffer; }
+		// Changes whenever pages are added, replaced or dropped, so anything
+		// that binds page buffers (vertex arrays) must be rebuilt
+		inline uint32_t GetRevision() const { return m_Revision; }
+
+		// Returns the number of bytes copied
+		uint64_t Defragment();
+
+		BufferHeapStats GetStats() const;
+	private:
+		struct Page
+		{
+			GLBuffer Buffer;
+			RangeAllocator Ranges;
+			uint32_t AllocationCount = 0;
+		};
+
+		struct Slot
+		{
+			uint32_t Page = 0;
+			uint64_t Offset = 0, Size = 0, Alignment = 0;
+			bool Live = false;
+		};
+
+		static Page CreatePage(uint64_t size);
+		// Places the slot's range in the first page with room, adding a page if none has any
+		void Place(std::vector<Page>& pages, Slot& slot);
+	private:
+		uint64_t m_PageSize;
+		std::vector<Page> m_Pages;
+		std::vector<Slot> m_Slots;
+		std::vector<uint32_t> m_FreeSlots;
+		uint32_t m_Revision = 0;
+		uint64_t m_LastDefragmentMovedBytes = 0;
+	};
+
+}
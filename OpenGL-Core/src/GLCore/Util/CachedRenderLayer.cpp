@@ -0,0 +1,66 @@
+#include "glpch.h"
+#include "CachedRenderLayer.h"
+
+namespace GLCore::Utils {
+
+	static FramebufferSpecification CacheSpecification()
+	{
+		FramebufferSpecification spec;
+		spec.DepthAttachment = true;
+		spec.Filter = GL_NEAREST;
+		return spec;
+	}
+
+	CachedRenderLayer::CachedRenderLayer()
+		: m_Framebuffer(CacheSpecification()), m_ViewProjection(1.0f)
+	{
+		// The composite quad is generated from gl_VertexID, but core profile
+		// still requires a vertex array to be bound
+		m_QuadVA = CreateGLVertexArray();
+	}
+
+	bool CachedRenderLayer::BeginUpdate(uint32_t width, uint32_t height, const glm::mat4& viewProjection)
+	{
+		const FramebufferSpecification& spec = m_Framebuffer.GetSpecification();
+		if (width != spec.Width || height != spec.Height || viewProjection != m_ViewProjection)
+			m_Valid = false;
+
+		if (m_Valid)
+			return false;
+
+		m_Framebuffer.Resize(width, height);
+		m_ViewProjection = viewProjection;
+
+		glGetIntegerv(GL_VIEWPORT, m_SavedViewport);
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_SavedFramebuffer);
+		m_Framebuffer.Bind();
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		return true;
+	}
+
+	void CachedRenderLayer::EndUpdate()
+	{
+		// Back to whatever target the caller was drawing into
+		glBindFramebuffer(GL_FRAMEBUFFER, m_SavedFramebuffer);
+		glViewport(m_SavedViewport[0], m_SavedViewport[1], m_SavedViewport[2], m_SavedViewport[3]);
+
+		m_Valid = true;
+		m_RedrawCount++;
+	}
+
+	void CachedRenderLayer::Composite(Shader& shader)
+	{
+		GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+		glDisable(GL_DEPTH_TEST);
+
+		glUseProgram(shader.GetRendererID());
+		glBindTextureUnit(0, m_Framebuffer.GetColorAttachmentRendererID());
+		glBindVertexArray(m_QuadVA);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+		if (depthTest)
+			glEnable(GL_DEPTH_TEST);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Framebuffer.h"
+#include "Shader.h"
+
+#include <glm/glm.hpp>
+
+namespace GLCore::Utils {
+
+	// Content that rarely changes, rendered once into a texture and then
+	// composited each frame with a single full-screen quad. The cache is
+	// redrawn only when invalidated or when the camera or viewport changes.
+	class CachedRenderLayer
+	{
+	public:
+		CachedRenderLayer();
+
+		// Marks the cached contents as stale
+		inline void Invalidate() { m_Valid = false; }
+		inline bool IsValid() const { return m_Valid; }
+
+		// Returns true when the cache must be redrawn. In that case the cache's
+		// framebuffer is bound and cleared to transparent, and the caller draws
+		// the layer's contents before calling EndUpdate.
+		bool BeginUpdate(uint32_t width, uint32_t height, const glm::mat4& viewProjection);
+		void EndUpdate();
+
+		// Draws the cached texture over the whole viewport with the current
+		// blend state. The shader samples texture unit 0.
+		void Composite(Shader& shader);
+
+		inline GLuint GetTextureRendererID() const { return m_Framebuffer.GetColorAttachmentRendererID(); }
+		inline uint32_t GetRedrawCount() const { return m_RedrawCount; }
+	private:
+		Framebuffer m_Framebuffer;
+		GLVertexArray m_QuadVA;
+
+		glm::mat4 m_ViewProjection;
+		bool m_Valid = false;
+		uint32_t m_RedrawCount = 0;
+		GLint m_SavedViewport[4] = {};
+		GLint m_SavedFramebuffer = 0;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "glpch.h"
+#include "DrawQueue.h"
+
+#include <algorithm>
+
+namespace GLCore::Utils {
+
+	uint64_t DrawKey::Make(uint8_t layer, bool translucent, float depth, GLuint shader, GLuint texture)
+	{
+		const uint32_t maxDepth = (1u << DepthBits) - 1;
+		uint32_t quantized = (uint32_t)(std::clamp(depth, 0.0f, 1.0f) * maxDepth);
+		if (translucent)
+			quantized = maxDepth - quantized;
+
+		return ((uint64_t)layer << 56)
+			| ((uint64_t)(translucent ? 1 : 0) << 55)
+			| ((uint64_t)quantized << (ShaderBits + TextureBits))
+			| ((uint64_t)(shader & ((1u << ShaderBits) - 1)) << TextureBits)
+			| (uint64_t)(texture & ((1u << TextureBits) - 1));
+	}
+
+	void DrawQueue::Submit(const DrawItem& item)
+	{
+		if (item.IndexCount > 0 && item.InstanceCount > 0)
+			m_Items.push_back(item);
+	}
+
+	void DrawQueue::Clear()
+	{
+		m_Items.clear();
+	}
+
+	void DrawQueue::Sort()
+	{
+		// LSD radix sort, one byte per pass. Stable, so items with equal keys
+		// keep their submission order.
+		size_t count = m_Items.size();
+		if (count < 2)
+			return;
+
+		m_Scratch.resize(count);
+		DrawItem* source = m_Items.data();
+		DrawItem* destination = m_Scratch.data();
+
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			size_t offsets[256] = {};
+			for (size_t i = 0; i < count; i++)
+				offsets[(source[i].Key >> shift) & 0xFF]++;
+
+			// Every key shares this byte, so the pass would not reorder anything
+			if (offsets[(source[0].Key >> shift) & 0xFF] == count)
+				continue;
+
+			size_t total = 0;
+			for (size_t& offset : offsets)
+			{
+				size_t bucketSize = offset;
+				offset = total;
+				total += bucketSize;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				destination[offsets[(source[i].Key >> shift) & 0xFF]++] = source[i];
+
+			std::swap(source, destination);
+		}
+
+		if (source != m_Items.data())
+			std::copy(source, source + count, m_Items.data());
+	}
+
+	void DrawQueue::Flush()
+	{
+		Sort();
+
+		m_Stats = DrawQueueStats();
+		m_Stats.Items = (uint32_t)m_Items.size();
+
+		GLboolean depthMask;
+		glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+
+		bool translucent = false;
+		GLuint vertexArray = 0, shader = 0, texture = 0;
+		uint32_t runFirst = 0, runCount = 0, runInstances = 1;
+		int32_t runBaseVertex = 0;
+
+		auto drawRun = [&]()
+		{
+			if (runCount == 0)
+				return;
+			const void* offset = (const void*)(runFirst * sizeof(uint32_t));
+			if (runInstances == 1)
+				glDrawElementsBaseVertex(GL_TRIANGLES, runCount, GL_UNSIGNED_INT, offset, runBaseVertex);
+			else
+				glDrawElementsInstancedBaseVertex(GL_TRIANGLES, runCount, GL_UNSIGNED_INT, offset, runInstances, runBaseVertex);
+			m_Stats.DrawCalls++;
+			runCount = 0;
+		};
+
+		glDepthMask(GL_TRUE);
+		for (const DrawItem& item : m_Items)
+		{
+			bool itemTranslucent = DrawKey::IsTranslucent(item.Key);
+
+			bool stateChanged = itemTranslucent != translucent || item.VertexArray != vertexArray
+				|| item.Shader != shader || item.Texture != texture;
+			bool mergeable = !stateChanged && item.InstanceCount == 1 && runInstances == 1
+				&& item.FirstIndex == runFirst + runCount && item.BaseVertex == runBaseVertex;
+			if (!mergeable)
+				drawRun();
+
+			if (itemTranslucent != translucent)
+			{
+				glDepthMask(itemTranslucent ? GL_FALSE : GL_TRUE);
+				translucent = itemTranslucent;
+			}
+			if (item.VertexArray != vertexArray)
+			{
+				glBindVertexArray(item.VertexArray);
+				vertexArray = item.VertexArray;
+			}
+			if (item.Shader != shader)
+			{
+				glUseProgram(item.Shader);
+				shader = item.Shader;
+			}
+			if (item.Texture != texture)
+			{
+				glBindTextureUnit(0, item.Texture);
+				texture = item.Texture;
+			}
+			if (stateChanged)
+				m_Stats.StateChanges++;
+
+			if (runCount == 0)
+			{
+				runFirst = item.FirstIndex;
+				runInstances = item.InstanceCount;
+				runBaseVertex = item.BaseVertex;
+			}
+			runCount += item.IndexCount;
+		}
+		drawRun();
+
+		glDepthMask(depthMask);
+		m_Items.clear();
+	}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	// Draws are ordered by a single 64-bit key, most significant field first:
+	//
+	//   63..56  layer         explicit ordering between groups of draws
+	//   55      translucency  opaque draws first, then translucent ones
+	//   54..31  depth         front-to-back when opaque, back-to-front when translucent
+	//   30..15  shader        low bits of the program name
+	//   14..0   texture       low bits of the texture name
+	//
+	// Depth is normalized to [0, 1] with 0 nearest the viewer.
+	struct DrawKey
+	{
+		static constexpr uint32_t DepthBits = 24;
+		static constexpr uint32_t ShaderBits = 16;
+		static constexpr uint32_t TextureBits = 15;
+
+		static uint64_t Make(uint8_t layer, bool translucent, float depth, GLuint shader, GLuint texture = 0);
+
+		static inline uint8_t GetLayer(uint64_t key) { return (uint8_t)(key >> 56); }
+		static inline bool IsTranslucent(uint64_t key) { return (key >> 55) & 1; }
+	};
+
+	struct DrawItem
+	{
+		uint64_t Key = 0;
+		GLuint VertexArray = 0;
+		GLuint Shader = 0;
+		GLuint Texture = 0;
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+		uint32_t InstanceCount = 1;
+		// Added to every index, for meshes packed into a shared buffer
+		int32_t BaseVertex = 0;
+	};
+
+	struct DrawQueueStats
+	{
+		uint32_t Items = 0;
+		uint32_t DrawCalls = 0;
+		uint32_t StateChanges = 0;
+	};
+
+	// Collects indexed, optionally instanced draws, radix sorts them by key and
+	// submits them. Opaque draws are rendered with depth
+	// writes so hidden fragments are rejected early; translucent draws test
+	// against depth but do not write it. Consecutive non-instanced draws with
+	// the same state and adjacent index ranges are merged into one call.
+	class DrawQueue
+	{
+	public:
+		void Submit(const DrawItem& item);
+
+		// Sorts and draws everything submitted, then clears the queue
+		void Flush();
+		void Clear();
+
+		// Orders items by ascending key. Exposed for callers that submit the
+		// sorted items themselves.
+		void Sort();
+
+		inline const std::vector<DrawItem>& GetItems() const { return m_Items; }
+		inline const DrawQueueStats& GetLastFlushStats() const { return m_Stats; }
+	private:
+		std::vector<DrawItem> m_Items;
+		std::vector<DrawItem> m_Scratch;
+		DrawQueueStats m_Stats;
+	};
+
+}
@@ -0,0 +1,113 @@
+#include "glpch.h"
+#include "DynamicResolution.h"
+
+#include <cmath>
+
+namespace GLCore::Utils {
+
+	// Scales are kept on a 5% grid so that small timing changes don't
+	// reallocate the scene targets every frame
+	static float QuantizeScale(float scale)
+	{
+		return std::floor(scale * 20.0f + 0.5f) / 20.0f;
+	}
+
+	DynamicResolution::DynamicResolution(const DynamicResolutionSettings& settings)
+		: m_Settings(settings), m_Scale(settings.MaxScale)
+	{
+		glCreateQueries(GL_TIME_ELAPSED, (GLsizei)QueryCount, m_Queries.data());
+	}
+
+	DynamicResolution::~DynamicResolution()
+	{
+		glDeleteQueries((GLsizei)QueryCount, m_Queries.data());
+	}
+
+	void DynamicResolution::BeginTiming()
+	{
+		// Collect every finished query; the oldest ones come back first
+		for (size_t i = 1; i <= QueryCount; i++)
+		{
+			size_t index = (m_QueryIndex + i) % QueryCount;
+			if (!m_Pending[index])
+				continue;
+
+			GLint available = 0;
+			glGetQueryObjectiv(m_Queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+				continue;
+
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(m_Queries[index], GL_QUERY_RESULT, &elapsed);
+			m_Pending[index] = false;
+			Update((float)(elapsed * 1e-6));
+		}
+
+		// Every query still in flight: skip timing this frame rather than wait
+		m_QueryIndex = (m_QueryIndex + 1) % QueryCount;
+		if (m_Pending[m_QueryIndex])
+			return;
+
+		glBeginQuery(GL_TIME_ELAPSED, m_Queries[m_QueryIndex]);
+		m_Timing = true;
+	}
+
+	void DynamicResolution::EndTiming()
+	{
+		if (!m_Timing)
+			return;
+
+		glEndQuery(GL_TIME_ELAPSED);
+		m_Pending[m_QueryIndex] = true;
+		m_Timing = false;
+	}
+
+	void DynamicResolution::GetScaledSize(uint32_t width, uint32_t height, uint32_t& scaledWidth, uint32_t& scaledHeight) const
+	{
+		float scale = GetScale();
+		scaledWidth = std::max(1u, (uint32_t)(width * scale + 0.5f));
+		scaledHeight = std::max(1u, (uint32_t)(height * scale + 0.5f));
+	}
+
+	void DynamicResolution::Update(float milliseconds)
+	{
+		const float smoothing = 0.1f;
+		if (m_SmoothedMilliseconds == 0.0f)
+			m_SmoothedMilliseconds = milliseconds;
+		else
+			m_SmoothedMilliseconds += (milliseconds - m_SmoothedMilliseconds) * smoothing;
+
+		if (!m_Enabled)
+			return;
+		if (m_Cooldown > 0)
+		{
+			m_Cooldown--;
+			return;
+		}
+
+		float target = m_Settings.TargetMilliseconds;
+		float scale = m_Scale;
+		if (m_SmoothedMilliseconds > target)
+		{
+			// GPU time is roughly proportional to pixel count, which goes with
+			// the square of the scale; aim a little under the budget
+			scale = QuantizeScale(m_Scale * std::sqrt(target / m_SmoothedMilliseconds) * 0.95f);
+			if (scale >= m_Scale)
+				scale = m_Scale - 0.05f;
+		}
+		else if (m_SmoothedMilliseconds < target * m_Settings.IncreaseThreshold)
+		{
+			// Grow slowly; overshooting would cost a visible hitch
+			scale = QuantizeScale(m_Scale + m_Settings.IncreaseStep);
+		}
+
+		scale = std::clamp(scale, m_Settings.MinScale, m_Settings.MaxScale);
+		if (scale == m_Scale)
+			return;
+
+		m_Scale = scale;
+		m_Cooldown = m_Settings.CooldownFrames;
+		m_ScaleChangeCount++;
+	}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+
+namespace GLCore::Utils {
+
+	struct DynamicResolutionSettings
+	{
+		float TargetMilliseconds = 14.0f;   // GPU budget for the timed work
+		float MinScale = 0.5f;
+		float MaxScale = 1.0f;
+		// Only scale back up once well under budget, so the scale doesn't
+		// oscillate around the target
+		float IncreaseThreshold = 0.8f;
+		float IncreaseStep = 0.05f;
+		// Frames to wait after a change before the next one, which lets the
+		// smoothed timing catch up with the new resolution
+		uint32_t CooldownFrames = 15;
+	};
+
+	// Picks a render scale from measured GPU time. The timed work is bracketed
+	// with BeginTiming/EndTiming; results are read back a few frames later
+	// without stalling, and the scale follows the smoothed time with hysteresis.
+	class DynamicResolution
+	{
+	public:
+		DynamicResolution(const DynamicResolutionSettings& settings = DynamicResolutionSettings());
+		~DynamicResolution();
+
+		DynamicResolution(const DynamicResolution&) = delete;
+		DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+		void BeginTiming();
+		void EndTiming();
+
+		inline void SetEnabled(bool enabled) { m_Enabled = enabled; }
+		inline bool IsEnabled() const { return m_Enabled; }
+
+		inline DynamicResolutionSettings& GetSettings() { return m_Settings; }
+
+		// Always MaxScale while disabled
+		inline float GetScale() const { return m_Enabled ? m_Scale : m_Settings.MaxScale; }
+		// Size to render at for a given native size, never smaller than one pixel
+		void GetScaledSize(uint32_t width, uint32_t height, uint32_t& scaledWidth, uint32_t& scaledHeight) const;
+
+		inline float GetGpuMilliseconds() const { return m_SmoothedMilliseconds; }
+		inline uint32_t GetScaleChangeCount() const { return m_ScaleChangeCount; }
+	private:
+		void Update(float milliseconds);
+	private:
+		static constexpr size_t QueryCount = 4;
+
+		DynamicResolutionSettings m_Settings;
+		std::array<GLuint, QueryCount> m_Queries{};
+		std::array<bool, QueryCount> m_Pending{};
+		size_t m_QueryIndex = 0;
+		bool m_Timing = false;
+
+		// Off by default: a scaled scene can't use damage-rect partial redraws
+		bool m_Enabled = false;
+		float m_Scale = 1.0f;
+		float m_SmoothedMilliseconds = 0.0f;
+		uint32_t m_Cooldown = 0;
+		uint32_t m_ScaleChangeCount = 0;
+	};
+
+}
@@ -0,0 +1,474 @@
+#include "glpch.h"
+#include "FrameCapture.h"
+#include "ImageWriter.h"
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+
+namespace GLCore::Utils {
+
+	namespace {
+
+		// Pixels as read back: RGBA8, rows bottom to top
+		struct CapturedFrame
+		{
+			std::vector<uint8_t> Pixels;
+			uint32_t Width = 0, Height = 0;
+			std::string PNGPath;          // Frame of a PNG sequence
+			std::string ScreenshotPath;
+		};
+
+		void CreateParentDirectories(const std::string& path)
+		{
+			std::filesystem::path parent = std::filesystem::path(path).parent_path();
+			if (!parent.empty())
+			{
+				std::error_code error;
+				std::filesystem::create_directories(parent, error);
+			}
+		}
+
+		bool WriteFramePNG(const std::string& path, const CapturedFrame& frame, std::vector<uint8_t>& scratch)
+		{
+			// Drop alpha, which the window doesn't show, and flip to top-down rows
+			scratch.resize((size_t)frame.Width * frame.Height * 3);
+			for (uint32_t y = 0; y < frame.Height; y++)
+			{
+				const uint8_t* source = frame.Pixels.data() + (size_t)(frame.Height - 1 - y) * frame.Width * 4;
+				uint8_t* destination = scratch.data() + (size_t)y * frame.Width * 3;
+				for (uint32_t x = 0; x < frame.Width; x++)
+				{
+					destination[x * 3 + 0] = source[x * 4 + 0];
+					destination[x * 3 + 1] = source[x * 4 + 1];
+					destination[x * 3 + 2] = source[x * 4 + 2];
+				}
+			}
+
+			CreateParentDirectories(path);
+			return WritePNG(path, frame.Width, frame.Height, 3, scratch.data());
+		}
+
+		// Full-range BT.601, as implied by the C420jpeg colorspace tag
+		void ConvertToI420(const CapturedFrame& frame, std::vector<uint8_t>& out)
+		{
+			uint32_t width = frame.Width, height = frame.Height;
+			uint32_t chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+			out.resize((size_t)width * height + (size_t)chromaWidth * chromaHeight * 2);
+			uint8_t* planeY = out.data();
+			uint8_t* planeU = planeY + (size_t)width * height;
+			uint8_t* planeV = planeU + (size_t)chromaWidth * chromaHeight;
+
+			auto pixel = [&](uint32_t x, uint32_t y)
+			{
+				return frame.Pixels.data() + ((size_t)(height - 1 - y) * width + x) * 4;
+			};
+
+			for (uint32_t y = 0; y < height; y++)
+			{
+				for (uint32_t x = 0; x < width; x++)
+				{
+					const uint8_t* p = pixel(x, y);
+					planeY[(size_t)y * width + x] = (uint8_t)(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2] + 0.5f);
+				}
+			}
+
+			for (uint32_t cy = 0; cy < chromaHeight; cy++)
+			{
+				for (uint32_t cx = 0; cx < chromaWidth; cx++)
+				{
+					// Average the 2x2 block, clamped at odd edges
+					float r = 0.0f, g = 0.0f, b = 0.0f;
+					for (uint32_t dy = 0; dy < 2; dy++)
+					{
+						for (uint32_t dx = 0; dx < 2; dx++)
+						{
+							const uint8_t* p = pixel(std::min(cx * 2 + dx, width - 1), std::min(cy * 2 + dy, height - 1));
+							r += p[0]; g += p[1]; b += p[2];
+						}
+					}
+					r *= 0.25f; g *= 0.25f; b *= 0.25f;
+
+					size_t index = (size_t)cy * chromaWidth + cx;
+					planeU[index] = (uint8_t)std::clamp(-0.168736f * r - 0.331264f * g + 0.5f * b + 128.5f, 0.0f, 255.0f);
+					planeV[index] = (uint8_t)std::clamp(0.5f * r - 0.418688f * g - 0.081312f * b + 128.5f, 0.0f, 255.0f);
+				}
+			}
+		}
+
+	}
+
+	struct FrameCapture::SharedState
+	{
+		std::mutex Mutex;
+		std::condition_variable Idle;
+		uint32_t InFlight = 0;
+		// Pixel buffers are recycled so steady recording doesn't allocate
+		std::vector<std::vector<uint8_t>> FreeBuffers;
+
+		std::atomic<uint32_t> Written{ 0 }, Failed{ 0 }, Dropped{ 0 };
+
+		std::vector<uint8_t> AcquireBuffer(size_t size)
+		{
+			std::vector<uint8_t> buffer;
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				if (!FreeBuffers.empty())
+				{
+					buffer = std::move(FreeBuffers.back());
+					FreeBuffers.pop_back();
+				}
+			}
+			buffer.resize(size);
+			return buffer;
+		}
+
+		void FinishFrame(std::vector<uint8_t>&& pixels)
+		{
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				FreeBuffers.push_back(std::move(pixels));
+				InFlight--;
+			}
+			Idle.notify_all();
+		}
+	};
+
+	// A single output file. Frames are queued in capture order and written
+	// by one job at a time, so workers never reorder them.
+	struct FrameCapture::Stream
+	{
+		CaptureFormat Format;
+		std::string Path;
+		uint32_t FrameRate;
+		std::shared_ptr<SharedState> State;
+
+		FILE* File = nullptr;
+		bool OpenFailed = false;
+		uint32_t Width = 0, Height = 0;
+		std::vector<uint8_t> Scratch;
+
+		std::mutex Mutex;
+		std::deque<CapturedFrame> Queue;
+		bool Draining = false;
+
+		~Stream()
+		{
+			if (File)
+				fclose(File);
+		}
+
+		// Returns true when the caller has to start a drain job
+		bool Push(CapturedFrame&& frame)
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Queue.push_back(std::move(frame));
+			if (Draining)
+				return false;
+			Draining = true;
+			return true;
+		}
+
+		void Drain()
+		{
+			while (true)
+			{
+				CapturedFrame frame;
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					if (Queue.empty())
+					{
+						Draining = false;
+						return;
+					}
+					frame = std::move(Queue.front());
+					Queue.pop_front();
+				}
+
+				if (!frame.ScreenshotPath.empty())
+					(WriteFramePNG(frame.ScreenshotPath, frame, Scratch) ? State->Written : State->Failed)++;
+				Write(frame);
+				State->FinishFrame(std::move(frame.Pixels));
+			}
+		}
+
+		void Write(const CapturedFrame& frame)
+		{
+			if (!File && !OpenFailed)
+			{
+				CreateParentDirectories(Path);
+				File = fopen(Path.c_str(), "wb");
+				OpenFailed = !File;
+				if (OpenFailed)
+					LOG_ERROR("Could not open capture file {0}", Path);
+
+				// Streams can't change resolution midway, so the first frame decides
+				Width = frame.Width;
+				Height = frame.Height;
+				if (File && Format == CaptureFormat::Y4M)
+					fprintf(File, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", Width, Height, FrameRate);
+				else if (File)
+					LOG_INFO("Capturing {0}x{1} RGBA8 frames to {2}", Width, Height, Path);
+			}
+
+			if (!File)
+			{
+				State->Failed++;
+				return;
+			}
+			if (frame.Width != Width || frame.Height != Height)
+			{
+				State->Dropped++;
+				return;
+			}
+
+			bool ok = true;
+			if (Format == CaptureFormat::Y4M)
+			{
+				ConvertToI420(frame, Scratch);
+				ok = fputs("FRAME\n", File) >= 0 && fwrite(Scratch.data(), 1, Scratch.size(), File) == Scratch.size();
+			}
+			else
+			{
+				size_t rowSize = (size_t)frame.Width * 4;
+				for (uint32_t y = frame.Height; y-- > 0 && ok; )
+					ok = fwrite(frame.Pixels.data() + y * rowSize, 1, rowSize, File) == rowSize;
+			}
+			(ok ? State->Written : State->Failed)++;
+		}
+	};
+
+	FrameCapture::FrameCapture(JobSystem& jobs)
+		: m_Jobs(jobs), m_State(std::make_shared<SharedState>())
+	{
+		for (Readback& readback : m_Readbacks)
+			glCreateBuffers(1, &readback.Buffer);
+	}
+
+	FrameCapture::~FrameCapture()
+	{
+		StopRecording();
+
+		for (Readback& readback : m_Readbacks)
+		{
+			if (readback.Fence)
+				glDeleteSync(readback.Fence);
+			glDeleteBuffers(1, &readback.Buffer);
+		}
+
+		// Workers hold on to the shared state, but this is the last chance to
+		// report frames that were still being written
+		std::unique_lock<std::mutex> lock(m_State->Mutex);
+		m_State->Idle.wait(lock, [this] { return m_State->InFlight == 0; });
+	}
+
+	void FrameCapture::StartRecording(const CaptureSettings& settings)
+	{
+		StopRecording();
+
+		m_Settings = settings;
+		m_Recording = true;
+		m_FrameIndex = 0;
+
+		if (settings.Format != CaptureFormat::PNG)
+		{
+			m_Stream = std::make_shared<Stream>();
+			m_Stream->Format = settings.Format;
+			m_Stream->Path = settings.OutputPath + (settings.Format == CaptureFormat::Y4M ? ".y4m" : ".rgba");
+			m_Stream->FrameRate = settings.FrameRate;
+			m_Stream->State = m_State;
+		}
+	}
+
+	void FrameCapture::StopRecording()
+	{
+		// Encoded with the current settings, before StartRecording replaces them.
+		// The stream stays open until the workers have written them.
+		FlushReadbacks();
+		m_Recording = false;
+		m_Stream.reset();
+	}
+
+	void FrameCapture::RequestScreenshot(const std::string& path)
+	{
+		m_ScreenshotPath = path + ".png";
+	}
+
+	void FrameCapture::Capture(GLuint framebuffer, uint32_t width, uint32_t height)
+	{
+		CollectReadbacks();
+
+		if ((!m_Recording && m_ScreenshotPath.empty()) || width == 0 || height == 0)
+			return;
+
+		uint32_t inFlight;
+		{
+			std::lock_guard<std::mutex> lock(m_State->Mutex);
+			inFlight = m_State->InFlight;
+		}
+		uint32_t readbacksInFlight = 0;
+		for (const Readback& readback : m_Readbacks)
+			readbacksInFlight += readback.Fence ? 1 : 0;
+
+		// Waiting for either the GPU or the workers would stall the frame
+		Readback& readback = m_Readbacks[m_NextReadback];
+		if (readback.Fence || inFlight + readbacksInFlight >= m_Settings.MaxPendingFrames)
+		{
+			m_Dropped++;
+			return;
+		}
+
+		size_t size = (size_t)width * height * 4;
+		if (readback.BufferSize < size)
+		{
+			glNamedBufferData(readback.Buffer, size, nullptr, GL_STREAM_READ);
+			readback.BufferSize = size;
+		}
+
+		GLint previousFramebuffer = 0;
+		glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousFramebuffer);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.Buffer);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, previousFramebuffer);
+
+		readback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		readback.Width = width;
+		readback.Height = height;
+		readback.Record = m_Recording;
+		readback.FrameIndex = m_Recording ? m_FrameIndex++ : 0;
+		readback.Target = m_Recording ? m_Stream : nullptr;
+		readback.ScreenshotPath = std::move(m_ScreenshotPath);
+		m_ScreenshotPath.clear();
+
+		m_NextReadback = (m_NextReadback + 1) % BufferCount;
+	}
+
+	void FrameCapture::CollectReadbacks()
+	{
+		// Oldest first, so stream frames stay in order; fences signal in order
+		for (size_t i = 0; i < BufferCount; i++)
+		{
+			Readback& readback = m_Readbacks[(m_NextReadback + i) % BufferCount];
+			if (!readback.Fence)
+				continue;
+
+			GLint status = GL_UNSIGNALED;
+			glGetSynciv(readback.Fence, GL_SYNC_STATUS, sizeof(status), nullptr, &status);
+			if (status != GL_SIGNALED)
+				break;
+
+			glDeleteSync(readback.Fence);
+			readback.Fence = nullptr;
+			Encode(readback);
+		}
+	}
+
+	void FrameCapture::FlushReadbacks()
+	{
+		// A readback is at most a few frames old, so this only waits that long
+		static constexpr GLuint64 Timeout = 1000000000;   // 1 second
+
+		for (size_t i = 0; i < BufferCount; i++)
+		{
+			Readback& readback = m_Readbacks[(m_NextReadback + i) % BufferCount];
+			if (!readback.Fence)
+				continue;
+
+			GLenum result = glClientWaitSync(readback.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, Timeout);
+			glDeleteSync(readback.Fence);
+			readback.Fence = nullptr;
+			if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+			{
+				readback.Target.reset();
+				readback.ScreenshotPath.clear();
+				m_Dropped++;
+				continue;
+			}
+			Encode(readback);
+		}
+	}
+
+	void FrameCapture::Encode(Readback& readback)
+	{
+		size_t size = (size_t)readback.Width * readback.Height * 4;
+
+		CapturedFrame frame;
+		frame.Width = readback.Width;
+		frame.Height = readback.Height;
+		frame.ScreenshotPath = std::move(readback.ScreenshotPath);
+		readback.ScreenshotPath.clear();
+		if (readback.Record && !readback.Target)
+		{
+			char suffix[16];
+			snprintf(suffix, sizeof(suffix), "_%05u.png", readback.FrameIndex);
+			frame.PNGPath = m_Settings.OutputPath + suffix;
+		}
+
+		// The fence has signaled, so mapping returns without waiting
+		const void* data = glMapNamedBufferRange(readback.Buffer, 0, size, GL_MAP_READ_BIT);
+		if (!data)
+		{
+			m_Dropped++;
+			return;
+		}
+		frame.Pixels = m_State->AcquireBuffer(size);
+		memcpy(frame.Pixels.data(), data, size);
+		glUnmapNamedBuffer(readback.Buffer);
+
+		{
+			std::lock_guard<std::mutex> lock(m_State->Mutex);
+			m_State->InFlight++;
+		}
+		m_Captured++;
+
+		std::shared_ptr<Stream> stream = std::move(readback.Target);
+		readback.Target.reset();
+		if (stream)
+		{
+			if (stream->Push(std::move(frame)))
+				m_Jobs.Submit([stream] { stream->Drain(); });
+			return;
+		}
+
+		m_Jobs.Submit([state = m_State, frame = std::move(frame)]() mutable
+		{
+			std::vector<uint8_t> scratch;
+			if (!frame.ScreenshotPath.empty())
+				(WriteFramePNG(frame.ScreenshotPath, frame, scratch) ? state->Written : state->Failed)++;
+			if (!frame.PNGPath.empty())
+				(WriteFramePNG(frame.PNGPath, frame, scratch) ? state->Written : state->Failed)++;
+			state->FinishFrame(std::move(frame.Pixels));
+		});
+	}
+
+	CaptureStats FrameCapture::GetStats() const
+	{
+		CaptureStats stats;
+		stats.Captured = m_Captured;
+		stats.Written = m_State->Written;
+		stats.Dropped = m_Dropped + m_State->Dropped;
+		stats.Failed = m_State->Failed;
+		{
+			std::lock_guard<std::mutex> lock(m_State->Mutex);
+			stats.Pending = m_State->InFlight;
+		}
+		for (const Readback& readback : m_Readbacks)
+			stats.Pending += readback.Fence ? 1 : 0;
+		return stats;
+	}
+
+	const char* GetCaptureFormatName(CaptureFormat format)
+	{
+		switch (format)
+		{
+			case CaptureFormat::PNG: return "PNG sequence";
+			case CaptureFormat::Raw: return "Raw RGBA";
+			case CaptureFormat::Y4M: return "Y4M";
+		}
+		return "Unknown";
+	}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "GLCore/Core/JobSystem.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace GLCore::Utils {
+
+	enum class CaptureFormat
+	{
+		// One numbered PNG file per frame
+		PNG = 0,
+		// Every frame appended to a single file as top-down RGBA8 rows
+		Raw,
+		// YUV4MPEG2 stream (4:2:0), which most video tools read directly
+		Y4M
+	};
+
+	struct CaptureSettings
+	{
+		CaptureFormat Format = CaptureFormat::PNG;
+		// Without an extension; PNG frames are written as <path>_00000.png
+		std::string OutputPath = "captures/capture";
+		uint32_t FrameRate = 60;   // Only stored in Y4M headers
+		// Frames read back or waiting for a worker; further frames are dropped
+		uint32_t MaxPendingFrames = 8;
+	};
+
+	struct CaptureStats
+	{
+		uint32_t Captured = 0;   // Frames read back and handed to a worker
+		uint32_t Written = 0;
+		uint32_t Dropped = 0;    // Skipped because readback or encoding fell behind
+		uint32_t Failed = 0;     // Lost to file errors
+		uint32_t Pending = 0;
+	};
+
+	// Records frames from any framebuffer without stalling the frame loop.
+	// Pixels are read into a ring of pixel buffer objects, and each buffer is
+	// only mapped once its fence has signaled, a frame or two later. Encoding
+	// and file IO run on the job system. When either falls behind, frames are
+	// dropped and counted rather than waited for.
+	class FrameCapture
+	{
+	public:
+		static constexpr size_t BufferCount = 3;
+
+		FrameCapture(JobSystem& jobs);
+		// Writes frames still being read back and waits for those being encoded
+		~FrameCapture();
+
+		FrameCapture(const FrameCapture&) = delete;
+		FrameCapture& operator=(const FrameCapture&) = delete;
+
+		void StartRecording(const CaptureSettings& settings);
+		// Waits for the readbacks still in flight, so every frame captured so
+		// far is still written
+		void StopRecording();
+		inline bool IsRecording() const { return m_Recording; }
+
+		// The next captured frame is also saved to <path>.png
+		void RequestScreenshot(const std::string& path);
+
+		// Call once per frame after the frame is complete. Reads back the
+		// color attachment of the given framebuffer (0 for the window) when
+		// recording or a screenshot is pending, and hands finished readbacks
+		// to the workers.
+		void Capture(GLuint framebuffer, uint32_t width, uint32_t height);
+
+		CaptureStats GetStats() const;
+		inline const CaptureSettings& GetSettings() const { return m_Settings; }
+	private:
+		struct Stream;
+		struct SharedState;
+
+		struct Readback
+		{
+			GLuint Buffer = 0;
+			size_t BufferSize = 0;
+			GLsync Fence = nullptr;
+			uint32_t Width = 0, Height = 0;
+			uint32_t FrameIndex = 0;
+			std::shared_ptr<Stream> Target;   // Null for PNG sequences
+			bool Record = false;
+			std::string ScreenshotPath;
+		};
+
+		void CollectReadbacks();
+		// Like CollectReadbacks, but waits for every pending fence
+		void FlushReadbacks();
+		void Encode(Readback& readback);
+	private:
+		JobSystem& m_Jobs;
+		std::shared_ptr<SharedState> m_State;
+
+		std::array<Readback, BufferCount> m_Readbacks;
+		size_t m_NextReadback = 0;
+
+		CaptureSettings m_Settings;
+		bool m_Recording = false;
+		std::shared_ptr<Stream> m_Stream;
+		uint32_t m_FrameIndex = 0;
+		std::string m_ScreenshotPath;
+
+		uint32_t m_Captured = 0, m_Dropped = 0;
+	};
+
+	const char* GetCaptureFormatName(CaptureFormat format);
+
+}
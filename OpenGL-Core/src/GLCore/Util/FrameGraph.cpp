@@ -0,0 +1,495 @@
+#include "glpch.h"
+#include "FrameGraph.h"
+
+#include "GLCore/Core/Core.h"
+
+#include <cstring>
+
+namespace GLCore::Utils {
+
+	static bool IsDepthFormat(GLenum format)
+	{
+		switch (format)
+		{
+			case GL_DEPTH_COMPONENT16:
+			case GL_DEPTH_COMPONENT24:
+			case GL_DEPTH_COMPONENT32F:
+			case GL_DEPTH24_STENCIL8:
+			case GL_DEPTH32F_STENCIL8:
+				return true;
+		}
+		return false;
+	}
+
+	static size_t GetBytesPerPixel(GLenum format)
+	{
+		switch (format)
+		{
+			case GL_R8:                 return 1;
+			case GL_RG8:
+			case GL_R16F:
+			case GL_DEPTH_COMPONENT16:  return 2;
+			case GL_RGBA16F:
+			case GL_RG32F:
+			case GL_DEPTH32F_STENCIL8:  return 8;
+			case GL_RGBA32F:            return 16;
+		}
+		// RGBA8, R32F, RG16F, DEPTH24_STENCIL8 and the like
+		return 4;
+	}
+
+	////////////////////////////////////////////////////////////
+	// TransientTexturePool ////////////////////////////////////
+	////////////////////////////////////////////////////////////
+
+	TransientTexturePool::~TransientTexturePool()
+	{
+		for (const Entry& entry : m_Entries)
+			glDeleteTextures(1, &entry.Texture);
+	}
+
+	GLuint TransientTexturePool::Acquire(const TransientTextureDesc& desc)
+	{
+		for (Entry& entry : m_Entries)
+		{
+			if (!entry.InUse && entry.Desc == desc)
+			{
+				entry.InUse = true;
+				entry.UnusedFrames = 0;
+				return entry.Texture;
+			}
+		}
+
+		GLuint texture;
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureStorage2D(texture, 1, desc.Format, desc.Width, desc.Height);
+		if (!IsDepthFormat(desc.Format))
+		{
+			glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		}
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		m_Entries.push_back({ texture, desc, true, 0 });
+		return texture;
+	}
+
+	void TransientTexturePool::Release(GLuint texture)
+	{
+		for (Entry& entry : m_Entries)
+		{
+			if (entry.Texture == texture)
+			{
+				entry.InUse = false;
+				return;
+			}
+		}
+	}
+
+	void TransientTexturePool::EndFrame(std::vector<GLuint>& deleted)
+	{
+		for (size_t i = 0; i < m_Entries.size(); )
+		{
+			Entry& entry = m_Entries[i];
+			if (entry.InUse || ++entry.UnusedFrames <= MaxUnusedFrames)
+			{
+				i++;
+				continue;
+			}
+
+			glDeleteTextures(1, &entry.Texture);
+			deleted.push_back(entry.Texture);
+			m_Entries[i] = m_Entries.back();
+			m_Entries.pop_back();
+		}
+	}
+
+	size_t TransientTexturePool::GetMemoryUsage() const
+	{
+		size_t size = 0;
+		for (const Entry& entry : m_Entries)
+			size += GetTextureSize(entry.Desc);
+		return size;
+	}
+
+	size_t TransientTexturePool::GetTextureSize(const TransientTextureDesc& desc)
+	{
+		return (size_t)desc.Width * desc.Height * GetBytesPerPixel(desc.Format);
+	}
+
+	////////////////////////////////////////////////////////////
+	// FrameGraphBuilder ///////////////////////////////////////
+	////////////////////////////////////////////////////////////
+
+	FrameGraphResource FrameGraphBuilder::CreateTexture(std::string_view name, const TransientTextureDesc& desc)
+	{
+		FrameGraph::Resource& resource = m_Graph.m_Resources.emplace_back();
+		resource.Name = m_Graph.CopyName(name);
+		resource.Desc = desc;
+		return (FrameGraphResource)m_Graph.m_Resources.size() - 1;
+	}
+
+	FrameGraphResource FrameGraphBuilder::Read(FrameGraphResource resource)
+	{
+		GLCORE_ASSERT(resource < m_Graph.m_Resources.size(), "Invalid frame graph resource");
+		m_Graph.m_Passes[m_Pass].Reads.push_back(resource);
+		return resource;
+	}
+
+	FrameGraphResource FrameGraphBuilder::Write(FrameGraphResource resource)
+	{
+		GLCORE_ASSERT(resource < m_Graph.m_Resources.size(), "Invalid frame graph resource");
+		m_Graph.m_Passes[m_Pass].ColorWrites.push_back(resource);
+		return resource;
+	}
+
+	FrameGraphResource FrameGraphBuilder::WriteDepth(FrameGraphResource resource)
+	{
+		GLCORE_ASSERT(resource < m_Graph.m_Resources.size(), "Invalid frame graph resource");
+		m_Graph.m_Passes[m_Pass].DepthWrite = resource;
+		return resource;
+	}
+
+	void FrameGraphBuilder::SetSideEffect()
+	{
+		m_Graph.m_Passes[m_Pass].SideEffect = true;
+	}
+
+	GLuint FrameGraphResources::GetTexture(FrameGraphResource resource) const
+	{
+		return m_Graph.m_Resources[resource].Texture;
+	}
+
+	////////////////////////////////////////////////////////////
+	// FrameGraph //////////////////////////////////////////////
+	////////////////////////////////////////////////////////////
+
+	FrameGraph::FrameGraph(LinearAllocator& frameAllocator)
+		: m_FrameAllocator(frameAllocator)
+	{
+	}
+
+	FrameGraph::~FrameGraph()
+	{
+		for (auto& [attachments, framebuffer] : m_Framebuffers)
+			glDeleteFramebuffers(1, &framebuffer);
+	}
+
+	void FrameGraph::BeginFrame(uint32_t width, uint32_t height)
+	{
+		m_Passes.clear();
+		m_Resources.clear();
+		m_Order.clear();
+		m_Compiled = false;
+
+		Resource& backbuffer = m_Resources.emplace_back();
+		backbuffer.Name = "Backbuffer";
+		backbuffer.Desc = { width, height, GL_RGBA8 };
+		backbuffer.Backbuffer = true;
+		m_Backbuffer = 0;
+	}
+
+	FrameGraphBuilder FrameGraph::BeginPass(std::string_view name, const PassExecutor& executor)
+	{
+		GLCORE_ASSERT(!m_Compiled, "Passes must be added before the frame graph is compiled");
+
+		Pass& pass = m_Passes.emplace_back(m_FrameAllocator);
+		pass.Name = CopyName(name);
+		pass.Execute = executor;
+
+		return FrameGraphBuilder(*this, (uint32_t)m_Passes.size() - 1);
+	}
+
+	const char* FrameGraph::CopyName(std::string_view name)
+	{
+		char* copy = m_FrameAllocator.AllocateArray<char>(name.size() + 1);
+		memcpy(copy, name.data(), name.size());
+		copy[name.size()] = '\0';
+		return copy;
+	}
+
+	void FrameGraph::Compile()
+	{
+		CullPasses();
+		OrderPasses();
+		AllocateResources();
+		m_Compiled = true;
+	}
+
+	void FrameGraph::CullPasses()
+	{
+		// Passes with visible results are roots. Whatever they read is needed,
+		// and so is every pass writing something that is needed.
+		for (Resource& resource : m_Resources)
+			resource.Needed = resource.Backbuffer;
+
+		for (Pass& pass : m_Passes)
+			pass.Culled = true;
+
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (Pass& pass : m_Passes)
+			{
+				if (!pass.Culled)
+					continue;
+
+				bool needed = pass.SideEffect || (pass.DepthWrite != InvalidFrameGraphResource && m_Resources[pass.DepthWrite].Needed);
+				for (FrameGraphResource write : pass.ColorWrites)
+					needed = needed || m_Resources[write].Needed;
+				if (!needed)
+					continue;
+
+				pass.Culled = false;
+				for (FrameGraphResource read : pass.Reads)
+					m_Resources[read].Needed = true;
+				changed = true;
+			}
+		}
+	}
+
+	void FrameGraph::OrderPasses()
+	{
+		// Dependencies follow declaration order: a pass depends on the last
+		// writer of everything it touches, and a writer also waits for the
+		// readers of the previous contents
+		size_t passCount = m_Passes.size();
+		LinearVector<uint32_t> empty(m_FrameAllocator);
+		LinearVector<LinearVector<uint32_t>> dependents(passCount, empty, m_FrameAllocator);
+		LinearVector<uint32_t> dependencyCount(passCount, 0, m_FrameAllocator);
+		LinearVector<int32_t> lastWriter(m_Resources.size(), -1, m_FrameAllocator);
+		LinearVector<LinearVector<uint32_t>> readersSinceWrite(m_Resources.size(), empty, m_FrameAllocator);
+
+		auto addEdge = [&](int32_t from, uint32_t to)
+		{
+			if (from < 0 || (uint32_t)from == to)
+				return;
+			dependents[from].push_back(to);
+			dependencyCount[to]++;
+		};
+
+		for (uint32_t i = 0; i < passCount; i++)
+		{
+			const Pass& pass = m_Passes[i];
+			if (pass.Culled)
+				continue;
+
+			for (FrameGraphResource read : pass.Reads)
+			{
+				addEdge(lastWriter[read], i);
+				readersSinceWrite[read].push_back(i);
+			}
+
+			auto write = [&](FrameGraphResource resource)
+			{
+				addEdge(lastWriter[resource], i);
+				for (uint32_t reader : readersSinceWrite[resource])
+					addEdge(reader, i);
+				readersSinceWrite[resource].clear();
+				lastWriter[resource] = i;
+			};
+			for (FrameGraphResource resource : pass.ColorWrites)
+				write(resource);
+			if (pass.DepthWrite != InvalidFrameGraphResource)
+				write(pass.DepthWrite);
+		}
+
+		// Kahn's algorithm, preferring the earliest declared pass among the ready ones
+		m_Order.clear();
+		LinearVector<uint32_t> ready(m_FrameAllocator);
+		for (uint32_t i = 0; i < passCount; i++)
+		{
+			if (!m_Passes[i].Culled && dependencyCount[i] == 0)
+				ready.push_back(i);
+		}
+
+		while (!ready.empty())
+		{
+			auto next = std::min_element(ready.begin(), ready.end());
+			uint32_t pass = *next;
+			ready.erase(next);
+			m_Order.push_back(pass);
+
+			for (uint32_t dependent : dependents[pass])
+			{
+				if (--dependencyCount[dependent] == 0)
+					ready.push_back(dependent);
+			}
+		}
+	}
+
+	void FrameGraph::AllocateResources()
+	{
+		m_Stats = FrameGraphStats();
+		m_Stats.PassCount = (uint32_t)m_Passes.size();
+		m_Stats.CulledPassCount = (uint32_t)(m_Passes.size() - m_Order.size());
+
+		for (Resource& resource : m_Resources)
+			resource.FirstUse = resource.LastUse = -1;
+
+		for (int32_t position = 0; position < (int32_t)m_Order.size(); position++)
+		{
+			const Pass& pass = m_Passes[m_Order[position]];
+			auto use = [&](FrameGraphResource id)
+			{
+				Resource& resource = m_Resources[id];
+				if (resource.FirstUse < 0)
+					resource.FirstUse = position;
+				resource.LastUse = position;
+			};
+			for (FrameGraphResource id : pass.Reads)
+				use(id);
+			for (FrameGraphResource id : pass.ColorWrites)
+				use(id);
+			if (pass.DepthWrite != InvalidFrameGraphResource)
+				use(pass.DepthWrite);
+		}
+
+		// Textures return to the pool after their last pass, so a later
+		// resource with the same description aliases the same memory
+		LinearVector<GLuint> physical(m_FrameAllocator);
+		for (int32_t position = 0; position < (int32_t)m_Order.size(); position++)
+		{
+			for (Resource& resource : m_Resources)
+			{
+				if (resource.Backbuffer || resource.FirstUse != position)
+					continue;
+
+				resource.Texture = m_Pool.Acquire(resource.Desc);
+				m_Stats.TransientTextureCount++;
+				m_Stats.TransientMemory += TransientTexturePool::GetTextureSize(resource.Desc);
+				if (std::find(physical.begin(), physical.end(), resource.Texture) == physical.end())
+				{
+					physical.push_back(resource.Texture);
+					m_Stats.PhysicalMemory += TransientTexturePool::GetTextureSize(resource.Desc);
+				}
+			}
+
+			for (const Resource& resource : m_Resources)
+			{
+				if (!resource.Backbuffer && resource.LastUse == position)
+					m_Pool.Release(resource.Texture);
+			}
+		}
+		m_Stats.PhysicalTextureCount = (uint32_t)physical.size();
+	}
+
+	void FrameGraph::BindTargets(const Pass& pass)
+	{
+		bool toBackbuffer = pass.DepthWrite == m_Backbuffer;
+		for (FrameGraphResource write : pass.ColorWrites)
+			toBackbuffer = toBackbuffer || write == m_Backbuffer;
+
+		if (toBackbuffer || (pass.ColorWrites.empty() && pass.DepthWrite == InvalidFrameGraphResource))
+		{
+			GLCORE_ASSERT(!toBackbuffer || pass.ColorWrites.size() <= 1, "The backbuffer can't be combined with other targets");
+			const TransientTextureDesc& desc = m_Resources[m_Backbuffer].Desc;
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glViewport(0, 0, desc.Width, desc.Height);
+			return;
+		}
+
+		// The key is rebuilt in place, and only copied into the cache on a miss
+		std::vector<GLuint>& attachments = m_AttachmentKey;
+		attachments.clear();
+		for (FrameGraphResource write : pass.ColorWrites)
+			attachments.push_back(m_Resources[write].Texture);
+		attachments.push_back(pass.DepthWrite != InvalidFrameGraphResource ? m_Resources[pass.DepthWrite].Texture : 0);
+
+		auto cached = m_Framebuffers.find(attachments);
+		if (cached == m_Framebuffers.end())
+		{
+			cached = m_Framebuffers.emplace(attachments, 0).first;
+			GLuint& framebuffer = cached->second;
+			glCreateFramebuffers(1, &framebuffer);
+
+			std::vector<GLenum> drawBuffers;
+			for (size_t i = 0; i < pass.ColorWrites.size(); i++)
+			{
+				glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0 + (GLenum)i, attachments[i], 0);
+				drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + (GLenum)i);
+			}
+			if (drawBuffers.empty())
+				glNamedFramebufferDrawBuffer(framebuffer, GL_NONE);
+			else
+				glNamedFramebufferDrawBuffers(framebuffer, (GLsizei)drawBuffers.size(), drawBuffers.data());
+
+			if (pass.DepthWrite != InvalidFrameGraphResource)
+			{
+				GLenum format = m_Resources[pass.DepthWrite].Desc.Format;
+				GLenum attachment = format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+				glNamedFramebufferTexture(framebuffer, attachment, attachments.back(), 0);
+			}
+
+			GLenum status = glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER);
+			if (status != GL_FRAMEBUFFER_COMPLETE)
+				LOG_ERROR("Frame graph pass '{0}' has an incomplete framebuffer (0x{1:x})", pass.Name, status);
+		}
+
+		FrameGraphResource first = pass.ColorWrites.empty() ? pass.DepthWrite : pass.ColorWrites[0];
+		const TransientTextureDesc& desc = m_Resources[first].Desc;
+		glBindFramebuffer(GL_FRAMEBUFFER, cached->second);
+		glViewport(0, 0, desc.Width, desc.Height);
+	}
+
+	void FrameGraph::Execute()
+	{
+		if (!m_Compiled)
+			Compile();
+
+		FrameGraphResources resources(*this);
+		for (uint32_t index : m_Order)
+		{
+			const Pass& pass = m_Passes[index];
+			BindTargets(pass);
+			pass.Execute.Invoke(pass.Execute.Callable, resources);
+		}
+
+		const TransientTextureDesc& backbuffer = m_Resources[m_Backbuffer].Desc;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, backbuffer.Width, backbuffer.Height);
+
+		ReleaseResources();
+	}
+
+	void FrameGraph::ReleaseResources()
+	{
+		std::vector<GLuint>& deleted = m_DeletedTextures;
+		deleted.clear();
+		m_Pool.EndFrame(deleted);
+		if (deleted.empty())
+			return;
+
+		// A deleted name can be handed out again, so framebuffers that still
+		// reference the old texture must go too
+		for (auto it = m_Framebuffers.begin(); it != m_Framebuffers.end(); )
+		{
+			bool stale = std::any_of(it->first.begin(), it->first.end(), [&](GLuint texture)
+				{
+					return texture != 0 && std::find(deleted.begin(), deleted.end(), texture) != deleted.end();
+				});
+			if (!stale)
+			{
+				++it;
+				continue;
+			}
+
+			glDeleteFramebuffers(1, &it->second);
+			it = m_Framebuffers.erase(it);
+		}
+	}
+
+	void FrameGraph::GetPassNames(std::vector<const char*>& executed, std::vector<const char*>& culled) const
+	{
+		for (uint32_t index : m_Order)
+			executed.push_back(m_Passes[index].Name);
+		for (const Pass& pass : m_Passes)
+		{
+			if (pass.Culled)
+				culled.push_back(pass.Name);
+		}
+	}
+
+}
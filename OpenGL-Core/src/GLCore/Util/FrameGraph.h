@@ -0,0 +1,221 @@
+#pragma once
+
+#include "GLCore/Core/Memory.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	struct TransientTextureDesc
+	{
+		uint32_t Width = 0, Height = 0;
+		GLenum Format = GL_RGBA8;
+
+		inline bool operator==(const TransientTextureDesc& other) const
+		{
+			return Width == other.Width && Height == other.Height && Format == other.Format;
+		}
+	};
+
+	// Render target textures that are recycled between passes and frames.
+	// Textures that go unused for a few frames are deleted.
+	class TransientTexturePool
+	{
+	public:
+		static constexpr uint32_t MaxUnusedFrames = 3;
+
+		TransientTexturePool() = default;
+		~TransientTexturePool();
+
+		TransientTexturePool(const TransientTexturePool&) = delete;
+		TransientTexturePool& operator=(const TransientTexturePool&) = delete;
+
+		GLuint Acquire(const TransientTextureDesc& desc);
+		void Release(GLuint texture);
+
+		// Ages unused textures and deletes stale ones; their names are appended to deleted
+		void EndFrame(std::vector<GLuint>& deleted);
+
+		inline size_t GetTextureCount() const { return m_Entries.size(); }
+		size_t GetMemoryUsage() const;
+
+		static size_t GetTextureSize(const TransientTextureDesc& desc);
+	private:
+		struct Entry
+		{
+			GLuint Texture;
+			TransientTextureDesc Desc;
+			bool InUse;
+			uint32_t UnusedFrames;
+		};
+		std::vector<Entry> m_Entries;
+	};
+
+	using FrameGraphResource = uint32_t;
+	static constexpr FrameGraphResource InvalidFrameGraphResource = ~0u;
+
+	class FrameGraph;
+
+	// Passed to a pass's setup function to declare what it reads and writes
+	class FrameGraphBuilder
+	{
+	public:
+		// A texture that only lives for this frame, allocated from the pool
+		FrameGraphResource CreateTexture(std::string_view name, const TransientTextureDesc& desc);
+
+		FrameGraphResource Read(FrameGraphResource resource);
+		// Color attachments are assigned in the order they are written
+		FrameGraphResource Write(FrameGraphResource resource);
+		FrameGraphResource WriteDepth(FrameGraphResource resource);
+
+		// The pass does something the graph can't see, so it is never culled
+		void SetSideEffect();
+	private:
+		FrameGraphBuilder(FrameGraph& graph, uint32_t pass)
+			: m_Graph(graph), m_Pass(pass) {}
+
+		FrameGraph& m_Graph;
+		uint32_t m_Pass;
+
+		friend class FrameGraph;
+	};
+
+	// Passed to a pass's execute function to look up its textures
+	class FrameGraphResources
+	{
+	public:
+		GLuint GetTexture(FrameGraphResource resource) const;
+	private:
+		FrameGraphResources(const FrameGraph& graph)
+			: m_Graph(graph) {}
+
+		const FrameGraph& m_Graph;
+
+		friend class FrameGraph;
+	};
+
+	struct FrameGraphStats
+	{
+		uint32_t PassCount = 0, CulledPassCount = 0;
+		uint32_t TransientTextureCount = 0, PhysicalTextureCount = 0;
+		// Memory the transient textures would need without aliasing, and what they use
+		size_t TransientMemory = 0, PhysicalMemory = 0;
+	};
+
+	// Passes declare their targets and dependencies up front. Compile culls
+	// passes whose results are never used, orders the rest by dependency and
+	// assigns pooled textures to transient resources, reusing a texture once
+	// every pass that touches its previous resource has run. Execute binds each
+	// pass's targets and runs it.
+	//
+	// Each frame: BeginFrame, AddPass..., Compile, Execute.
+	//
+	// Everything a frame declares lives in the frame allocator, which must be
+	// reset before BeginFrame and not again until after Execute. In steady
+	// state building and running the graph does not touch the heap.
+	class FrameGraph
+	{
+	public:
+		FrameGraph(LinearAllocator& frameAllocator);
+		~FrameGraph();
+
+		FrameGraph(const FrameGraph&) = delete;
+		FrameGraph& operator=(const FrameGraph&) = delete;
+
+		// Drops last frame's passes and adds the default framebuffer as the backbuffer
+		void BeginFrame(uint32_t width, uint32_t height);
+		inline FrameGraphResource GetBackbuffer() const { return m_Backbuffer; }
+
+		// Setup runs immediately with a FrameGraphBuilder. Execute runs later
+		// with the pass's FrameGraphResources; it is copied into frame memory
+		// and never destroyed, so it may only capture trivially destructible
+		// values such as pointers, references and numbers.
+		template<typename SetupFunc, typename ExecuteFunc>
+		void AddPass(std::string_view name, SetupFunc&& setup, ExecuteFunc&& execute)
+		{
+			using Callable = std::decay_t<ExecuteFunc>;
+			static_assert(std::is_trivially_destructible_v<Callable>, "Pass execute functions must be trivially destructible");
+
+			PassExecutor executor;
+			executor.Callable = m_FrameAllocator.New<Callable>(std::forward<ExecuteFunc>(execute));
+			executor.Invoke = [](const void* callable, const FrameGraphResources& resources)
+			{
+				(*static_cast<const Callable*>(callable))(resources);
+			};
+
+			FrameGraphBuilder builder = BeginPass(name, executor);
+			setup(builder);
+		}
+
+		void Compile();
+		void Execute();
+
+		inline const FrameGraphStats& GetStats() const { return m_Stats; }
+		// Pass names in execution order, followed by the culled passes. The
+		// names are only valid until the next BeginFrame.
+		void GetPassNames(std::vector<const char*>& executed, std::vector<const char*>& culled) const;
+	private:
+		struct PassExecutor
+		{
+			const void* Callable = nullptr;
+			void (*Invoke)(const void* callable, const FrameGraphResources& resources) = nullptr;
+		};
+
+		struct Resource
+		{
+			const char* Name = nullptr;
+			TransientTextureDesc Desc;
+			GLuint Texture = 0;
+			bool Backbuffer = false;
+			bool Needed = false;
+			int32_t FirstUse = -1, LastUse = -1;
+		};
+
+		struct Pass
+		{
+			Pass(LinearAllocator& allocator)
+				: Reads(allocator), ColorWrites(allocator) {}
+
+			const char* Name = nullptr;
+			PassExecutor Execute;
+			LinearVector<FrameGraphResource> Reads, ColorWrites;
+			FrameGraphResource DepthWrite = InvalidFrameGraphResource;
+			bool SideEffect = false;
+			bool Culled = true;
+		};
+
+		FrameGraphBuilder BeginPass(std::string_view name, const PassExecutor& executor);
+		const char* CopyName(std::string_view name);
+
+		void CullPasses();
+		void OrderPasses();
+		void AllocateResources();
+		void BindTargets(const Pass& pass);
+		void ReleaseResources();
+	private:
+		LinearAllocator& m_FrameAllocator;
+		// Cleared every frame but never shrunk, so their capacity carries over
+		std::vector<Pass> m_Passes;
+		std::vector<Resource> m_Resources;
+		std::vector<uint32_t> m_Order;
+		FrameGraphResource m_Backbuffer = InvalidFrameGraphResource;
+		bool m_Compiled = false;
+
+		TransientTexturePool m_Pool;
+		// Keyed by the textures attached, color attachments first and depth last
+		std::map<std::vector<GLuint>, GLuint> m_Framebuffers;
+		std::vector<GLuint> m_AttachmentKey;
+		std::vector<GLuint> m_DeletedTextures;
+		FrameGraphStats m_Stats;
+
+		friend class FrameGraphBuilder;
+		friend class FrameGraphResources;
+	};
+
+}
@@ -0,0 +1,74 @@
+#include "glpch.h"
+#include "FrameUniforms.h"
+
+#include <cmath>
+
+namespace GLCore::Utils {
+
+	FrameUniformBuffer::FrameUniformBuffer()
+	{
+		m_RendererID = CreateGLBuffer();
+		glNamedBufferStorage(m_RendererID, sizeof(FrameUniformData), nullptr, GL_DYNAMIC_STORAGE_BIT);
+		glBindBufferBase(GL_UNIFORM_BUFFER, Binding, m_RendererID);
+	}
+
+	void FrameUniformBuffer::SetCamera(const OrthographicCamera& camera)
+	{
+		if (camera.GetRevision() == m_CameraRevision)
+			return;
+
+		m_Data.ViewProjection = camera.GetViewProjectionMatrix();
+		m_Data.View = camera.GetViewMatrix();
+		m_Data.Projection = camera.GetProjectionMatrix();
+		m_CameraRevision = camera.GetRevision();
+		m_Dirty = true;
+	}
+
+	void FrameUniformBuffer::SetViewProjection(const glm::mat4& viewProjection)
+	{
+		if (m_CameraRevision == 0 && viewProjection == m_Data.ViewProjection)
+			return;
+
+		m_Data.ViewProjection = viewProjection;
+		m_Data.View = glm::mat4(1.0f);
+		m_Data.Projection = viewProjection;
+		// No camera matches revision 0, so the next SetCamera always applies
+		m_CameraRevision = 0;
+		m_Dirty = true;
+	}
+
+	void FrameUniformBuffer::SetViewport(uint32_t width, uint32_t height)
+	{
+		glm::vec4 viewport(width, height, width ? 1.0f / width : 0.0f, height ? 1.0f / height : 0.0f);
+		if (viewport == m_Data.Viewport)
+			return;
+
+		m_Data.Viewport = viewport;
+		m_Dirty = true;
+	}
+
+	void FrameUniformBuffer::SetTime(double seconds, float deltaTime)
+	{
+		float time = (float)std::fmod(seconds, TimeWrapPeriod);
+		if (time == m_Data.Time && deltaTime == m_Data.DeltaTime)
+			return;
+
+		m_Data.Time = time;
+		m_Data.DeltaTime = deltaTime;
+		m_Dirty = true;
+	}
+
+	void FrameUniformBuffer::Upload()
+	{
+		// Other code may have used the binding point, e.g. a pass with its own block
+		glBindBufferBase(GL_UNIFORM_BUFFER, Binding, m_RendererID);
+
+		if (!m_Dirty)
+			return;
+
+		glNamedBufferSubData(m_RendererID, 0, sizeof(FrameUniformData), &m_Data);
+		m_Dirty = false;
+		m_UploadCount++;
+	}
+
+}
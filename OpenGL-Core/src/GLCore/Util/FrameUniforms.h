@@ -0,0 +1,73 @@
+#pragma once
+
+#include "OrthographicCamera.h"
+#include "GLResource.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+namespace GLCore::Utils {
+
+	// Mirrors the std140 Frame block that shaders pull in with
+	// #include "include/frame.glsl":
+	//
+	//   layout (std140, binding = 0) uniform Frame
+	//   {
+	//       mat4 u_ViewProjection;
+	//       mat4 u_View;
+	//       mat4 u_Projection;
+	//       vec4 u_Viewport;    // width, height, 1 / width, 1 / height
+	//       float u_Time;       // seconds, wrapping every TimeWrapPeriod
+	//       float u_DeltaTime;  // seconds
+	//   };
+	struct FrameUniformData
+	{
+		glm::mat4 ViewProjection = glm::mat4(1.0f);
+		glm::mat4 View = glm::mat4(1.0f);
+		glm::mat4 Projection = glm::mat4(1.0f);
+		glm::vec4 Viewport = glm::vec4(0.0f);
+		float Time = 0.0f;
+		float DeltaTime = 0.0f;
+		float Padding[2] = {};
+	};
+	static_assert(sizeof(FrameUniformData) == 224, "FrameUniformData must match the std140 Frame block");
+
+	// Per-frame constants shared by every program through one uniform buffer,
+	// so switching programs never re-uploads the camera. Setters only record
+	// changes; Upload writes the buffer once if anything changed.
+	class FrameUniformBuffer
+	{
+	public:
+		static constexpr GLuint Binding = 0;
+		// A float holding days of uptime can't resolve a frame, so u_Time
+		// wraps. Shaders that animate with it jump once per period.
+		static constexpr double TimeWrapPeriod = 3600.0;
+
+		FrameUniformBuffer();
+
+		FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+		FrameUniformBuffer& operator=(const FrameUniformBuffer&) = delete;
+
+		// Cheap when the camera hasn't changed since it was last set
+		void SetCamera(const OrthographicCamera& camera);
+		// For passes that don't use an OrthographicCamera
+		void SetViewProjection(const glm::mat4& viewProjection);
+		void SetViewport(uint32_t width, uint32_t height);
+		// Time is in seconds since startup and is wrapped before it is narrowed to a float
+		void SetTime(double seconds, float deltaTime);
+
+		// Call before drawing. Writes the buffer only when something changed
+		// since the last upload, and makes sure it is bound at Binding.
+		void Upload();
+
+		inline const FrameUniformData& GetData() const { return m_Data; }
+		inline uint32_t GetUploadCount() const { return m_UploadCount; }
+	private:
+		GLBuffer m_RendererID;
+		FrameUniformData m_Data;
+		uint64_t m_CameraRevision = 0;
+		bool m_Dirty = true;
+		uint32_t m_UploadCount = 0;
+	};
+
+}
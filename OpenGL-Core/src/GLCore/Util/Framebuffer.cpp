@@ -0,0 +1,70 @@
+#include "glpch.h"
+#include "Framebuffer.h"
+
+namespace GLCore::Utils {
+
+	Framebuffer::Framebuffer(const FramebufferSpecification& spec)
+		: m_Specification(spec)
+	{
+		Invalidate();
+	}
+
+	void Framebuffer::Release()
+	{
+		// Deferred, so a resize doesn't stall on draws still reading the old attachments
+		m_RendererID.Reset();
+		m_ColorAttachment.Reset();
+		m_DepthAttachment.Reset();
+	}
+
+	void Framebuffer::Invalidate()
+	{
+		Release();
+
+		if (m_Specification.Width == 0 || m_Specification.Height == 0)
+			return;
+
+		m_RendererID = CreateGLFramebuffer();
+
+		m_ColorAttachment = CreateGLTexture(GL_TEXTURE_2D);
+		glTextureStorage2D(m_ColorAttachment, 1, m_Specification.ColorFormat, m_Specification.Width, m_Specification.Height);
+		glTextureParameteri(m_ColorAttachment, GL_TEXTURE_MIN_FILTER, m_Specification.Filter);
+		glTextureParameteri(m_ColorAttachment, GL_TEXTURE_MAG_FILTER, m_Specification.Filter);
+		glTextureParameteri(m_ColorAttachment, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_ColorAttachment, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glNamedFramebufferTexture(m_RendererID, GL_COLOR_ATTACHMENT0, m_ColorAttachment, 0);
+
+		if (m_Specification.DepthAttachment)
+		{
+			m_DepthAttachment = CreateGLTexture(GL_TEXTURE_2D);
+			glTextureStorage2D(m_DepthAttachment, 1, GL_DEPTH24_STENCIL8, m_Specification.Width, m_Specification.Height);
+			glNamedFramebufferTexture(m_RendererID, GL_DEPTH_STENCIL_ATTACHMENT, m_DepthAttachment, 0);
+		}
+
+		GLenum status = glCheckNamedFramebufferStatus(m_RendererID, GL_FRAMEBUFFER);
+		if (status != GL_FRAMEBUFFER_COMPLETE)
+			LOG_ERROR("Framebuffer is incomplete (0x{0:x})", status);
+	}
+
+	void Framebuffer::Resize(uint32_t width, uint32_t height)
+	{
+		if (width == m_Specification.Width && height == m_Specification.Height)
+			return;
+
+		m_Specification.Width = width;
+		m_Specification.Height = height;
+		Invalidate();
+	}
+
+	void Framebuffer::Bind()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+		glViewport(0, 0, m_Specification.Width, m_Specification.Height);
+	}
+
+	void Framebuffer::Unbind()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+}
\ No newline at end of file
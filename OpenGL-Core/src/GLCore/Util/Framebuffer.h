@@ -0,0 +1,45 @@
+#pragma once
+
+#include "GLResource.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+namespace GLCore::Utils {
+
+	struct FramebufferSpecification
+	{
+		uint32_t Width = 0, Height = 0;
+		GLenum ColorFormat = GL_RGBA8;
+		bool DepthAttachment = true;
+		GLenum Filter = GL_NEAREST;
+	};
+
+	class Framebuffer
+	{
+	public:
+		Framebuffer(const FramebufferSpecification& spec);
+
+		Framebuffer(const Framebuffer&) = delete;
+		Framebuffer& operator=(const Framebuffer&) = delete;
+
+		void Resize(uint32_t width, uint32_t height);
+
+		// Binds for drawing and sets the viewport to the framebuffer's size
+		void Bind();
+		void Unbind();
+
+		inline GLuint GetRendererID() const { return m_RendererID; }
+		inline GLuint GetColorAttachmentRendererID() const { return m_ColorAttachment; }
+		inline const FramebufferSpecification& GetSpecification() const { return m_Specification; }
+	private:
+		void Invalidate();
+		void Release();
+	private:
+		FramebufferSpecification m_Specification;
+		GLFramebuffer m_RendererID;
+		GLTexture m_ColorAttachment, m_DepthAttachment;
+	};
+
+}
\ No newline at end of file
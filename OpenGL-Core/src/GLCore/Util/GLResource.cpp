@@ -0,0 +1,209 @@
+#include "glpch.h"
+#include "GLResource.h"
+
+namespace GLCore::Utils {
+
+	GLDeletionQueue* GLDeletionQueue::s_Instance = nullptr;
+
+	const char* GetGLResourceTypeName(GLResourceType type)
+	{
+		switch (type)
+		{
+			case GLResourceType::Buffer:      return "buffer";
+			case GLResourceType::VertexArray: return "vertex array";
+			case GLResourceType::Texture:     return "texture";
+			case GLResourceType::Program:     return "program";
+			case GLResourceType::Framebuffer: return "framebuffer";
+		}
+		return "unknown";
+	}
+
+	GLDeletionQueue::GLDeletionQueue()
+	{
+		GLCORE_ASSERT(!s_Instance, "GLDeletionQueue already exists!");
+		s_Instance = this;
+	}
+
+	GLDeletionQueue::~GLDeletionQueue()
+	{
+		// Everything left must go now, so wait for the GPU instead of polling fences
+		glFinish();
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (Batch& batch : m_InFlight)
+			{
+				glDeleteSync(batch.Fence);
+				Delete(batch.Objects);
+			}
+			m_InFlight.clear();
+			Delete(m_Released);
+		}
+
+		ReportLeaks();
+		s_Instance = nullptr;
+	}
+
+	void GLDeletionQueue::Track(GLResourceType type, GLuint id)
+	{
+		if (id == 0 || !s_Instance)
+			return;
+
+		std::lock_guard<std::mutex> lock(s_Instance->m_Mutex);
+		s_Instance->m_Live[(size_t)type].insert(id);
+	}
+
+	void GLDeletionQueue::Release(GLResourceType type, GLuint id)
+	{
+		if (id == 0)
+			return;
+
+		if (!s_Instance)
+		{
+			ObjectLists objects;
+			objects[(size_t)type].push_back(id);
+			Delete(objects);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(s_Instance->m_Mutex);
+		s_Instance->m_Live[(size_t)type].erase(id);
+		s_Instance->m_Released[(size_t)type].push_back(id);
+	}
+
+	void GLDeletionQueue::EndFrame()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Batches retire in order, so stop at the first one still in use
+		while (!m_InFlight.empty())
+		{
+			Batch& batch = m_InFlight.front();
+			GLint status = GL_UNSIGNALED;
+			glGetSynciv(batch.Fence, GL_SYNC_STATUS, 1, nullptr, &status);
+			if (status != GL_SIGNALED)
+				break;
+
+			glDeleteSync(batch.Fence);
+			for (const std::vector<GLuint>& objects : batch.Objects)
+				m_Deleted += objects.size();
+			Delete(batch.Objects);
+			m_FreeLists.push_back(std::move(batch.Objects));
+			m_InFlight.pop_front();
+		}
+
+		bool empty = true;
+		for (const std::vector<GLuint>& objects : m_Released)
+			empty = empty && objects.empty();
+		if (empty)
+			return;
+
+		Batch& batch = m_InFlight.emplace_back();
+		batch.Objects.swap(m_Released);
+		batch.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		if (!m_FreeLists.empty())
+		{
+			m_Released.swap(m_FreeLists.back());
+			m_FreeLists.pop_back();
+		}
+	}
+
+	void GLDeletionQueue::Delete(ObjectLists& objects)
+	{
+		// One call per type for the whole batch
+		auto& buffers = objects[(size_t)GLResourceType::Buffer];
+		if (!buffers.empty())
+			glDeleteBuffers((GLsizei)buffers.size(), buffers.data());
+
+		auto& vertexArrays = objects[(size_t)GLResourceType::VertexArray];
+		if (!vertexArrays.empty())
+			glDeleteVertexArrays((GLsizei)vertexArrays.size(), vertexArrays.data());
+
+		auto& textures = objects[(size_t)GLResourceType::Texture];
+		if (!textures.empty())
+			glDeleteTextures((GLsizei)textures.size(), textures.data());
+
+		for (GLuint program : objects[(size_t)GLResourceType::Program])
+			glDeleteProgram(program);
+
+		auto& framebuffers = objects[(size_t)GLResourceType::Framebuffer];
+		if (!framebuffers.empty())
+			glDeleteFramebuffers((GLsizei)framebuffers.size(), framebuffers.data());
+
+		for (std::vector<GLuint>& list : objects)
+			list.clear();
+	}
+
+	GLResourceStats GLDeletionQueue::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		GLResourceStats stats;
+		for (size_t type = 0; type < GLResourceTypeCount; type++)
+		{
+			stats.Live[type] = (uint32_t)m_Live[type].size();
+			stats.Pending += (uint32_t)m_Released[type].size();
+			for (const Batch& batch : m_InFlight)
+				stats.Pending += (uint32_t)batch.Objects[type].size();
+		}
+		stats.PendingFrames = (uint32_t)m_InFlight.size();
+		stats.Deleted = m_Deleted;
+		return stats;
+	}
+
+	void GLDeletionQueue::ReportLeaks() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (size_t type = 0; type < GLResourceTypeCount; type++)
+		{
+			const std::unordered_set<GLuint>& live = m_Live[type];
+			if (live.empty())
+				continue;
+
+			std::string ids;
+			size_t listed = 0;
+			for (GLuint id : live)
+			{
+				if (listed++ == 16)
+				{
+					ids += ", ...";
+					break;
+				}
+				ids += (ids.empty() ? "" : ", ") + std::to_string(id);
+			}
+			LOG_WARN("Leaked {0} GL {1} object(s): {2}", live.size(), GetGLResourceTypeName((GLResourceType)type), ids);
+		}
+	}
+
+	GLBuffer CreateGLBuffer()
+	{
+		GLuint id = 0;
+		glCreateBuffers(1, &id);
+		return GLBuffer(id);
+	}
+
+	GLVertexArray CreateGLVertexArray()
+	{
+		GLuint id = 0;
+		glCreateVertexArrays(1, &id);
+		return GLVertexArray(id);
+	}
+
+	GLTexture CreateGLTexture(GLenum target)
+	{
+		GLuint id = 0;
+		glCreateTextures(target, 1, &id);
+		return GLTexture(id);
+	}
+
+	GLProgram CreateGLProgram()
+	{
+		return GLProgram(glCreateProgram());
+	}
+
+	GLFramebuffer CreateGLFramebuffer()
+	{
+		GLuint id = 0;
+		glCreateFramebuffers(1, &id);
+		return GLFramebuffer(id);
+	}
+
+}
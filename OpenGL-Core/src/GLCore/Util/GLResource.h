@@ -0,0 +1,139 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	enum class GLResourceType : uint8_t
+	{
+		Buffer = 0, VertexArray, Texture, Program, Framebuffer
+	};
+	static constexpr size_t GLResourceTypeCount = 5;
+
+	const char* GetGLResourceTypeName(GLResourceType type);
+
+	struct GLResourceStats
+	{
+		std::array<uint32_t, GLResourceTypeCount> Live = {};
+		// Released but waiting for the GPU to finish the frames that used them
+		uint32_t Pending = 0;
+		uint32_t PendingFrames = 0;
+		uint64_t Deleted = 0;
+	};
+
+	// Deletes GL objects once the GPU is done with them. Objects released
+	// during a frame are batched; EndFrame puts a fence behind the batch,
+	// and the batch is deleted on a later EndFrame once that fence has
+	// signaled, so the driver never has to stall on an object still in use.
+	//
+	// Release may be called from any thread. Deletion only happens in
+	// EndFrame and the destructor, on the thread that owns the context.
+	// The destructor waits for the GPU, deletes everything pending and
+	// logs every handle that is still alive.
+	class GLDeletionQueue
+	{
+	public:
+		GLDeletionQueue();
+		~GLDeletionQueue();
+
+		GLDeletionQueue(const GLDeletionQueue&) = delete;
+		GLDeletionQueue& operator=(const GLDeletionQueue&) = delete;
+
+		// After the frame's commands have been submitted
+		void EndFrame();
+
+		GLResourceStats GetStats() const;
+
+		// Without a queue these delete immediately
+		static void Track(GLResourceType type, GLuint id);
+		static void Release(GLResourceType type, GLuint id);
+	private:
+		using ObjectLists = std::array<std::vector<GLuint>, GLResourceTypeCount>;
+
+		struct Batch
+		{
+			ObjectLists Objects;
+			GLsync Fence = nullptr;
+		};
+
+		static void Delete(ObjectLists& objects);
+		void ReportLeaks() const;
+	private:
+		mutable std::mutex m_Mutex;
+		ObjectLists m_Released;
+		std::deque<Batch> m_InFlight;
+		// Emptied batches, kept so steady-state frames don't allocate
+		std::vector<ObjectLists> m_FreeLists;
+		std::array<std::unordered_set<GLuint>, GLResourceTypeCount> m_Live;
+		uint64_t m_Deleted = 0;
+
+		static GLDeletionQueue* s_Instance;
+	};
+
+	// Owns one GL object name. Destroying or resetting the handle hands the
+	// object to the GLDeletionQueue rather than deleting it on the spot.
+	// Converts to GLuint, so it can be passed straight to GL calls.
+	template<GLResourceType Type>
+	class GLHandle
+	{
+	public:
+		GLHandle() = default;
+		// Takes ownership of an existing object
+		explicit GLHandle(GLuint id)
+			: m_ID(id)
+		{
+			GLDeletionQueue::Track(Type, m_ID);
+		}
+		~GLHandle() { GLDeletionQueue::Release(Type, m_ID); }
+
+		GLHandle(const GLHandle&) = delete;
+		GLHandle& operator=(const GLHandle&) = delete;
+
+		GLHandle(GLHandle&& other) noexcept
+			: m_ID(other.m_ID)
+		{
+			other.m_ID = 0;
+		}
+
+		GLHandle& operator=(GLHandle&& other) noexcept
+		{
+			if (this != &other)
+			{
+				GLDeletionQueue::Release(Type, m_ID);
+				m_ID = other.m_ID;
+				other.m_ID = 0;
+			}
+			return *this;
+		}
+
+		inline void Reset()
+		{
+			GLDeletionQueue::Release(Type, m_ID);
+			m_ID = 0;
+		}
+
+		inline GLuint Get() const { return m_ID; }
+		inline operator GLuint() const { return m_ID; }
+	private:
+		GLuint m_ID = 0;
+	};
+
+	using GLBuffer = GLHandle<GLResourceType::Buffer>;
+	using GLVertexArray = GLHandle<GLResourceType::VertexArray>;
+	using GLTexture = GLHandle<GLResourceType::Texture>;
+	using GLProgram = GLHandle<GLResourceType::Program>;
+	using GLFramebuffer = GLHandle<GLResourceType::Framebuffer>;
+
+	GLBuffer CreateGLBuffer();
+	GLVertexArray CreateGLVertexArray();
+	GLTexture CreateGLTexture(GLenum target);
+	GLProgram CreateGLProgram();
+	GLFramebuffer CreateGLFramebuffer();
+
+}
@@ -0,0 +1,133 @@
+#include "glpch.h"
+#include "ImageWriter.h"
+
+#include <array>
+#include <cstdio>
+
+namespace GLCore::Utils {
+
+	static const std::array<uint32_t, 256>& CrcTable()
+	{
+		static const std::array<uint32_t, 256> table = []
+		{
+			std::array<uint32_t, 256> result{};
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t c = i;
+				for (int bit = 0; bit < 8; bit++)
+					c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				result[i] = c;
+			}
+			return result;
+		}();
+		return table;
+	}
+
+	static uint32_t UpdateCrc(uint32_t crc, const uint8_t* data, size_t size)
+	{
+		const std::array<uint32_t, 256>& table = CrcTable();
+		for (size_t i = 0; i < size; i++)
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return crc;
+	}
+
+	static void AppendBigEndian(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back((uint8_t)(value >> 24));
+		out.push_back((uint8_t)(value >> 16));
+		out.push_back((uint8_t)(value >> 8));
+		out.push_back((uint8_t)value);
+	}
+
+	static void AppendChunk(std::vector<uint8_t>& out, const char type[4], const uint8_t* data, size_t size)
+	{
+		AppendBigEndian(out, (uint32_t)size);
+		size_t typeOffset = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data, data + size);
+		// The CRC covers the type and the data, not the length
+		uint32_t crc = UpdateCrc(0xFFFFFFFFu, out.data() + typeOffset, size + 4) ^ 0xFFFFFFFFu;
+		AppendBigEndian(out, crc);
+	}
+
+	bool WritePNG(const std::string& path, uint32_t width, uint32_t height, uint32_t channels, const uint8_t* pixels)
+	{
+		if (width == 0 || height == 0 || (channels != 3 && channels != 4))
+			return false;
+
+		// Every scanline starts with its filter type; 0 leaves the row as is
+		size_t rowSize = (size_t)width * channels;
+		size_t rawSize = (rowSize + 1) * height;
+
+		// zlib stream of stored deflate blocks, each at most 65535 bytes
+		const size_t MaxBlockSize = 65535;
+		size_t blockCount = (rawSize + MaxBlockSize - 1) / MaxBlockSize;
+		std::vector<uint8_t> zlib;
+		zlib.reserve(2 + rawSize + blockCount * 5 + 4);
+		zlib.push_back(0x78);
+		zlib.push_back(0x01);
+
+		uint32_t adlerA = 1, adlerB = 0;
+		size_t blockRemaining = 0, written = 0;
+		auto appendRaw = [&](const uint8_t* data, size_t size)
+		{
+			while (size > 0)
+			{
+				if (blockRemaining == 0)
+				{
+					blockRemaining = std::min(MaxBlockSize, rawSize - written);
+					bool last = written + blockRemaining == rawSize;
+					zlib.push_back(last ? 1 : 0);
+					zlib.push_back((uint8_t)blockRemaining);
+					zlib.push_back((uint8_t)(blockRemaining >> 8));
+					zlib.push_back((uint8_t)~blockRemaining);
+					zlib.push_back((uint8_t)(~blockRemaining >> 8));
+				}
+
+				size_t count = std::min(size, blockRemaining);
+				zlib.insert(zlib.end(), data, data + count);
+				for (size_t i = 0; i < count; i++)
+				{
+					adlerA = (adlerA + data[i]) % 65521;
+					adlerB = (adlerB + adlerA) % 65521;
+				}
+
+				data += count;
+				size -= count;
+				written += count;
+				blockRemaining -= count;
+			}
+		};
+
+		const uint8_t filter = 0;
+		for (uint32_t y = 0; y < height; y++)
+		{
+			appendRaw(&filter, 1);
+			appendRaw(pixels + y * rowSize, rowSize);
+		}
+		AppendBigEndian(zlib, (adlerB << 16) | adlerA);
+
+		uint8_t header[13];
+		header[0] = (uint8_t)(width >> 24); header[1] = (uint8_t)(width >> 16); header[2] = (uint8_t)(width >> 8); header[3] = (uint8_t)width;
+		header[4] = (uint8_t)(height >> 24); header[5] = (uint8_t)(height >> 16); header[6] = (uint8_t)(height >> 8); header[7] = (uint8_t)height;
+		header[8] = 8;                          // Bit depth
+		header[9] = channels == 4 ? 6 : 2;      // Truecolor, with or without alpha
+		header[10] = header[11] = header[12] = 0;
+
+		static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		std::vector<uint8_t> png(signature, signature + 8);
+		png.reserve(8 + 25 + zlib.size() + 12 + 12);
+		AppendChunk(png, "IHDR", header, sizeof(header));
+		AppendChunk(png, "IDAT", zlib.data(), zlib.size());
+		AppendChunk(png, "IEND", nullptr, 0);
+
+		FILE* file = fopen(path.c_str(), "wb");
+		if (!file)
+			return false;
+
+		bool ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+		ok = fclose(file) == 0 && ok;
+		return ok;
+	}
+
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace GLCore::Utils {
+
+	// Writes 8-bit RGB (3 channels) or RGBA (4 channels) pixels, rows top to
+	// bottom, to a PNG file. The image data is stored uncompressed, which
+	// keeps encoding cheap enough for capturing frame sequences.
+	bool WritePNG(const std::string& path, uint32_t width, uint32_t height, uint32_t channels, const uint8_t* pixels);
+
+}
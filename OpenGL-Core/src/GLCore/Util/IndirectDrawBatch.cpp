@@ -0,0 +1,192 @@
+#include "glpch.h"
+#include "IndirectDrawBatch.h"
+
+namespace GLCore::Utils {
+
+	IndirectDrawBatch::IndirectDrawBatch()
+	{
+		m_DrawDataBuffer = CreateGLBuffer();
+		m_DrawIndexBuffer = CreateGLBuffer();
+		m_CommandBuffer = CreateGLBuffer();
+		m_GroupBuffer = CreateGLBuffer();
+		m_CulledDrawIndexBuffer = CreateGLBuffer();
+		m_CulledCommandBuffer = CreateGLBuffer();
+	}
+
+	void IndirectDrawBatch::Begin()
+	{
+		m_Draws.clear();
+		m_DrawData.clear();
+		m_Groups.clear();
+		m_Stats = {};
+	}
+
+	void IndirectDrawBatch::Submit(const MeshDraw& draw, const IndirectDrawData& data)
+	{
+		// There are only ever a few vertex arrays (one per heap page), and
+		// consecutive draws usually share one, so a linear search is enough
+		uint32_t group = m_Groups.empty() ? 0 : m_Draws.back().Group;
+		if (m_Groups.empty() || m_Groups[group].VertexArray != draw.VertexArray)
+		{
+			group = 0;
+			while (group < m_Groups.size() && m_Groups[group].VertexArray != draw.VertexArray)
+				group++;
+			if (group == m_Groups.size())
+				m_Groups.push_back({ draw.VertexArray, 0, 0 });
+		}
+		m_Groups[group].Count++;
+
+		m_Draws.push_back({ draw, group });
+		m_DrawData.push_back(data);
+	}
+
+	void IndirectDrawBatch::BuildCommands()
+	{
+		uint32_t first = 0;
+		for (DrawGroup& group : m_Groups)
+		{
+			group.First = first;
+			first += group.Count;
+		}
+
+		// Counting sort by group keeps submission order within each group
+		m_Commands.resize(m_Draws.size());
+		m_DrawIndices.resize(m_Draws.size());
+		m_GroupCounters.resize(m_Groups.size());
+		for (size_t i = 0; i < m_Groups.size(); i++)
+			m_GroupCounters[i] = { m_Groups[i].First, 0 };
+
+		for (uint32_t i = 0; i < (uint32_t)m_Draws.size(); i++)
+		{
+			const PendingDraw& pending = m_Draws[i];
+			uint32_t slot = m_GroupCounters[pending.Group].First + m_GroupCounters[pending.Group].Count++;
+
+			// BaseInstance carries the group so the cull shader knows where to compact to
+			m_Commands[slot] = { pending.Draw.IndexCount, 1, pending.Draw.FirstIndex, pending.Draw.BaseVertex, pending.Group };
+			m_DrawIndices[slot] = i;
+		}
+
+		m_Stats.Draws = (uint32_t)m_Draws.size();
+		m_Stats.Groups = (uint32_t)m_Groups.size();
+	}
+
+	void IndirectDrawBatch::Reserve(GLBuffer& buffer, size_t& capacity, size_t size)
+	{
+		// Fresh storage each frame, so draws still reading the last batch don't stall the upload
+		if (size > capacity)
+		{
+			capacity = std::max(size, capacity * 2);
+			glNamedBufferData(buffer, capacity, nullptr, GL_STREAM_DRAW);
+		}
+		else
+		{
+			glInvalidateBufferData(buffer);
+		}
+	}
+
+	void IndirectDrawBatch::Upload(GLBuffer& buffer, size_t& capacity, const void* data, size_t size)
+	{
+		Reserve(buffer, capacity, size);
+		glNamedBufferSubData(buffer, 0, size, data);
+		m_Stats.UploadBytes += size;
+	}
+
+	void IndirectDrawBatch::Flush()
+	{
+		if (m_Draws.empty())
+			return;
+
+		BuildCommands();
+		Upload(m_DrawDataBuffer, m_DrawDataCapacity, m_DrawData.data(), m_DrawData.size() * sizeof(IndirectDrawData));
+		Upload(m_DrawIndexBuffer, m_DrawIndexCapacity, m_DrawIndices.data(), m_DrawIndices.size() * sizeof(uint32_t));
+		Upload(m_CommandBuffer, m_CommandCapacity, m_Commands.data(), m_Commands.size() * sizeof(DrawElementsIndirectCommand));
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawDataBinding, m_DrawDataBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawIndexBinding, m_DrawIndexBuffer);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer);
+		DrawGroups(false);
+	}
+
+	void IndirectDrawBatch::FlushCulled(Shader& cullShader, const glm::vec4& viewBounds)
+	{
+		if (m_Draws.empty())
+			return;
+
+		BuildCommands();
+		for (GroupCounter& counter : m_GroupCounters)
+			counter.Count = 0;
+
+		size_t commandSize = m_Commands.size() * sizeof(DrawElementsIndirectCommand);
+		Upload(m_DrawDataBuffer, m_DrawDataCapacity, m_DrawData.data(), m_DrawData.size() * sizeof(IndirectDrawData));
+		Upload(m_DrawIndexBuffer, m_DrawIndexCapacity, m_DrawIndices.data(), m_DrawIndices.size() * sizeof(uint32_t));
+		Upload(m_CommandBuffer, m_CommandCapacity, m_Commands.data(), commandSize);
+		Upload(m_GroupBuffer, m_GroupCapacity, m_GroupCounters.data(), m_GroupCounters.size() * sizeof(GroupCounter));
+		Reserve(m_CulledDrawIndexBuffer, m_CulledDrawIndexCapacity, m_DrawIndices.size() * sizeof(uint32_t));
+		Reserve(m_CulledCommandBuffer, m_CulledCommandCapacity, commandSize);
+
+		// Without a GPU-side draw count every slot is drawn, so the tail the
+		// cull shader leaves unwritten must hold zero-count commands
+		if (!GLAD_GL_VERSION_4_6)
+			glClearNamedBufferSubData(m_CulledCommandBuffer, GL_R32UI, 0, commandSize, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+		GLint program = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawDataBinding, m_DrawDataBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, InputDrawIndexBinding, m_DrawIndexBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, InputCommandBinding, m_CommandBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawIndexBinding, m_CulledDrawIndexBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OutputCommandBinding, m_CulledCommandBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GroupBinding, m_GroupBuffer);
+
+		GLuint cullProgram = cullShader.GetRendererID();
+		glUseProgram(cullProgram);
+		glProgramUniform4f(cullProgram, glGetUniformLocation(cullProgram, "u_ViewBounds"), viewBounds.x, viewBounds.y, viewBounds.z, viewBounds.w);
+		glProgramUniform1ui(cullProgram, glGetUniformLocation(cullProgram, "u_DrawCount"), (GLuint)m_Draws.size());
+		glDispatchCompute(((uint32_t)m_Draws.size() + CullGroupSize - 1) / CullGroupSize, 1, 1);
+		m_Stats.ApiCalls++;
+
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+		glUseProgram(program);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CulledCommandBuffer);
+		DrawGroups(true);
+	}
+
+	void IndirectDrawBatch::DrawGroups(bool culled)
+	{
+		GLint program = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+		GLint firstDrawLocation = glGetUniformLocation(program, "u_FirstDraw");
+
+		bool drawCountFromBuffer = culled && GLAD_GL_VERSION_4_6;
+		if (drawCountFromBuffer)
+			glBindBuffer(GL_PARAMETER_BUFFER, m_GroupBuffer);
+
+		for (size_t i = 0; i < m_Groups.size(); i++)
+		{
+			const DrawGroup& group = m_Groups[i];
+
+			// gl_DrawIDARB restarts at zero for every multi-draw
+			glProgramUniform1ui(program, firstDrawLocation, group.First);
+			glBindVertexArray(group.VertexArray);
+
+			const void* offset = (const void*)(group.First * sizeof(DrawElementsIndirectCommand));
+			if (drawCountFromBuffer)
+			{
+				GLintptr countOffset = i * sizeof(GroupCounter) + offsetof(GroupCounter, Count);
+				glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, offset, countOffset, group.Count, 0);
+			}
+			else
+			{
+				glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, group.Count, 0);
+			}
+			m_Stats.ApiCalls++;
+		}
+
+		if (drawCountFromBuffer)
+			glBindBuffer(GL_PARAMETER_BUFFER, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+}
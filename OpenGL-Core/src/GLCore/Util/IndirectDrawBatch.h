@@ -0,0 +1,124 @@
+#pragma once
+
+#include "GLResource.h"
+#include "MeshHeap.h"
+#include "Shader.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	// The layout glMultiDrawElementsIndirect reads from GL_DRAW_INDIRECT_BUFFER
+	struct DrawElementsIndirectCommand
+	{
+		uint32_t Count;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t BaseInstance;
+	};
+	static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must match the GL layout");
+
+	// Per-draw constants, matching the std430 layout of DrawData in
+	// include/indirect.glsl. The vertex shader finds its entry from gl_DrawIDARB.
+	struct IndirectDrawData
+	{
+		glm::vec4 Transform;  // xy offset, zw scale
+		glm::vec4 Color;
+		glm::vec4 Bounds;     // World-space min xy, max xy; used by the cull shader
+		float Depth;
+		float Padding[3];
+	};
+	static_assert(sizeof(IndirectDrawData) == 64, "IndirectDrawData must match the shader's std430 layout");
+
+	struct IndirectDrawStats
+	{
+		uint32_t Draws = 0;
+		// One glMultiDrawElementsIndirect per vertex array
+		uint32_t Groups = 0;
+		uint32_t ApiCalls = 0;
+		size_t UploadBytes = 0;
+	};
+
+	// Collects MeshHeap draws and issues them as indirect commands from a GPU
+	// buffer, one multi-draw per vertex array. FlushCulled instead runs a
+	// compute shader that tests each draw's bounds against the view and
+	// compacts the survivors, so the CPU never learns how many were drawn.
+	class IndirectDrawBatch
+	{
+	public:
+		static constexpr GLuint DrawDataBinding = 1;
+		static constexpr GLuint DrawIndexBinding = 2;
+		static constexpr GLuint InputCommandBinding = 3;
+		static constexpr GLuint OutputCommandBinding = 4;
+		static constexpr GLuint GroupBinding = 5;
+		static constexpr GLuint InputDrawIndexBinding = 6;
+		static constexpr uint32_t CullGroupSize = 64;
+
+		IndirectDrawBatch();
+
+		IndirectDrawBatch(const IndirectDrawBatch&) = delete;
+		IndirectDrawBatch& operator=(const IndirectDrawBatch&) = delete;
+
+		void Begin();
+		void Submit(const MeshDraw& draw, const IndirectDrawData& data);
+
+		// Draws everything submitted with the bound program, in submission
+		// order within each vertex array
+		void Flush();
+		// Culls against viewBounds (min xy, max xy) on the GPU, then draws the
+		// survivors with the bound program. Compaction doesn't keep submission
+		// order, so this is meant for depth-tested, opaque draws.
+		void FlushCulled(Shader& cullShader, const glm::vec4& viewBounds);
+
+		inline size_t GetDrawCount() const { return m_Draws.size(); }
+		inline const IndirectDrawStats& GetStats() const { return m_Stats; }
+	private:
+		void BuildCommands();
+		void Upload(GLBuffer& buffer, size_t& capacity, const void* data, size_t size);
+		void Reserve(GLBuffer& buffer, size_t& capacity, size_t size);
+		void DrawGroups(bool culled);
+	private:
+		struct PendingDraw
+		{
+			MeshDraw Draw;
+			uint32_t Group;
+		};
+
+		struct DrawGroup
+		{
+			GLuint VertexArray;
+			uint32_t First;
+			uint32_t Count;
+		};
+
+		// The cull shader's view of a group; Count is bumped atomically and
+		// then read as the draw count of glMultiDrawElementsIndirectCount
+		struct GroupCounter
+		{
+			uint32_t First;
+			uint32_t Count;
+		};
+
+		std::vector<PendingDraw> m_Draws;
+		std::vector<IndirectDrawData> m_DrawData;
+
+		// Rebuilt by BuildCommands, in vertex array order
+		std::vector<DrawElementsIndirectCommand> m_Commands;
+		std::vector<uint32_t> m_DrawIndices;
+		std::vector<DrawGroup> m_Groups;
+		std::vector<GroupCounter> m_GroupCounters;
+
+		GLBuffer m_DrawDataBuffer, m_DrawIndexBuffer, m_CommandBuffer, m_GroupBuffer;
+		GLBuffer m_CulledDrawIndexBuffer, m_CulledCommandBuffer;
+		size_t m_DrawDataCapacity = 0, m_DrawIndexCapacity = 0, m_CommandCapacity = 0, m_GroupCapacity = 0;
+		size_t m_CulledDrawIndexCapacity = 0, m_CulledCommandCapacity = 0;
+
+		IndirectDrawStats m_Stats;
+	};
+
+}
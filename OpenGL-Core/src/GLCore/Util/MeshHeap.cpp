@@ -0,0 +1,142 @@
+#include "glpch.h"
+#include "MeshHeap.h"
+
+#include <numeric>
+
+namespace GLCore::Utils {
+
+	MeshHeap::MeshHeap(uint32_t vertexStride, std::vector<VertexAttribute> layout, uint64_t pageSize)
+		: m_Heap(pageSize), m_VertexStride(vertexStride), m_Layout(std::move(layout))
+	{
+		// Ranges start on a whole vertex, so the base vertex is exact, and on
+		// a whole index for the index block that follows
+		m_RangeAlignment = std::lcm<uint64_t>(vertexStride, sizeof(uint32_t));
+	}
+
+	MeshHeap::Mesh MeshHeap::Create(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		MeshRecord record;
+		record.VertexCount = vertexCount;
+		record.IndexCount = indexCount;
+		record.IndexOffset = ((uint64_t)vertexCount * m_VertexStride + sizeof(uint32_t) - 1) / sizeof(uint32_t) * sizeof(uint32_t);
+		record.Allocation = m_Heap.Allocate(record.IndexOffset + (uint64_t)indexCount * sizeof(uint32_t), m_RangeAlignment);
+
+		if (vertices)
+			m_Heap.Upload(record.Allocation, vertices, (uint64_t)vertexCount * m_VertexStride);
+		if (indices)
+			m_Heap.Upload(record.Allocation, indices, (uint64_t)indexCount * sizeof(uint32_t), record.IndexOffset);
+
+		uint32_t index;
+		if (!m_FreeMeshes.empty())
+		{
+			index = m_FreeMeshes.back();
+			m_FreeMeshes.pop_back();
+			m_Meshes[index] = record;
+		}
+		else
+		{
+			index = (uint32_t)m_Meshes.size();
+			m_Meshes.push_back(record);
+		}
+		return index + 1;
+	}
+
+	void MeshHeap::Destroy(Mesh mesh)
+	{
+		if (mesh == InvalidMesh)
+			return;
+
+		MeshRecord& record = m_Meshes[mesh - 1];
+		m_Heap.Free(record.Allocation);
+		record = MeshRecord();
+		m_FreeMeshes.push_back(mesh - 1);
+	}
+
+	void MeshHeap::UpdateVertices(Mesh mesh, const void* vertices, uint32_t vertexCount, uint32_t firstVertex)
+	{
+		const MeshRecord& record = m_Meshes[mesh - 1];
+		GLCORE_ASSERT(firstVertex + vertexCount <= record.VertexCount, "Mesh has fewer vertices");
+		m_Heap.Upload(record.Allocation, vertices, (uint64_t)vertexCount * m_VertexStride, (uint64_t)firstVertex * m_VertexStride);
+	}
+
+	void MeshHeap::UpdateVertexArrays()
+	{
+		if (m_VertexArrayRevision == m_Heap.GetRevision())
+			return;
+
+		// Pages were added or replaced; old vertex arrays go through the deletion queue
+		m_VertexArrays.clear();
+		for (uint32_t page = 0; page < (uint32_t)m_Heap.GetPageCount(); page++)
+		{
+			GLuint buffer = m_Heap.GetPageBuffer(page);
+			GLVertexArray& vertexArray = m_VertexArrays.emplace_back(CreateGLVertexArray());
+			glVertexArrayVertexBuffer(vertexArray, 0, buffer, 0, m_VertexStride);
+			glVertexArrayElementBuffer(vertexArray, buffer);
+			for (const VertexAttribute& attribute : m_Layout)
+			{
+				glEnableVertexArrayAttrib(vertexArray, attribute.Index);
+				glVertexArrayAttribFormat(vertexArray, attribute.Index, attribute.Count, attribute.Type, attribute.Normalized, attribute.Offset);
+				glVertexArrayAttribBinding(vertexArray, attribute.Index, 0);
+			}
+		}
+		m_VertexArrayRevision = m_Heap.GetRevision();
+	}
+
+	MeshDraw MeshHeap::GetDraw(Mesh mesh)
+	{
+		UpdateVertexArrays();
+
+		const MeshRecord& record = m_Meshes[mesh - 1];
+		BufferRange range = m_Heap.GetRange(record.Allocation);
+
+		MeshDraw draw;
+		draw.VertexArray = m_VertexArrays[range.Page];
+		draw.FirstIndex = (uint32_t)((range.Offset + record.IndexOffset) / sizeof(uint32_t));
+		draw.IndexCount = record.IndexCount;
+		draw.BaseVertex = (int32_t)(range.Offset / m_VertexStride);
+		return draw;
+	}
+
+	void MeshHeap::Draw(Mesh mesh)
+	{
+		MeshDraw draw = GetDraw(mesh);
+		glBindVertexArray(draw.VertexArray);
+		glDrawElementsBaseVertex(GL_TRIANGLES, draw.IndexCount, GL_UNSIGNED_INT,
+			(const void*)((uint64_t)draw.FirstIndex * sizeof(uint32_t)), draw.BaseVertex);
+	}
+
+	void MeshHeap::Draw(const Mesh* meshes, size_t count)
+	{
+		// Meshes in the same page share a vertex array
+		m_Batch.clear();
+		for (size_t i = 0; i < count; i++)
+			m_Batch.push_back(GetDraw(meshes[i]));
+		std::sort(m_Batch.begin(), m_Batch.end(), [](const MeshDraw& a, const MeshDraw& b) { return a.VertexArray < b.VertexArray; });
+
+		for (size_t start = 0; start < m_Batch.size();)
+		{
+			size_t end = start;
+			m_Counts.clear();
+			m_Offsets.clear();
+			m_BaseVertices.clear();
+			for (; end < m_Batch.size() && m_Batch[end].VertexArray == m_Batch[start].VertexArray; end++)
+			{
+				const MeshDraw& draw = m_Batch[end];
+				m_Counts.push_back((GLsizei)draw.IndexCount);
+				m_Offsets.push_back((const void*)((uint64_t)draw.FirstIndex * sizeof(uint32_t)));
+				m_BaseVertices.push_back(draw.BaseVertex);
+			}
+
+			glBindVertexArray(m_Batch[start].VertexArray);
+			glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_Counts.data(), GL_UNSIGNED_INT, m_Offsets.data(),
+				(GLsizei)m_Counts.size(), m_BaseVertices.data());
+			start = end;
+		}
+	}
+
+	uint64_t MeshHeap::Defragment()
+	{
+		return m_Heap.Defragment();
+	}
+
+}
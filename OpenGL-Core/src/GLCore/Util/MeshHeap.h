@@ -0,0 +1,88 @@
+#pragma once
+
+#include "BufferHeap.h"
+
+#include <vector>
+
+namespace GLCore::Utils {
+
+	struct VertexAttribute
+	{
+		GLuint Index;
+		GLint Count;
+		GLenum Type;
+		GLuint Offset;
+		GLboolean Normalized = GL_FALSE;
+	};
+
+	// Everything needed to draw one mesh with glDrawElementsBaseVertex
+	struct MeshDraw
+	{
+		GLuint VertexArray = 0;
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+		int32_t BaseVertex = 0;
+	};
+
+	// Indexed meshes with one vertex layout, packed into a BufferHeap. Each
+	// mesh is a single range holding its vertices followed by its 32-bit
+	// indices, so a page buffer is both the vertex and the element buffer
+	// and every mesh in a page draws from the same vertex array.
+	class MeshHeap
+	{
+	public:
+		using Mesh = uint32_t;
+		static constexpr Mesh InvalidMesh = 0;
+
+		MeshHeap(uint32_t vertexStride, std::vector<VertexAttribute> layout, uint64_t pageSize = 4 * 1024 * 1024);
+
+		MeshHeap(const MeshHeap&) = delete;
+		MeshHeap& operator=(const MeshHeap&) = delete;
+
+		// Vertices may be null to upload them later with UpdateVertices
+		Mesh Create(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+		void Destroy(Mesh mesh);
+
+		void UpdateVertices(Mesh mesh, const void* vertices, uint32_t vertexCount, uint32_t firstVertex = 0);
+
+		// Only valid until the heap is defragmented or grows a page
+		MeshDraw GetDraw(Mesh mesh);
+		void Draw(Mesh mesh);
+		// One glMultiDrawElementsBaseVertex per page the meshes live in
+		void Draw(const Mesh* meshes, size_t count);
+
+		uint64_t Defragment();
+
+		inline BufferHeapStats GetStats() const { return m_Heap.GetStats(); }
+		inline size_t GetMeshCount() const { return m_Meshes.size() - m_FreeMeshes.size(); }
+	private:
+		void UpdateVertexArrays();
+	private:
+		struct MeshRecord
+		{
+			BufferHeap::Allocation Allocation = BufferHeap::InvalidAllocation;
+			uint32_t VertexCount = 0;
+			uint32_t IndexCount = 0;
+			// Bytes from the start of the range
+			uint64_t IndexOffset = 0;
+		};
+
+		BufferHeap m_Heap;
+		uint32_t m_VertexStride;
+		uint64_t m_RangeAlignment;
+		std::vector<VertexAttribute> m_Layout;
+
+		std::vector<GLVertexArray> m_VertexArrays;
+		uint32_t m_VertexArrayRevision = ~0u;
+
+		std::vector<MeshRecord> m_Meshes;
+		std::vector<uint32_t> m_FreeMeshes;
+
+		// Reused by Draw
+		std::vector<MeshDraw> m_Batch;
+		std::vector<GLsizei> m_Counts;
+		std::vector<const void*> m_Offsets;
+		std::vector<GLint> m_BaseVertices;
+	};
+
+}
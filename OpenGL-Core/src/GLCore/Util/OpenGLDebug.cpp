@@ -1,16 +1,30 @@
 #include "glpch.h"
 #include "OpenGLDebug.h"
 
+#include <mutex>
+
 namespace GLCore::Utils {
 
 	static DebugLogLevel s_DebugLogLevel = DebugLogLevel::HighAssert;
+	static DebugOutputMode s_DebugOutputMode = DebugOutputMode::Synchronous;
+
+	struct AggregatedMessage
+	{
+		GLDebugMessageStats Stats;
+		uint32_t FrameCount = 0;
+		std::string Text;
+	};
+
+	// The callback may run on a driver thread in aggregated mode
+	static std::mutex s_AggregateMutex;
+	static std::unordered_map<uint64_t, AggregatedMessage> s_AggregatedMessages;
 
 	void SetGLDebugLogLevel(DebugLogLevel level)
 	{
 		s_DebugLogLevel = level;
 	}
 
-	void OpenGLLogMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+	static void LogDebugMessage(GLenum severity, const GLchar* message, bool allowAssert)
 	{
 		switch (severity)
 		{
@@ -18,7 +32,7 @@ namespace GLCore::Utils {
 			if ((int)s_DebugLogLevel > 0)
 			{
 				LOG_ERROR("[OpenGL Debug HIGH] {0}", message);
-				if (s_DebugLogLevel == DebugLogLevel::HighAssert)
+				if (allowAssert && s_DebugLogLevel == DebugLogLevel::HighAssert)
 					GLCORE_ASSERT(false, "GL_DEBUG_SEVERITY_HIGH");
 			}
 			break;
@@ -37,11 +51,142 @@ namespace GLCore::Utils {
 		}
 	}
 
-	void EnableGLDebugging()
+	static void AggregateMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message)
+	{
+		uint64_t key = ((uint64_t)(source & 0xFFFF) << 48) | ((uint64_t)(type & 0xFFFF) << 32) | id;
+
+		bool firstOccurrence = false;
+		{
+			std::lock_guard<std::mutex> lock(s_AggregateMutex);
+			auto [it, inserted] = s_AggregatedMessages.try_emplace(key);
+			AggregatedMessage& entry = it->second;
+			if (inserted)
+			{
+				entry.Stats.Source = source;
+				entry.Stats.Type = type;
+				entry.Stats.ID = id;
+				entry.Stats.Severity = severity;
+				entry.Text = length >= 0 ? std::string(message, length) : std::string(message);
+				entry.Stats.Message = entry.Text.c_str();
+				firstOccurrence = true;
+			}
+			entry.FrameCount++;
+			entry.Stats.TotalCount++;
+		}
+
+		// Repeats are only counted; they show up in the report instead of the log
+		if (firstOccurrence)
+			LogDebugMessage(severity, message, false);
+	}
+
+	void OpenGLLogMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+	{
+		if (s_DebugOutputMode == DebugOutputMode::Aggregated)
+			AggregateMessage(source, type, id, severity, length, message);
+		else
+			LogDebugMessage(severity, message, true);
+	}
+
+	void EnableGLDebugging(DebugOutputMode mode)
 	{
+		s_DebugOutputMode = mode;
+
 		glDebugMessageCallback(OpenGLLogMessage, nullptr);
 		glEnable(GL_DEBUG_OUTPUT);
-		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		if (mode == DebugOutputMode::Synchronous)
+			glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		else
+			glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	}
+
+	void NewGLDebugFrame()
+	{
+		if (s_DebugOutputMode != DebugOutputMode::Aggregated)
+			return;
+
+		std::lock_guard<std::mutex> lock(s_AggregateMutex);
+		for (auto& [key, entry] : s_AggregatedMessages)
+		{
+			entry.Stats.LastFrameCount = entry.FrameCount;
+			entry.Stats.PeakFrameCount = std::max(entry.Stats.PeakFrameCount, entry.FrameCount);
+			entry.FrameCount = 0;
+		}
+	}
+
+	void GetGLDebugReport(std::vector<GLDebugMessageStats>& out, size_t maxCount, GLenum type)
+	{
+		out.clear();
+		{
+			std::lock_guard<std::mutex> lock(s_AggregateMutex);
+			for (auto& [key, entry] : s_AggregatedMessages)
+			{
+				if (type == GL_DONT_CARE || entry.Stats.Type == type)
+					out.push_back(entry.Stats);
+			}
+		}
+
+		auto moreFrequent = [](const GLDebugMessageStats& a, const GLDebugMessageStats& b)
+		{
+			if (a.LastFrameCount != b.LastFrameCount)
+				return a.LastFrameCount > b.LastFrameCount;
+			return a.TotalCount > b.TotalCount;
+		};
+
+		if (out.size() > maxCount)
+		{
+			std::partial_sort(out.begin(), out.begin() + maxCount, out.end(), moreFrequent);
+			out.resize(maxCount);
+		}
+		else
+		{
+			std::sort(out.begin(), out.end(), moreFrequent);
+		}
+	}
+
+	void LogGLDebugReport(size_t maxCount)
+	{
+		std::vector<GLDebugMessageStats> report;
+		GetGLDebugReport(report, maxCount);
+		if (report.empty())
+			return;
+
+		LOG_WARN("OpenGL debug report (top {0} messages):", report.size());
+		for (const auto& stats : report)
+		{
+			LOG_WARN("  {0}x total, {1}/frame peak [{2} {3} {4}] {5}", stats.TotalCount, stats.PeakFrameCount,
+				GLDebugSourceName(stats.Source), GLDebugTypeName(stats.Type), stats.ID, stats.Message);
+		}
+	}
+
+	const char* GLDebugSourceName(GLenum source)
+	{
+		switch (source)
+		{
+		case GL_DEBUG_SOURCE_API:             return "API";
+		case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "Window System";
+		case GL_DEBUG_SOURCE_SHADER_COMPILER: return "Shader Compiler";
+		case GL_DEBUG_SOURCE_THIRD_PARTY:     return "Third Party";
+		case GL_DEBUG_SOURCE_APPLICATION:     return "Application";
+		case GL_DEBUG_SOURCE_OTHER:           return "Other";
+		}
+		return "Unknown";
+	}
+
+	const char* GLDebugTypeName(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_DEBUG_TYPE_ERROR:               return "Error";
+		case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "Deprecated";
+		case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "Undefined";
+		case GL_DEBUG_TYPE_PORTABILITY:         return "Portability";
+		case GL_DEBUG_TYPE_PERFORMANCE:         return "Performance";
+		case GL_DEBUG_TYPE_MARKER:              return "Marker";
+		case GL_DEBUG_TYPE_PUSH_GROUP:          return "Push Group";
+		case GL_DEBUG_TYPE_POP_GROUP:           return "Pop Group";
+		case GL_DEBUG_TYPE_OTHER:               return "Other";
+		}
+		return "Unknown";
 	}
 
 }
\ No newline at end of file
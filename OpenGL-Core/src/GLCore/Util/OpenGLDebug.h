@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include <vector>
+
 #include "GLCore/Core/Log.h"
 
 namespace GLCore::Utils {
@@ -11,8 +13,36 @@ namespace GLCore::Utils {
 		None = 0, HighAssert = 1, High = 2, Medium = 3, Low = 4, Notification = 5
 	};
 
-	void EnableGLDebugging();
+	enum class DebugOutputMode
+	{
+		// Every message is logged from the driver callback on the offending call
+		Synchronous = 0,
+		// Driver may report asynchronously; messages are deduplicated by
+		// (source, type, id), logged once and counted per frame
+		Aggregated
+	};
+
+	struct GLDebugMessageStats
+	{
+		GLenum Source = 0, Type = 0, Severity = 0;
+		GLuint ID = 0;
+		uint32_t LastFrameCount = 0, PeakFrameCount = 0;
+		uint64_t TotalCount = 0;
+		const char* Message = nullptr; // Text of the first occurrence, valid while debugging is enabled
+	};
+
+	void EnableGLDebugging(DebugOutputMode mode = DebugOutputMode::Synchronous);
 	void SetGLDebugLogLevel(DebugLogLevel level);
 	void OpenGLLogMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam);
 
+	// Closes the current frame's per-message counters. Called once per frame by the application.
+	void NewGLDebugFrame();
+	// Fills 'out' with the most frequent aggregated messages, ordered by last frame's count
+	// then total count. Pass a type (e.g. GL_DEBUG_TYPE_PERFORMANCE) to filter, or GL_DONT_CARE.
+	void GetGLDebugReport(std::vector<GLDebugMessageStats>& out, size_t maxCount, GLenum type = GL_DONT_CARE);
+	void LogGLDebugReport(size_t maxCount = 10);
+
+	const char* GLDebugSourceName(GLenum source);
+	const char* GLDebugTypeName(GLenum type);
+
 }
\ No newline at end of file
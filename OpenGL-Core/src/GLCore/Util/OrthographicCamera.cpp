@@ -3,27 +3,76 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cfloat>
+
 namespace GLCore::Utils {
 
+	// Revision 0 is never handed out, so it can mean "no camera"
+	static uint64_t s_NextRevision = 1;
+
 	OrthographicCamera::OrthographicCamera(float left, float right, float bottom, float top)
 		: m_ProjectionMatrix(glm::ortho(left, right, bottom, top, -1.0f, 1.0f)), m_ViewMatrix(1.0f)
 	{
 		m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
+		m_Revision = s_NextRevision++;
 	}
 
 	void OrthographicCamera::SetProjection(float left, float right, float bottom, float top)
 	{
 		m_ProjectionMatrix = glm::ortho(left, right, bottom, top, -1.0f, 1.0f);
 		m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
+		m_Revision = s_NextRevision++;
 	}
 
-	void OrthographicCamera::RecalculateViewMatrix()
+	void OrthographicCamera::SetPosition(const glm::vec3& position)
+	{
+		if (position == m_Position)
+			return;
+
+		m_Position = position;
+		InvalidateView();
+	}
+
+	void OrthographicCamera::SetRotation(float rotation)
+	{
+		if (rotation == m_Rotation)
+			return;
+
+		m_Rotation = rotation;
+		InvalidateView();
+	}
+
+	void OrthographicCamera::InvalidateView()
+	{
+		m_ViewDirty = true;
+		m_Revision = s_NextRevision++;
+	}
+
+	void OrthographicCamera::RecalculateViewMatrix() const
 	{
 		glm::mat4 transform = glm::translate(glm::mat4(1.0f), m_Position) *
 			glm::rotate(glm::mat4(1.0f), glm::radians(m_Rotation), glm::vec3(0, 0, 1));
 
 		m_ViewMatrix = glm::inverse(transform);
 		m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
+		m_ViewDirty = false;
+	}
+
+	glm::vec4 OrthographicCamera::GetWorldBounds() const
+	{
+		glm::mat4 inverse = glm::inverse(GetViewProjectionMatrix());
+
+		glm::vec4 bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+		const glm::vec2 corners[] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+		for (const glm::vec2& corner : corners)
+		{
+			glm::vec4 world = inverse * glm::vec4(corner.x, corner.y, 0.0f, 1.0f);
+			bounds.x = std::min(bounds.x, world.x);
+			bounds.y = std::min(bounds.y, world.y);
+			bounds.z = std::max(bounds.z, world.x);
+			bounds.w = std::max(bounds.w, world.y);
+		}
+		return bounds;
 	}
 
 }
\ No newline at end of file
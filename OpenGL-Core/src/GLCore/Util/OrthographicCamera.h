@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
+
 namespace GLCore::Utils {
 
 	class OrthographicCamera
@@ -12,20 +14,32 @@ namespace GLCore::Utils {
 		void SetProjection(float left, float right, float bottom, float top);
 
 		const glm::vec3& GetPosition() const { return m_Position; }
-		void SetPosition(const glm::vec3& position) { m_Position = position; RecalculateViewMatrix(); }
+		void SetPosition(const glm::vec3& position);
 
 		float GetRotation() const { return m_Rotation; }
-		void SetRotation(float rotation) { m_Rotation = rotation; RecalculateViewMatrix(); }
+		void SetRotation(float rotation);
 
+		// The view matrices are recalculated on first use after a change
 		const glm::mat4& GetProjectionMatrix() const { return m_ProjectionMatrix; }
-		const glm::mat4& GetViewMatrix() const { return m_ViewMatrix; }
-		const glm::mat4& GetViewProjectionMatrix() const { return m_ViewProjectionMatrix; }
+		const glm::mat4& GetViewMatrix() const { UpdateViewMatrix(); return m_ViewMatrix; }
+		const glm::mat4& GetViewProjectionMatrix() const { UpdateViewMatrix(); return m_ViewProjectionMatrix; }
+
+		// Changes whenever any matrix changes. Unique across all cameras, so
+		// it can be cached to skip re-uploading matrices that are unchanged.
+		uint64_t GetRevision() const { return m_Revision; }
+
+		// World-space rect covered by the view as (min x, min y, max x, max y)
+		glm::vec4 GetWorldBounds() const;
 	private:
-		void RecalculateViewMatrix();
+		void InvalidateView();
+		void UpdateViewMatrix() const { if (m_ViewDirty) RecalculateViewMatrix(); }
+		void RecalculateViewMatrix() const;
 	private:
 		glm::mat4 m_ProjectionMatrix;
-		glm::mat4 m_ViewMatrix;
-		glm::mat4 m_ViewProjectionMatrix;
+		mutable glm::mat4 m_ViewMatrix;
+		mutable glm::mat4 m_ViewProjectionMatrix;
+		mutable bool m_ViewDirty = false;
+		uint64_t m_Revision = 0;
 
 		glm::vec3 m_Position = { 0.0f, 0.0f, 0.0f };
 		float m_Rotation = 0.0f;
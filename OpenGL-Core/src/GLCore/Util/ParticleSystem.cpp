@@ -0,0 +1,285 @@
+#include "glpch.h"
+#include "ParticleSystem.h"
+#include "SpriteBatch.h"
+
+#include "GLCore/Core/FrameClock.h"
+
+// SSE2 is part of every x64 target; anything else takes the scalar loop
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define GLCORE_PARTICLES_SSE 1
+	#include <emmintrin.h>
+#endif
+
+namespace GLCore::Utils {
+
+	// Instance attributes, in the order their arrays sit in the instance buffer
+	enum ParticleAttribute : GLuint
+	{
+		PositionXAttribute, PositionYAttribute, SizeXAttribute, SizeYAttribute, LifeAttribute, ColorAttribute,
+		ParticleAttributeCount
+	};
+
+	ParticleSystem::ParticleSystem(uint32_t capacity, JobSystem* jobSystem)
+		: m_Capacity(capacity), m_JobSystem(jobSystem)
+	{
+		for (std::vector<float>* array : { &m_PositionX, &m_PositionY, &m_VelocityX, &m_VelocityY, &m_Gravity,
+			&m_SizeX, &m_SizeY, &m_Growth, &m_Life, &m_LifeRate })
+			array->resize(capacity);
+		m_Color.resize(capacity);
+		m_FreeList.reserve(capacity);
+
+		// Every array is 4 bytes per particle
+		size_t arraySize = (size_t)capacity * sizeof(float);
+		m_InstanceBuffer = CreateGLBuffer();
+		glNamedBufferData(m_InstanceBuffer, arraySize * ParticleAttributeCount, nullptr, GL_STREAM_DRAW);
+
+		m_VertexArray = CreateGLVertexArray();
+		for (GLuint attribute = 0; attribute < ParticleAttributeCount; attribute++)
+		{
+			glVertexArrayVertexBuffer(m_VertexArray, attribute, m_InstanceBuffer, attribute * arraySize, sizeof(float));
+			glVertexArrayBindingDivisor(m_VertexArray, attribute, 1);
+			glEnableVertexArrayAttrib(m_VertexArray, attribute);
+			if (attribute == ColorAttribute)
+				glVertexArrayAttribFormat(m_VertexArray, attribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0);
+			else
+				glVertexArrayAttribFormat(m_VertexArray, attribute, 1, GL_FLOAT, GL_FALSE, 0);
+			glVertexArrayAttribBinding(m_VertexArray, attribute, attribute);
+		}
+	}
+
+	float ParticleSystem::Random()
+	{
+		// xorshift32; quality is plenty for visual spread
+		m_RandomState ^= m_RandomState << 13;
+		m_RandomState ^= m_RandomState >> 17;
+		m_RandomState ^= m_RandomState << 5;
+		return (m_RandomState >> 8) / (float)(1u << 24);
+	}
+
+#ifdef GLCORE_PARTICLES_SSE
+	// Four xorshift32 streams side by side, mapped to [0, 1) like Random
+	static __m128 Random4(__m128i& state)
+	{
+		state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+		state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+		state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+		return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(state, 8)), _mm_set1_ps(1.0f / (1u << 24)));
+	}
+#endif
+
+	uint32_t ParticleSystem::Emit(const ParticleProps& props, uint32_t count)
+	{
+		uint32_t color = SpriteBatch::PackColor(props.Color);
+
+		// Free-list slots are scattered, so they are filled one at a time
+		uint32_t emitted = 0;
+		for (; emitted < count && !m_FreeList.empty(); emitted++)
+		{
+			EmitSlot(props, color, m_FreeList.back());
+			m_FreeList.pop_back();
+		}
+
+		// The rest extend the high-water mark, one contiguous run
+		uint32_t first = m_HighWater;
+		uint32_t run = std::min(count - emitted, m_Capacity - m_HighWater);
+		uint32_t i = 0;
+#ifdef GLCORE_PARTICLES_SSE
+		__m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_RandomLanes.data()));
+		auto spread = [&state](float base, float variation)
+		{
+			return _mm_add_ps(_mm_set1_ps(base), _mm_mul_ps(_mm_set1_ps(variation), _mm_sub_ps(Random4(state), _mm_set1_ps(0.5f))));
+		};
+		for (; i + 4 <= run; i += 4)
+		{
+			uint32_t slot = first + i;
+			_mm_storeu_ps(&m_PositionX[slot], spread(props.Position.x, props.PositionVariation.x));
+			_mm_storeu_ps(&m_PositionY[slot], spread(props.Position.y, props.PositionVariation.y));
+			_mm_storeu_ps(&m_VelocityX[slot], spread(props.Velocity.x, props.VelocityVariation.x));
+			_mm_storeu_ps(&m_VelocityY[slot], spread(props.Velocity.y, props.VelocityVariation.y));
+			_mm_storeu_ps(&m_Gravity[slot], _mm_set1_ps(props.Gravity));
+
+			__m128 sizeScale = spread(1.0f, props.SizeVariation);
+			_mm_storeu_ps(&m_SizeX[slot], _mm_mul_ps(_mm_set1_ps(props.Size.x), sizeScale));
+			_mm_storeu_ps(&m_SizeY[slot], _mm_mul_ps(_mm_set1_ps(props.Size.y), sizeScale));
+			_mm_storeu_ps(&m_Growth[slot], _mm_set1_ps(props.Growth));
+
+			__m128 lifetime = _mm_max_ps(spread(props.Lifetime, props.LifetimeVariation), _mm_set1_ps(0.001f));
+			_mm_storeu_ps(&m_Life[slot], _mm_set1_ps(1.0f));
+			_mm_storeu_ps(&m_LifeRate[slot], _mm_div_ps(_mm_set1_ps(1.0f), lifetime));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&m_Color[slot]), _mm_set1_epi32((int)color));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(m_RandomLanes.data()), state);
+#endif
+		for (; i < run; i++)
+			EmitSlot(props, color, first + i);
+		m_HighWater += run;
+		emitted += run;
+
+		m_EmittedSinceUpdate += emitted;
+		return emitted;
+	}
+
+	void ParticleSystem::EmitSlot(const ParticleProps& props, uint32_t color, uint32_t slot)
+	{
+		m_PositionX[slot] = props.Position.x + props.PositionVariation.x * (Random() - 0.5f);
+		m_PositionY[slot] = props.Position.y + props.PositionVariation.y * (Random() - 0.5f);
+		m_VelocityX[slot] = props.Velocity.x + props.VelocityVariation.x * (Random() - 0.5f);
+		m_VelocityY[slot] = props.Velocity.y + props.VelocityVariation.y * (Random() - 0.5f);
+		m_Gravity[slot] = props.Gravity;
+
+		float sizeScale = 1.0f + props.SizeVariation * (Random() - 0.5f);
+		m_SizeX[slot] = props.Size.x * sizeScale;
+		m_SizeY[slot] = props.Size.y * sizeScale;
+		m_Growth[slot] = props.Growth;
+
+		float lifetime = std::max(props.Lifetime + props.LifetimeVariation * (Random() - 0.5f), 0.001f);
+		m_Life[slot] = 1.0f;
+		m_LifeRate[slot] = 1.0f / lifetime;
+		m_Color[slot] = color;
+	}
+
+	void ParticleSystem::UpdateRange(uint32_t first, uint32_t count, float dt, std::vector<uint32_t>& killed)
+	{
+		float* positionX = m_PositionX.data() + first;
+		float* positionY = m_PositionY.data() + first;
+		const float* velocityX = m_VelocityX.data() + first;
+		float* velocityY = m_VelocityY.data() + first;
+		const float* gravity = m_Gravity.data() + first;
+		float* sizeX = m_SizeX.data() + first;
+		float* sizeY = m_SizeY.data() + first;
+		const float* growth = m_Growth.data() + first;
+		float* life = m_Life.data() + first;
+		float* lifeRate = m_LifeRate.data() + first;
+
+		// Free slots are updated too; it's cheaper than branching around them,
+		// and Emit overwrites everything when a slot is reused
+		uint32_t i = 0;
+#ifdef GLCORE_PARTICLES_SSE
+		const __m128 step = _mm_set1_ps(dt);
+		const __m128 zero = _mm_setzero_ps();
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 vy = _mm_add_ps(_mm_loadu_ps(velocityY + i), _mm_mul_ps(_mm_loadu_ps(gravity + i), step));
+			_mm_storeu_ps(velocityY + i, vy);
+			_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(_mm_loadu_ps(velocityX + i), step)));
+			_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, step)));
+
+			__m128 grow = _mm_mul_ps(_mm_loadu_ps(growth + i), step);
+			_mm_storeu_ps(sizeX + i, _mm_max_ps(_mm_add_ps(_mm_loadu_ps(sizeX + i), grow), zero));
+			_mm_storeu_ps(sizeY + i, _mm_max_ps(_mm_add_ps(_mm_loadu_ps(sizeY + i), grow), zero));
+
+			__m128 rate = _mm_loadu_ps(lifeRate + i);
+			__m128 remaining = _mm_sub_ps(_mm_loadu_ps(life + i), _mm_mul_ps(rate, step));
+			_mm_storeu_ps(life + i, remaining);
+
+			// Newly dead: out of life but still owned; usually no lane is
+			int dead = _mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(remaining, zero), _mm_cmpgt_ps(rate, zero)));
+			while (dead)
+			{
+				uint32_t lane = dead & 1 ? 0 : dead & 2 ? 1 : dead & 4 ? 2 : 3;
+				dead &= dead - 1;
+				lifeRate[i + lane] = 0.0f;
+				killed.push_back(first + i + lane);
+			}
+		}
+#endif
+		for (; i < count; i++)
+		{
+			velocityY[i] += gravity[i] * dt;
+			positionX[i] += velocityX[i] * dt;
+			positionY[i] += velocityY[i] * dt;
+			sizeX[i] = std::max(sizeX[i] + growth[i] * dt, 0.0f);
+			sizeY[i] = std::max(sizeY[i] + growth[i] * dt, 0.0f);
+
+			life[i] -= lifeRate[i] * dt;
+			if (life[i] <= 0.0f && lifeRate[i] > 0.0f)
+			{
+				lifeRate[i] = 0.0f;
+				killed.push_back(first + i);
+			}
+		}
+	}
+
+	void ParticleSystem::Update(Timestep ts)
+	{
+		uint64_t start = FrameClock::Now();
+		float dt = ts;
+
+		uint32_t chunkCount = (m_HighWater + ChunkSize - 1) / ChunkSize;
+		if (m_Killed.size() < chunkCount)
+			m_Killed.resize(chunkCount);
+
+		auto updateChunk = [this, dt](uint32_t chunk)
+		{
+			uint32_t first = chunk * ChunkSize;
+			m_Killed[chunk].clear();
+			UpdateRange(first, std::min(ChunkSize, m_HighWater - first), dt, m_Killed[chunk]);
+		};
+
+		if (m_Parallel && m_JobSystem && chunkCount > 1)
+		{
+			m_JobSystem->ParallelFor(chunkCount, updateChunk);
+		}
+		else
+		{
+			for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+				updateChunk(chunk);
+		}
+
+		uint32_t killed = 0;
+		for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+		{
+			m_FreeList.insert(m_FreeList.end(), m_Killed[chunk].begin(), m_Killed[chunk].end());
+			killed += (uint32_t)m_Killed[chunk].size();
+		}
+
+		// Once everything is dead the pool starts over from the front
+		if (GetLiveCount() == 0)
+		{
+			m_HighWater = 0;
+			m_FreeList.clear();
+		}
+
+		m_Stats.Live = GetLiveCount();
+		m_Stats.Capacity = m_Capacity;
+		m_Stats.HighWater = m_HighWater;
+		m_Stats.Emitted = m_EmittedSinceUpdate;
+		m_Stats.Killed = killed;
+		m_Stats.UpdateMilliseconds = (FrameClock::Now() - start) * 1e-6;
+		m_EmittedSinceUpdate = 0;
+	}
+
+	void ParticleSystem::Clear()
+	{
+		m_HighWater = 0;
+		m_FreeList.clear();
+		m_Stats.Live = 0;
+		m_Stats.HighWater = 0;
+	}
+
+	void ParticleSystem::Render()
+	{
+		uint32_t highWater = m_HighWater;
+		if (highWater == 0)
+		{
+			m_Stats.UploadBytes = 0;
+			return;
+		}
+
+		// The arrays go up as they are; free slots draw as degenerate quads
+		size_t arraySize = (size_t)m_Capacity * sizeof(float);
+		size_t uploadSize = (size_t)highWater * sizeof(float);
+		const void* arrays[ParticleAttributeCount] = {
+			m_PositionX.data(), m_PositionY.data(), m_SizeX.data(), m_SizeY.data(), m_Life.data(), m_Color.data()
+		};
+
+		glInvalidateBufferData(m_InstanceBuffer);
+		for (GLuint attribute = 0; attribute < ParticleAttributeCount; attribute++)
+			glNamedBufferSubData(m_InstanceBuffer, attribute * arraySize, uploadSize, arrays[attribute]);
+		m_Stats.UploadBytes = uploadSize * ParticleAttributeCount;
+
+		glBindVertexArray(m_VertexArray);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, highWater);
+	}
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "GLResource.h"
+#include "GLCore/Core/JobSystem.h"
+#include "GLCore/Core/Timestep.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	// How new particles start out. Variations are the full width of a uniform
+	// random spread around the base value.
+	struct ParticleProps
+	{
+		glm::vec2 Position = { 0.0f, 0.0f }, PositionVariation = { 0.0f, 0.0f };
+		glm::vec2 Velocity = { 0.0f, 0.0f }, VelocityVariation = { 0.0f, 0.0f };
+		// Vertical acceleration; negative rises in the village's y-down space
+		float Gravity = 0.0f;
+		glm::vec2 Size = { 1.0f, 1.0f };
+		float SizeVariation = 0.0f;   // Fraction of Size
+		float Growth = 0.0f;          // Size change per second, both axes
+		glm::vec4 Color = { 1.0f, 1.0f, 1.0f, 1.0f };
+		float Lifetime = 1.0f, LifetimeVariation = 0.0f;
+	};
+
+	struct ParticleStats
+	{
+		uint32_t Live = 0;
+		uint32_t Capacity = 0;
+		// Slots the update and draw walk, live or not
+		uint32_t HighWater = 0;
+		// Since the previous update
+		uint32_t Emitted = 0;
+		uint32_t Killed = 0;
+		double UpdateMilliseconds = 0.0;
+		size_t UploadBytes = 0;
+	};
+
+	// A fixed-capacity particle pool stored as structure of arrays, so the
+	// update streams through one attribute at a time four lanes wide. Dead
+	// slots go on a free list and are refilled by Emit before the pool grows
+	// past its high-water mark; slots past it are filled four at a time.
+	// Updates can be split across the JobSystem.
+	// Particles are drawn as instanced quads straight from the arrays.
+	class ParticleSystem
+	{
+	public:
+		// Particles per update job
+		static constexpr uint32_t ChunkSize = 64 * 1024;
+
+		ParticleSystem(uint32_t capacity, JobSystem* jobSystem = nullptr);
+
+		ParticleSystem(const ParticleSystem&) = delete;
+		ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+		// Returns how many were emitted, which is fewer than count once the pool is full
+		uint32_t Emit(const ParticleProps& props, uint32_t count);
+		void Update(Timestep ts);
+		void Clear();
+
+		// Draws every live particle with the bound program as one instanced
+		// triangle strip; see particle.vert.glsl for the attributes
+		void Render();
+
+		inline void SetParallel(bool parallel) { m_Parallel = parallel; }
+		inline bool IsParallel() const { return m_Parallel; }
+
+		inline uint32_t GetLiveCount() const { return m_HighWater - (uint32_t)m_FreeList.size(); }
+		inline uint32_t GetCapacity() const { return m_Capacity; }
+		inline const ParticleStats& GetStats() const { return m_Stats; }
+	private:
+		void UpdateRange(uint32_t first, uint32_t count, float dt, std::vector<uint32_t>& killed);
+		void EmitSlot(const ParticleProps& props, uint32_t color, uint32_t slot);
+		float Random();
+	private:
+		uint32_t m_Capacity;
+		uint32_t m_HighWater = 0;
+		JobSystem* m_JobSystem;
+		bool m_Parallel = true;
+		uint32_t m_RandomState = 0x9E3779B9u;
+		// One stream per lane for the four-wide emit
+		std::array<uint32_t, 4> m_RandomLanes = { 0x7F4A7C15u, 0x85EBCA6Bu, 0xC2B2AE35u, 0x27D4EB2Fu };
+		uint32_t m_EmittedSinceUpdate = 0;
+
+		// One array per attribute, each m_Capacity long. Life runs from 1 down
+		// to 0 at LifeRate per second; a LifeRate of 0 marks a free slot.
+		std::vector<float> m_PositionX, m_PositionY;
+		std::vector<float> m_VelocityX, m_VelocityY;
+		std::vector<float> m_Gravity;
+		std::vector<float> m_SizeX, m_SizeY, m_Growth;
+		std::vector<float> m_Life, m_LifeRate;
+		std::vector<uint32_t> m_Color;   // RGBA unorm8, red in the low byte
+
+		std::vector<uint32_t> m_FreeList;
+		// One list of newly dead slots per update chunk, merged after the update
+		std::vector<std::vector<uint32_t>> m_Killed;
+
+		// The drawn arrays, back to back, each m_Capacity long
+		GLBuffer m_InstanceBuffer;
+		GLVertexArray m_VertexArray;
+
+		ParticleStats m_Stats;
+	};
+
+}
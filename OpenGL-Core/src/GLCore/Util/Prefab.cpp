@@ -0,0 +1,113 @@
+#include "glpch.h"
+#include "Prefab.h"
+
+#include <cfloat>
+
+namespace GLCore::Utils {
+
+	Prefab::Prefab(const std::vector<PrefabVertex>& vertices, const std::vector<uint32_t>& indices)
+		: m_IndexCount((uint32_t)indices.size()), m_Bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX)
+	{
+		for (const PrefabVertex& vertex : vertices)
+		{
+			m_Bounds.x = std::min(m_Bounds.x, vertex.Position.x);
+			m_Bounds.y = std::min(m_Bounds.y, vertex.Position.y);
+			m_Bounds.z = std::max(m_Bounds.z, vertex.Position.x);
+			m_Bounds.w = std::max(m_Bounds.w, vertex.Position.y);
+		}
+
+		m_VertexArray = CreateGLVertexArray();
+		glBindVertexArray(m_VertexArray);
+
+		m_VertexBuffer = CreateGLBuffer();
+		glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(PrefabVertex), vertices.data(), GL_STATIC_DRAW);
+
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PrefabVertex), (const void*)offsetof(PrefabVertex, Position));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(PrefabVertex), (const void*)offsetof(PrefabVertex, Color));
+
+		// The instance buffer is allocated on the first Prepare, but the
+		// attribute layout only needs a buffer name
+		m_InstanceBuffer = CreateGLBuffer();
+		glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer);
+
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(PrefabInstance), (const void*)offsetof(PrefabInstance, Position));
+		glVertexAttribDivisor(2, 1);
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(PrefabInstance), (const void*)offsetof(PrefabInstance, Scale));
+		glVertexAttribDivisor(3, 1);
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(PrefabInstance), (const void*)offsetof(PrefabInstance, Tint));
+		glVertexAttribDivisor(4, 1);
+
+		m_IndexBuffer = CreateGLBuffer();
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+
+		glBindVertexArray(0);
+	}
+
+	uint32_t Prefab::Prepare(const glm::vec4& worldBounds)
+	{
+		m_Visible.clear();
+		m_Visible.reserve(m_Instances.size());
+
+		for (const PrefabInstance& instance : m_Instances)
+		{
+			// Scale may be negative to mirror the mesh, so sort the corners
+			float x0 = instance.Position.x + m_Bounds.x * instance.Scale.x;
+			float x1 = instance.Position.x + m_Bounds.z * instance.Scale.x;
+			float y0 = instance.Position.y + m_Bounds.y * instance.Scale.y;
+			float y1 = instance.Position.y + m_Bounds.w * instance.Scale.y;
+
+			if (std::max(x0, x1) < worldBounds.x || std::min(x0, x1) > worldBounds.z
+				|| std::max(y0, y1) < worldBounds.y || std::min(y0, y1) > worldBounds.w)
+				continue;
+
+			m_Visible.push_back(instance);
+		}
+		m_VisibleCount = (uint32_t)m_Visible.size();
+
+		if (m_VisibleCount == 0)
+			return 0;
+
+		// Both paths hand the driver fresh storage, so draws still reading last
+		// frame's instances never stall the upload
+		if (m_VisibleCount > m_InstanceCapacity)
+		{
+			m_InstanceCapacity = std::max<size_t>(m_VisibleCount, m_InstanceCapacity * 2);
+			glNamedBufferData(m_InstanceBuffer, m_InstanceCapacity * sizeof(PrefabInstance), nullptr, GL_STREAM_DRAW);
+		}
+		else
+		{
+			glInvalidateBufferData(m_InstanceBuffer);
+		}
+		glNamedBufferSubData(m_InstanceBuffer, 0, m_VisibleCount * sizeof(PrefabInstance), m_Visible.data());
+
+		return m_VisibleCount;
+	}
+
+	void Prefab::Draw() const
+	{
+		if (m_VisibleCount == 0)
+			return;
+
+		glBindVertexArray(m_VertexArray);
+		glDrawElementsInstanced(GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr, m_VisibleCount);
+	}
+
+	DrawItem Prefab::GetDrawItem(uint64_t key, GLuint shader) const
+	{
+		DrawItem item;
+		item.Key = key;
+		item.VertexArray = m_VertexArray;
+		item.Shader = shader;
+		item.IndexCount = m_IndexCount;
+		item.InstanceCount = m_VisibleCount;
+		return item;
+	}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "DrawQueue.h"
+#include "GLResource.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace GLCore::Utils {
+
+	struct PrefabVertex
+	{
+		glm::vec3 Position;
+		glm::vec4 Color;
+	};
+
+	// Per-copy data, read by the vertex shader once per instance
+	struct PrefabInstance
+	{
+		glm::vec3 Position;
+		glm::vec2 Scale = { 1.0f, 1.0f };
+		glm::vec4 Tint = { 1.0f, 1.0f, 1.0f, 1.0f };
+	};
+
+	// Geometry that is uploaded once and drawn many times with
+	// glDrawElementsInstanced. Instances are kept on the CPU; every frame the
+	// ones overlapping the view are compacted into the instance buffer with a
+	// single upload, so any number of copies costs one draw call.
+	//
+	// Vertex attributes: 0 = position (vec3), 1 = color (vec4),
+	// 2 = instance position (vec3), 3 = instance scale (vec2), 4 = instance tint (vec4)
+	class Prefab
+	{
+	public:
+		Prefab(const std::vector<PrefabVertex>& vertices, const std::vector<uint32_t>& indices);
+
+		Prefab(const Prefab&) = delete;
+		Prefab& operator=(const Prefab&) = delete;
+
+		inline std::vector<PrefabInstance>& GetInstances() { return m_Instances; }
+		inline const std::vector<PrefabInstance>& GetInstances() const { return m_Instances; }
+
+		// Culls instances against a world-space rect given as (min x, min y, max x, max y)
+		// and uploads the visible ones. Returns the number of visible instances.
+		uint32_t Prepare(const glm::vec4& worldBounds);
+
+		// Draws the instances kept by the last Prepare call
+		void Draw() const;
+		DrawItem GetDrawItem(uint64_t key, GLuint shader) const;
+
+		inline GLuint GetVertexArray() const { return m_VertexArray; }
+		inline uint32_t GetIndexCount() const { return m_IndexCount; }
+		inline uint32_t GetVisibleCount() const { return m_VisibleCount; }
+		// Local-space bounds of the mesh as (min x, min y, max x, max y)
+		inline const glm::vec4& GetBounds() const { return m_Bounds; }
+	private:
+		GLVertexArray m_VertexArray;
+		GLBuffer m_VertexBuffer, m_IndexBuffer, m_InstanceBuffer;
+		uint32_t m_IndexCount = 0;
+		glm::vec4 m_Bounds;
+
+		std::vector<PrefabInstance> m_Instances;
+		std::vector<PrefabInstance> m_Visible;
+		size_t m_InstanceCapacity = 0;
+		uint32_t m_VisibleCount = 0;
+	};
+
+}
@@ -1,41 +1,18 @@
 #include "glpch.h"
 #include "Shader.h"
 
-#include <fstream>
+#include "ShaderPreprocessor.h"
 
 namespace GLCore::Utils {
 
-	static std::string ReadFileAsString(const std::string& filepath)
-	{
-		std::string result;
-		std::ifstream in(filepath, std::ios::in | std::ios::binary);
-		if (in)
-		{
-			in.seekg(0, std::ios::end);
-			result.resize((size_t)in.tellg());
-			in.seekg(0, std::ios::beg);
-			in.read(&result[0], result.size());
-			in.close();
-		}
-		else
-		{
-			LOG_ERROR("Could not open file '{0}'", filepath);
-		}
-
-		return result;
-	}
-
-	Shader::~Shader()
-	{
-		glDeleteProgram(m_RendererID);
-	}
-
-	GLuint Shader::CompileShader(GLenum type, const std::string& source)
+	GLuint Shader::CompileShader(GLenum type, std::string_view source)
 	{
 		GLuint shader = glCreateShader(type);
 
-		const GLchar* sourceCStr = source.c_str();
-		glShaderSource(shader, 1, &sourceCStr, 0);
+		// Sources aren't null-terminated when they point into a pack
+		const GLchar* sourceData = source.data();
+		GLint sourceLength = (GLint)source.size();
+		glShaderSource(shader, 1, &sourceData, &sourceLength);
 
 		glCompileShader(shader);
 
@@ -58,25 +35,42 @@ namespace GLCore::Utils {
 		return shader;
 	}
 
-	Shader* Shader::FromGLSLTextFiles(const std::string& vertexShaderPath, const std::string& fragmentShaderPath)
+	Ref<Shader> Shader::FromGLSLTextFiles(const std::string& vertexShaderPath, const std::string& fragmentShaderPath)
 	{
-		Shader* shader = new Shader();
-		shader->LoadFromGLSLTextFiles(vertexShaderPath, fragmentShaderPath);
+		ShaderPreprocessor preprocessor(&VirtualFileSystem::ReadLooseFile);
+		std::string vertexSource, fragmentSource;
+		if (!preprocessor.Process(vertexShaderPath, {}, vertexSource) || !preprocessor.Process(fragmentShaderPath, {}, fragmentSource))
+			return nullptr;
+
+		return FromGLSLSource(vertexSource, fragmentSource);
+	}
+
+	Ref<Shader> Shader::FromGLSLSource(std::string_view vertexSource, std::string_view fragmentSource)
+	{
+		// The constructor is private, so make_shared can't be used
+		Ref<Shader> shader(new Shader());
+		shader->Link({ { GL_VERTEX_SHADER, vertexSource }, { GL_FRAGMENT_SHADER, fragmentSource } });
+		return shader;
+	}
+
+	Ref<Shader> Shader::FromGLSLComputeSource(std::string_view computeSource)
+	{
+		Ref<Shader> shader(new Shader());
+		shader->Link({ { GL_COMPUTE_SHADER, computeSource } });
 		return shader;
 	}
 	
-	void Shader::LoadFromGLSLTextFiles(const std::string& vertexShaderPath, const std::string& fragmentShaderPath)
+	void Shader::Link(std::initializer_list<std::pair<GLenum, std::string_view>> stages)
 	{
-		std::string vertexSource = ReadFileAsString(vertexShaderPath);
-		std::string fragmentSource = ReadFileAsString(fragmentShaderPath);
+		GLProgram program = CreateGLProgram();
 
-		GLuint program = glCreateProgram();
-		int glShaderIDIndex = 0;
-			
-		GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
-		glAttachShader(program, vertexShader);
-		GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
-		glAttachShader(program, fragmentShader);
+		std::vector<GLuint> shaders;
+		for (const auto& [type, source] : stages)
+		{
+			GLuint shader = CompileShader(type, source);
+			glAttachShader(program, shader);
+			shaders.push_back(shader);
+		}
 
 		glLinkProgram(program);
 
@@ -90,21 +84,21 @@ namespace GLCore::Utils {
 			std::vector<GLchar> infoLog(maxLength);
 			glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
 
-			glDeleteProgram(program);
-
-			glDeleteShader(vertexShader);
-			glDeleteShader(fragmentShader);
+			for (GLuint shader : shaders)
+				glDeleteShader(shader);
 
 			LOG_ERROR("{0}", infoLog.data());
 			// HZ_CORE_ASSERT(false, "Shader link failure!");
+			return;
 		}
 		
-		glDetachShader(program, vertexShader);
-		glDetachShader(program, fragmentShader);
-		glDeleteShader(vertexShader);
-		glDeleteShader(fragmentShader);
+		for (GLuint shader : shaders)
+		{
+			glDetachShader(program, shader);
+			glDeleteShader(shader);
+		}
 
-		m_RendererID = program;
+		m_Program = std::move(program);
 	}
 
 }
\ No newline at end of file
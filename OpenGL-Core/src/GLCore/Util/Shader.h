@@ -1,6 +1,11 @@
 #pragma once
 
+#include "../Core/Core.h"
+#include "GLResource.h"
+
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include <glad/glad.h>
 
@@ -9,18 +14,19 @@ namespace GLCore::Utils {
 	class Shader
 	{
 	public:
-		~Shader();
-
-		GLuint GetRendererID() { return m_RendererID; }
+		GLuint GetRendererID() { return m_Program; }
 
-		static Shader* FromGLSLTextFiles(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+		// Null when a file can't be read or preprocessed
+		static Ref<Shader> FromGLSLTextFiles(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+		static Ref<Shader> FromGLSLSource(std::string_view vertexSource, std::string_view fragmentSource);
+		static Ref<Shader> FromGLSLComputeSource(std::string_view computeSource);
 	private:
 		Shader() = default;
 
-		void LoadFromGLSLTextFiles(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
-		GLuint CompileShader(GLenum type, const std::string& source);
+		void Link(std::initializer_list<std::pair<GLenum, std::string_view>> stages);
+		GLuint CompileShader(GLenum type, std::string_view source);
 	private:
-		GLuint m_RendererID;
+		GLProgram m_Program;
 	};
 
-}
\ No newline at end of file
+}
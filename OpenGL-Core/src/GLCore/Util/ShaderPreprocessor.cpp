@@ -0,0 +1,208 @@
+#include "glpch.h"
+#include "ShaderPreprocessor.h"
+
+namespace GLCore::Utils {
+
+	static constexpr uint32_t MaxIncludeDepth = 16;
+
+	static std::string_view TrimLeft(std::string_view text)
+	{
+		size_t start = text.find_first_not_of(" \t");
+		return start == std::string_view::npos ? std::string_view() : text.substr(start);
+	}
+
+	// Matches "#<directive>" with optional whitespace after the hash
+	static bool IsDirective(std::string_view line, std::string_view directive, std::string_view& rest)
+	{
+		line = TrimLeft(line);
+		if (line.empty() || line[0] != '#')
+			return false;
+
+		line = TrimLeft(line.substr(1));
+		if (line.compare(0, directive.size(), directive) != 0)
+			return false;
+
+		rest = line.substr(directive.size());
+		return rest.empty() || rest[0] == ' ' || rest[0] == '\t' || rest[0] == '"' || rest[0] == '<' || rest[0] == '\r';
+	}
+
+	static std::string GetDirectory(const std::string& path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+	}
+
+	// Folds "dir/../" so the same file reached two ways is only included once
+	static std::string CollapsePath(const std::string& path)
+	{
+		std::vector<std::string_view> parts;
+		std::string_view rest = path;
+		while (!rest.empty())
+		{
+			size_t slash = rest.find_first_of("/\\");
+			std::string_view part = rest.substr(0, slash);
+			if (part == "..")
+			{
+				if (!parts.empty() && parts.back() != "..")
+					parts.pop_back();
+				else
+					parts.push_back(part);
+			}
+			else if (!part.empty() && part != ".")
+			{
+				parts.push_back(part);
+			}
+			rest = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+		}
+
+		std::string result = !path.empty() && (path[0] == '/' || path[0] == '\\') ? "/" : "";
+		for (std::string_view part : parts)
+		{
+			if (!result.empty() && result.back() != '/')
+				result += '/';
+			result += part;
+		}
+		return result;
+	}
+
+	ShaderPreprocessor::ShaderPreprocessor(ReadFileFn readFile)
+		: m_ReadFile(std::move(readFile))
+	{
+	}
+
+	uint64_t ShaderPreprocessor::Hash(std::string_view text, uint64_t seed)
+	{
+		// FNV-1a
+		uint64_t hash = seed;
+		for (char c : text)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	bool ShaderPreprocessor::Process(const std::string& path, const std::vector<std::string>& defines, std::string& result)
+	{
+		m_Files.clear();
+		std::string expanded;
+		if (!Expand(CollapsePath(path), 0, expanded))
+			return false;
+
+		result = InjectDefines(expanded, defines);
+		return true;
+	}
+
+	bool ShaderPreprocessor::Expand(const std::string& path, uint32_t depth, std::string& result)
+	{
+		if (depth > MaxIncludeDepth)
+		{
+			LOG_ERROR("Shader includes nest too deeply at '{0}'", path);
+			return false;
+		}
+
+		if (std::find(m_Files.begin(), m_Files.end(), path) != m_Files.end())
+			return true;
+
+		FileData file = m_ReadFile(path);
+		if (!file)
+		{
+			LOG_ERROR("Could not open shader file '{0}'", path);
+			return false;
+		}
+
+		uint32_t fileIndex = (uint32_t)m_Files.size();
+		m_Files.push_back(path);
+
+		std::string_view source = file.GetText();
+		uint32_t lineNumber = 0;
+		bool resync = depth > 0;
+		while (!source.empty())
+		{
+			size_t end = source.find('\n');
+			std::string_view line = source.substr(0, end);
+			source = end == std::string_view::npos ? std::string_view() : source.substr(end + 1);
+			lineNumber++;
+
+			std::string_view rest;
+			if (IsDirective(line, "version", rest))
+			{
+				if (depth > 0)
+				{
+					LOG_ERROR("{0}({1}): #version is only allowed in the root file", path, lineNumber);
+					return false;
+				}
+				result.append(line);
+				result += '\n';
+				continue;
+			}
+
+			if (!IsDirective(line, "include", rest))
+			{
+				if (resync)
+				{
+					result += "#line " + std::to_string(lineNumber) + ' ' + std::to_string(fileIndex) + '\n';
+					resync = false;
+				}
+				result.append(line);
+				result += '\n';
+				continue;
+			}
+
+			rest = TrimLeft(rest);
+			char close = !rest.empty() && rest[0] == '<' ? '>' : '"';
+			size_t nameEnd = rest.size() > 1 ? rest.find(close, 1) : std::string_view::npos;
+			if (rest.empty() || (rest[0] != '"' && rest[0] != '<') || nameEnd == std::string_view::npos)
+			{
+				LOG_ERROR("{0}({1}): malformed #include", path, lineNumber);
+				return false;
+			}
+
+			std::string includePath = CollapsePath(GetDirectory(path) + std::string(rest.substr(1, nameEnd - 1)));
+			if (!Expand(includePath, depth + 1, result))
+				return false;
+			resync = true;
+		}
+		return true;
+	}
+
+	std::string ShaderPreprocessor::InjectDefines(std::string_view source, const std::vector<std::string>& defines)
+	{
+		if (defines.empty())
+			return std::string(source);
+
+		// #version must stay the first directive, so defines go right after it
+		size_t insertAt = 0;
+		std::string_view scan = source;
+		size_t offset = 0;
+		while (!scan.empty())
+		{
+			size_t end = scan.find('\n');
+			std::string_view line = scan.substr(0, end);
+			std::string_view rest;
+			size_t next = end == std::string_view::npos ? scan.size() : end + 1;
+			if (IsDirective(line, "version", rest))
+			{
+				insertAt = offset + next;
+				break;
+			}
+			offset += next;
+			scan = scan.substr(next);
+		}
+
+		std::string result;
+		result.reserve(source.size() + defines.size() * 32);
+		result.append(source.substr(0, insertAt));
+		if (insertAt > 0 && result.back() != '\n')
+			result += '\n';
+		for (const std::string& define : defines)
+			result += "#define " + define + '\n';
+
+		// Keep line numbers of the original source
+		if (insertAt > 0)
+			result += "#line " + std::to_string(std::count(source.begin(), source.begin() + insertAt, '\n') + 1) + " 0\n";
+		result.append(source.substr(insertAt));
+		return result;
+	}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../Core/VirtualFileSystem.h"
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	// Expands a GLSL file before it is handed to the driver:
+	//   #include "path"  is replaced by the file, resolved relative to the
+	//                    including file. Each file is pasted at most once
+	//                    per stage, so shared blocks need no guards.
+	//   defines          are inserted right after #version, as "NAME" or
+	//                    "NAME VALUE".
+	// #line directives keep compiler errors pointing at the right line; the
+	// source string number is the file's index in GetFiles.
+	class ShaderPreprocessor
+	{
+	public:
+		using ReadFileFn = std::function<FileData(const std::string&)>;
+
+		ShaderPreprocessor(ReadFileFn readFile);
+
+		// Returns false and logs if a file is missing or an include is malformed
+		bool Process(const std::string& path, const std::vector<std::string>& defines, std::string& result);
+
+		// Files read by the last Process call, the root file first
+		inline const std::vector<std::string>& GetFiles() const { return m_Files; }
+
+		// Inserts defines after the #version line of an already expanded source
+		static std::string InjectDefines(std::string_view source, const std::vector<std::string>& defines);
+		static uint64_t Hash(std::string_view text, uint64_t seed = 14695981039346656037ull);
+	private:
+		bool Expand(const std::string& path, uint32_t depth, std::string& result);
+	private:
+		ReadFileFn m_ReadFile;
+		std::vector<std::string> m_Files;
+	};
+
+}
@@ -0,0 +1,62 @@
+#include "glpch.h"
+#include "ShaderVariants.h"
+#include "ShaderPreprocessor.h"
+#include "AssetManager.h"
+
+namespace GLCore::Utils {
+
+	ShaderVariants::ShaderVariants(AssetManager& assets, std::string vertexSource, std::string fragmentSource, std::vector<std::string> keywords)
+		: m_Assets(assets), m_VertexSource(std::move(vertexSource)), m_FragmentSource(std::move(fragmentSource)), m_Keywords(std::move(keywords))
+	{
+		GLCORE_ASSERT(m_Keywords.size() <= MaxKeywords, "Too many shader keywords");
+
+		// Keywords change which bit means what, so they are part of the identity
+		m_SourceHash = ShaderPreprocessor::Hash(m_VertexSource);
+		m_SourceHash = ShaderPreprocessor::Hash(m_FragmentSource, m_SourceHash ^ 0x9e3779b97f4a7c15ull);
+		for (const std::string& keyword : m_Keywords)
+			m_SourceHash = ShaderPreprocessor::Hash(keyword, m_SourceHash ^ 0x9e3779b97f4a7c15ull);
+	}
+
+	uint32_t ShaderVariants::GetKeywordBit(std::string_view keyword) const
+	{
+		for (size_t i = 0; i < m_Keywords.size(); i++)
+		{
+			if (m_Keywords[i] == keyword)
+				return 1u << i;
+		}
+
+		LOG_ERROR("Shader has no keyword '{0}'", keyword);
+		return 0;
+	}
+
+	uint32_t ShaderVariants::GetMask(std::initializer_list<std::string_view> keywords) const
+	{
+		uint32_t mask = 0;
+		for (std::string_view keyword : keywords)
+			mask |= GetKeywordBit(keyword);
+		return mask;
+	}
+
+	std::vector<std::string> ShaderVariants::GetDefines(uint32_t mask) const
+	{
+		std::vector<std::string> defines;
+		for (size_t i = 0; i < m_Keywords.size(); i++)
+		{
+			if (mask & (1u << i))
+				defines.push_back(m_Keywords[i] + " 1");
+		}
+		return defines;
+	}
+
+	Ref<Shader> ShaderVariants::Get(uint32_t mask)
+	{
+		auto it = m_Programs.find(mask);
+		if (it != m_Programs.end())
+			return it->second;
+
+		Ref<Shader> shader = m_Assets.GetProgram(*this, mask);
+		m_Programs[mask] = shader;
+		return shader;
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	class AssetManager;
+
+	// One preprocessed vertex/fragment pair and the keywords it can be
+	// specialized on. Each combination of keywords is a separate program,
+	// compiled with "#define KEYWORD 1" the first time it is asked for, so
+	// fragment shaders branch at compile time instead of per pixel.
+	class ShaderVariants
+	{
+	public:
+		static constexpr uint32_t MaxKeywords = 32;
+
+		// Bit for a keyword, or 0 (and an error) if the shader doesn't have it
+		uint32_t GetKeywordBit(std::string_view keyword) const;
+		uint32_t GetMask(std::initializer_list<std::string_view> keywords) const;
+
+		// Compiles the permutation on first use
+		Ref<Shader> Get(uint32_t mask = 0);
+
+		inline uint64_t GetSourceHash() const { return m_SourceHash; }
+		inline const std::vector<std::string>& GetKeywords() const { return m_Keywords; }
+		inline size_t GetCompiledCount() const { return m_Programs.size(); }
+	private:
+		ShaderVariants(AssetManager& assets, std::string vertexSource, std::string fragmentSource, std::vector<std::string> keywords);
+
+		std::vector<std::string> GetDefines(uint32_t mask) const;
+	private:
+		AssetManager& m_Assets;
+		std::string m_VertexSource, m_FragmentSource;
+		std::vector<std::string> m_Keywords;
+		uint64_t m_SourceHash = 0;
+		std::unordered_map<uint32_t, Ref<Shader>> m_Programs;
+
+		friend class AssetManager;
+	};
+
+}
@@ -0,0 +1,65 @@
+#include "glpch.h"
+#include "SpriteBatch.h"
+
+namespace GLCore::Utils {
+
+	SpriteBatch::SpriteBatch()
+	{
+		m_StorageBuffer = CreateGLBuffer();
+		// Nothing is read from it, but core profile requires a bound vertex array
+		m_VertexArray = CreateGLVertexArray();
+	}
+
+	void SpriteBatch::Begin()
+	{
+		m_Sprites.clear();
+	}
+
+	void SpriteBatch::Submit(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, float depth, const glm::vec4& uvRect)
+	{
+		SpriteRecord& sprite = m_Sprites.emplace_back();
+		sprite.Position = position;
+		sprite.Size = size;
+		sprite.UVMin = PackUV(uvRect.x, uvRect.y);
+		sprite.UVMax = PackUV(uvRect.z, uvRect.w);
+		sprite.Color = PackColor(color);
+		sprite.Depth = depth;
+	}
+
+	void SpriteBatch::Flush()
+	{
+		if (m_Sprites.empty())
+			return;
+
+		// Fresh storage each frame, so draws still reading the last batch don't stall the upload
+		size_t size = GetUploadSize();
+		if (size > m_Capacity)
+		{
+			m_Capacity = std::max(size, m_Capacity * 2);
+			glNamedBufferData(m_StorageBuffer, m_Capacity, nullptr, GL_STREAM_DRAW);
+		}
+		else
+		{
+			glInvalidateBufferData(m_StorageBuffer);
+		}
+		glNamedBufferSubData(m_StorageBuffer, 0, size, m_Sprites.data());
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, StorageBinding, m_StorageBuffer);
+		glBindVertexArray(m_VertexArray);
+		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(m_Sprites.size() * 6));
+	}
+
+	uint32_t SpriteBatch::PackColor(const glm::vec4& color)
+	{
+		auto channel = [](float value) { return (uint32_t)(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+		return channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16) | (channel(color.w) << 24);
+	}
+
+	uint32_t SpriteBatch::PackUV(float u, float v)
+	{
+		uint32_t x = (uint32_t)(glm::clamp(u, 0.0f, 1.0f) * 65535.0f + 0.5f);
+		uint32_t y = (uint32_t)(glm::clamp(v, 0.0f, 1.0f) * 65535.0f + 0.5f);
+		return x | (y << 16);
+	}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "GLResource.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	// One sprite as the vertex shader reads it, matching the std430 layout of
+	// the Sprite struct in sprite.vert.glsl. 32 bytes, versus four 40-byte
+	// vertices and six indices for a CPU-built quad.
+	struct SpriteRecord
+	{
+		glm::vec2 Position;
+		glm::vec2 Size;
+		uint32_t UVMin;  // 2x unorm16
+		uint32_t UVMax;  // 2x unorm16
+		uint32_t Color;  // RGBA unorm8, red in the low byte
+		float Depth;     // World-space z
+	};
+	static_assert(sizeof(SpriteRecord) == 32, "SpriteRecord must match the shader's std430 layout");
+
+	// Sprites are uploaded to a shader storage buffer and expanded into quads
+	// by the vertex shader from gl_VertexID, so there are no vertex or index
+	// buffers. The shader reads the records from StorageBinding.
+	class SpriteBatch
+	{
+	public:
+		static constexpr GLuint StorageBinding = 0;
+
+		SpriteBatch();
+
+		SpriteBatch(const SpriteBatch&) = delete;
+		SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+		void Begin();
+		inline void Submit(const SpriteRecord& sprite) { m_Sprites.push_back(sprite); }
+		void Submit(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color,
+			float depth = 0.0f, const glm::vec4& uvRect = { 0.0f, 0.0f, 1.0f, 1.0f });
+
+		// Uploads the submitted sprites and draws them with the bound program
+		void Flush();
+
+		inline size_t GetSpriteCount() const { return m_Sprites.size(); }
+		inline size_t GetUploadSize() const { return m_Sprites.size() * sizeof(SpriteRecord); }
+
+		static uint32_t PackColor(const glm::vec4& color);
+		static uint32_t PackUV(float u, float v);
+	private:
+		std::vector<SpriteRecord> m_Sprites;
+		GLBuffer m_StorageBuffer;
+		GLVertexArray m_VertexArray;
+		size_t m_Capacity = 0;
+	};
+
+}
@@ -0,0 +1,195 @@
+#include "glpch.h"
+#include "TiledLighting.h"
+
+#include "GLCore/Core/FrameClock.h"
+
+namespace GLCore::Utils {
+
+	static FramebufferSpecification AccumulationSpecification()
+	{
+		// Half floats so overlapping lights can add up past 1
+		FramebufferSpecification spec;
+		spec.ColorFormat = GL_RGBA16F;
+		spec.DepthAttachment = false;
+		spec.Filter = GL_LINEAR;
+		return spec;
+	}
+
+	TiledLighting::TiledLighting(uint32_t downscale, uint32_t tileSize)
+		: m_Downscale(std::max(downscale, 1u)), m_TileSize(std::max(tileSize, 1u)), m_Framebuffer(AccumulationSpecification())
+	{
+		m_QuadVA = CreateGLVertexArray();
+		m_LightBuffer = CreateGLBuffer();
+		m_TileBuffer = CreateGLBuffer();
+		m_LightIndexBuffer = CreateGLBuffer();
+	}
+
+	void TiledLighting::Begin()
+	{
+		m_Lights.clear();
+	}
+
+	void TiledLighting::Bin(uint32_t width, uint32_t height, const glm::mat4& viewProjection)
+	{
+		uint32_t targetWidth = (width + m_Downscale - 1) / m_Downscale;
+		uint32_t targetHeight = (height + m_Downscale - 1) / m_Downscale;
+		m_TileCountX = (targetWidth + m_TileSize - 1) / m_TileSize;
+		m_TileCountY = (targetHeight + m_TileSize - 1) / m_TileSize;
+
+		// World to target pixels, with y up like gl_FragCoord
+		glm::vec2 scale = { 0.5f * targetWidth, 0.5f * targetHeight };
+		float radiusScale = std::abs(viewProjection[0][0]) * scale.x;
+		float tileScale = 1.0f / m_TileSize;
+
+		m_TargetLights.clear();
+		m_TileRects.clear();
+		for (const PointLight& light : m_Lights)
+		{
+			glm::vec4 clip = viewProjection * glm::vec4(light.Position.x, light.Position.y, 0.0f, 1.0f);
+			glm::vec2 position = { (clip.x + 1.0f) * scale.x, (clip.y + 1.0f) * scale.y };
+			float radius = light.Radius * radiusScale;
+
+			float minX = (position.x - radius) * tileScale, maxX = (position.x + radius) * tileScale;
+			float minY = (position.y - radius) * tileScale, maxY = (position.y + radius) * tileScale;
+			if (maxX < 0.0f || maxY < 0.0f || minX >= m_TileCountX || minY >= m_TileCountY || radius <= 0.0f)
+				continue;
+
+			m_TargetLights.push_back({ position, radius, 0.0f, glm::vec4(light.Color, 1.0f) });
+			m_TileRects.push_back({
+				(uint16_t)std::max(minX, 0.0f), (uint16_t)std::max(minY, 0.0f),
+				(uint16_t)std::min(maxX, m_TileCountX - 1.0f), (uint16_t)std::min(maxY, m_TileCountY - 1.0f) });
+		}
+
+		// Count, prefix sum, then scatter, so the lists are one flat array
+		m_Tiles.assign((size_t)m_TileCountX * m_TileCountY, { 0, 0 });
+		for (const TileRect& rect : m_TileRects)
+		{
+			for (uint32_t y = rect.MinY; y <= rect.MaxY; y++)
+				for (uint32_t x = rect.MinX; x <= rect.MaxX; x++)
+					m_Tiles[y * m_TileCountX + x].Count++;
+		}
+
+		uint32_t offset = 0, maxCount = 0;
+		for (TileRange& tile : m_Tiles)
+		{
+			tile.Offset = offset;
+			offset += tile.Count;
+			maxCount = std::max(maxCount, tile.Count);
+			tile.Count = 0;
+		}
+
+		m_LightIndices.resize(offset);
+		for (uint32_t light = 0; light < (uint32_t)m_TileRects.size(); light++)
+		{
+			const TileRect& rect = m_TileRects[light];
+			for (uint32_t y = rect.MinY; y <= rect.MaxY; y++)
+			{
+				for (uint32_t x = rect.MinX; x <= rect.MaxX; x++)
+				{
+					TileRange& tile = m_Tiles[y * m_TileCountX + x];
+					m_LightIndices[tile.Offset + tile.Count++] = light;
+				}
+			}
+		}
+
+		m_Framebuffer.Resize(targetWidth, targetHeight);
+
+		m_Stats.Lights = (uint32_t)m_Lights.size();
+		m_Stats.VisibleLights = (uint32_t)m_TargetLights.size();
+		m_Stats.Tiles = (uint32_t)m_Tiles.size();
+		m_Stats.TileEntries = offset;
+		m_Stats.MaxLightsPerTile = maxCount;
+	}
+
+	void TiledLighting::Upload(GLBuffer& buffer, size_t& capacity, const void* data, size_t size)
+	{
+		// Bound as a storage buffer even when empty, so never leave it without storage
+		size = std::max<size_t>(size, 16);
+		if (size > capacity)
+		{
+			capacity = std::max(size, capacity * 2);
+			glNamedBufferData(buffer, capacity, nullptr, GL_STREAM_DRAW);
+		}
+		else
+		{
+			glInvalidateBufferData(buffer);
+		}
+		if (data)
+			glNamedBufferSubData(buffer, 0, size, data);
+	}
+
+	void TiledLighting::Render(uint32_t width, uint32_t height, const glm::mat4& viewProjection, Shader& accumulateShader)
+	{
+		if (width == 0 || height == 0)
+			return;
+
+		uint64_t start = FrameClock::Now();
+		Bin(width, height, viewProjection);
+		m_Stats.BinMilliseconds = (FrameClock::Now() - start) * 1e-6;
+
+		Upload(m_LightBuffer, m_LightCapacity, m_TargetLights.empty() ? nullptr : m_TargetLights.data(), m_TargetLights.size() * sizeof(TargetLight));
+		Upload(m_TileBuffer, m_TileCapacity, m_Tiles.data(), m_Tiles.size() * sizeof(TileRange));
+		Upload(m_LightIndexBuffer, m_LightIndexCapacity, m_LightIndices.empty() ? nullptr : m_LightIndices.data(), m_LightIndices.size() * sizeof(uint32_t));
+
+		GLint savedViewport[4], savedFramebuffer = 0;
+		glGetIntegerv(GL_VIEWPORT, savedViewport);
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &savedFramebuffer);
+		GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+		GLboolean blend = glIsEnabled(GL_BLEND);
+		GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+		glDisable(GL_DEPTH_TEST);
+		glDisable(GL_BLEND);
+		glDisable(GL_SCISSOR_TEST);
+
+		m_Framebuffer.Bind();
+
+		GLuint program = accumulateShader.GetRendererID();
+		glUseProgram(program);
+		glProgramUniform3f(program, glGetUniformLocation(program, "u_Ambient"), m_Ambient.x, m_Ambient.y, m_Ambient.z);
+		glProgramUniform1ui(program, glGetUniformLocation(program, "u_TileSize"), m_TileSize);
+		glProgramUniform1ui(program, glGetUniformLocation(program, "u_TileCountX"), m_TileCountX);
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightBinding, m_LightBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TileBinding, m_TileBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightIndexBinding, m_LightIndexBuffer);
+		glBindVertexArray(m_QuadVA);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, savedFramebuffer);
+		glViewport(savedViewport[0], savedViewport[1], savedViewport[2], savedViewport[3]);
+		if (depthTest)
+			glEnable(GL_DEPTH_TEST);
+		if (blend)
+			glEnable(GL_BLEND);
+		if (scissorTest)
+			glEnable(GL_SCISSOR_TEST);
+	}
+
+	void TiledLighting::Composite(Shader& compositeShader)
+	{
+		GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+		GLboolean blend = glIsEnabled(GL_BLEND);
+		GLint srcRGB, dstRGB, srcAlpha, dstAlpha;
+		glGetIntegerv(GL_BLEND_SRC_RGB, &srcRGB);
+		glGetIntegerv(GL_BLEND_DST_RGB, &dstRGB);
+		glGetIntegerv(GL_BLEND_SRC_ALPHA, &srcAlpha);
+		glGetIntegerv(GL_BLEND_DST_ALPHA, &dstAlpha);
+
+		// scene * light; alpha is left as it was
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFuncSeparate(GL_DST_COLOR, GL_ZERO, GL_ZERO, GL_ONE);
+
+		glUseProgram(compositeShader.GetRendererID());
+		glBindTextureUnit(0, m_Framebuffer.GetColorAttachmentRendererID());
+		glBindVertexArray(m_QuadVA);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+		glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+		if (!blend)
+			glDisable(GL_BLEND);
+		if (depthTest)
+			glEnable(GL_DEPTH_TEST);
+	}
+
+}
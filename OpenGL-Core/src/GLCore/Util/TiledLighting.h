@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Framebuffer.h"
+#include "GLResource.h"
+#include "Shader.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	// A world-space point light. Color is premultiplied by intensity.
+	struct PointLight
+	{
+		glm::vec2 Position;
+		float Radius;
+		glm::vec3 Color;
+	};
+
+	struct TiledLightingStats
+	{
+		uint32_t Lights = 0;
+		uint32_t VisibleLights = 0;
+		uint32_t Tiles = 0;
+		// Light/tile pairs, i.e. how many lights the shader evaluates per tile in total
+		uint32_t TileEntries = 0;
+		uint32_t MaxLightsPerTile = 0;
+		double BinMilliseconds = 0.0;
+	};
+
+	// 2D point lighting through a reduced-resolution light accumulation
+	// target. Lights are binned on the CPU into screen tiles, so every pixel
+	// of the target only evaluates the lights that reach its tile, and the
+	// result is multiplied over the scene with a single full-screen quad.
+	// Cost follows lit pixels times overlapping lights, not lights times sprites.
+	class TiledLighting
+	{
+	public:
+		static constexpr GLuint LightBinding = 7;
+		static constexpr GLuint TileBinding = 8;
+		static constexpr GLuint LightIndexBinding = 9;
+
+		// Tile size is in pixels of the accumulation target, which is
+		// 1 / downscale of the scene in each direction
+		TiledLighting(uint32_t downscale = 2, uint32_t tileSize = 16);
+
+		TiledLighting(const TiledLighting&) = delete;
+		TiledLighting& operator=(const TiledLighting&) = delete;
+
+		void Begin();
+		inline void Submit(const PointLight& light) { m_Lights.push_back(light); }
+
+		// Light reaching pixels no point light covers
+		inline void SetAmbient(const glm::vec3& ambient) { m_Ambient = ambient; }
+		inline const glm::vec3& GetAmbient() const { return m_Ambient; }
+
+		// Bins the submitted lights and renders the accumulation target for a
+		// scene of the given size. The projection is assumed orthographic, as
+		// light radii are scaled by its x axis. Restores the bound framebuffer
+		// and viewport.
+		void Render(uint32_t width, uint32_t height, const glm::mat4& viewProjection, Shader& accumulateShader);
+		// Multiplies the accumulated light over the bound target. The shader
+		// samples texture unit 0, like CachedRenderLayer's composite.
+		void Composite(Shader& compositeShader);
+
+		inline size_t GetLightCount() const { return m_Lights.size(); }
+		inline GLuint GetTextureRendererID() const { return m_Framebuffer.GetColorAttachmentRendererID(); }
+		inline const TiledLightingStats& GetStats() const { return m_Stats; }
+	private:
+		void Bin(uint32_t width, uint32_t height, const glm::mat4& viewProjection);
+		void Upload(GLBuffer& buffer, size_t& capacity, const void* data, size_t size);
+	private:
+		// A light in accumulation target pixels, matching the std430 layout
+		// of Light in light_accumulate.frag.glsl
+		struct TargetLight
+		{
+			glm::vec2 Position;
+			float Radius;
+			float Padding;
+			glm::vec4 Color;
+		};
+
+		struct TileRange
+		{
+			uint32_t Offset;
+			uint32_t Count;
+		};
+
+		struct TileRect
+		{
+			uint16_t MinX, MinY, MaxX, MaxY;
+		};
+
+		uint32_t m_Downscale, m_TileSize;
+		uint32_t m_TileCountX = 0, m_TileCountY = 0;
+		glm::vec3 m_Ambient = glm::vec3(1.0f);
+
+		std::vector<PointLight> m_Lights;
+		std::vector<TargetLight> m_TargetLights;
+		std::vector<TileRect> m_TileRects;
+		std::vector<TileRange> m_Tiles;
+		std::vector<uint32_t> m_LightIndices;
+
+		Framebuffer m_Framebuffer;
+		GLVertexArray m_QuadVA;
+		GLBuffer m_LightBuffer, m_TileBuffer, m_LightIndexBuffer;
+		size_t m_LightCapacity = 0, m_TileCapacity = 0, m_LightIndexCapacity = 0;
+
+		TiledLightingStats m_Stats;
+	};
+
+}
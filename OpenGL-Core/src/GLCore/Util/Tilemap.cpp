@@ -0,0 +1,230 @@
+#include "glpch.h"
+#include "Tilemap.h"
+#include "SpriteBatch.h"
+
+#include "GLCore/Core/FrameClock.h"
+
+namespace GLCore::Utils {
+
+	Tilemap::Tilemap(uint32_t width, uint32_t height, float tileSize, JobSystem& jobSystem, uint32_t maxResidentChunks)
+		: m_Width(width), m_Height(height), m_TileSize(tileSize), m_JobSystem(jobSystem), m_MaxResidentChunks(maxResidentChunks),
+		m_MeshHeap((uint32_t)sizeof(TileVertex), {
+			{ 0, 3, GL_FLOAT, (GLuint)offsetof(TileVertex, X) },
+			{ 1, 4, GL_UNSIGNED_BYTE, (GLuint)offsetof(TileVertex, Color), GL_TRUE },
+		})
+	{
+		m_ChunkCountX = (width + ChunkSize - 1) / ChunkSize;
+		m_ChunkCountY = (height + ChunkSize - 1) / ChunkSize;
+		m_Chunks.resize((size_t)m_ChunkCountX * m_ChunkCountY);
+		m_Tiles.resize((size_t)width * height, EmptyTile);
+		m_Palette.fill(0xFFFFFFFFu);
+	}
+
+	void Tilemap::SetTile(uint32_t x, uint32_t y, uint8_t tile)
+	{
+		uint8_t& current = m_Tiles[(size_t)y * m_Width + x];
+		if (current == tile)
+			return;
+
+		current = tile;
+		m_Chunks[(y / ChunkSize) * m_ChunkCountX + x / ChunkSize].Revision++;
+	}
+
+	void Tilemap::Fill(const std::function<uint8_t(uint32_t x, uint32_t y)>& generator)
+	{
+		for (uint32_t y = 0; y < m_Height; y++)
+		{
+			uint8_t* row = &m_Tiles[(size_t)y * m_Width];
+			for (uint32_t x = 0; x < m_Width; x++)
+				row[x] = generator(x, y);
+		}
+		InvalidateAll();
+	}
+
+	void Tilemap::SetTileColor(uint8_t tile, const glm::vec4& color)
+	{
+		m_Palette[tile] = SpriteBatch::PackColor(color);
+		InvalidateAll();
+	}
+
+	void Tilemap::SetDepth(float z)
+	{
+		m_Depth = z;
+		InvalidateAll();
+	}
+
+	void Tilemap::InvalidateAll()
+	{
+		// Chunks out of view are only rebuilt once they come into view
+		for (Chunk& chunk : m_Chunks)
+			chunk.Revision++;
+	}
+
+	void Tilemap::RequestBuild(uint32_t chunkIndex)
+	{
+		Chunk& chunk = m_Chunks[chunkIndex];
+		chunk.Building = true;
+		m_Stats.PendingBuilds++;
+
+		uint32_t firstX = (chunkIndex % m_ChunkCountX) * ChunkSize;
+		uint32_t firstY = (chunkIndex / m_ChunkCountX) * ChunkSize;
+		uint32_t width = std::min(ChunkSize, m_Width - firstX);
+		uint32_t height = std::min(ChunkSize, m_Height - firstY);
+
+		// The worker gets its own copy, so tiles can keep changing while it runs
+		std::vector<uint8_t> tiles((size_t)width * height);
+		for (uint32_t y = 0; y < height; y++)
+			std::copy_n(&m_Tiles[(size_t)(firstY + y) * m_Width + firstX], width, &tiles[(size_t)y * width]);
+
+		m_JobSystem.Submit([results = m_BuildResults.GetSink(), chunkIndex, revision = chunk.Revision, tiles = std::move(tiles), palette = m_Palette,
+			firstX, firstY, width, height, tileSize = m_TileSize, depth = m_Depth]()
+		{
+			uint64_t start = FrameClock::Now();
+
+			BuildResult result;
+			result.Chunk = chunkIndex;
+			result.Revision = revision;
+
+			// Runs of the same tile along a row become one quad
+			for (uint32_t y = 0; y < height; y++)
+			{
+				const uint8_t* row = &tiles[(size_t)y * width];
+				for (uint32_t x = 0; x < width;)
+				{
+					uint8_t tile = row[x];
+					uint32_t end = x + 1;
+					while (end < width && row[end] == tile)
+						end++;
+
+					if (tile != EmptyTile)
+					{
+						float minX = (firstX + x) * tileSize, maxX = (firstX + end) * tileSize;
+						float minY = (firstY + y) * tileSize, maxY = (firstY + y + 1) * tileSize;
+						uint32_t color = palette[tile];
+						uint32_t base = (uint32_t)result.Vertices.size();
+
+						result.Vertices.push_back({ minX, maxY, depth, color });
+						result.Vertices.push_back({ maxX, maxY, depth, color });
+						result.Vertices.push_back({ maxX, minY, depth, color });
+						result.Vertices.push_back({ minX, minY, depth, color });
+						result.Indices.insert(result.Indices.end(), { base + 0, base + 1, base + 2, base + 2, base + 3, base + 0 });
+					}
+					x = end;
+				}
+			}
+
+			result.Milliseconds = (FrameClock::Now() - start) * 1e-6;
+
+			results.Push(std::move(result));
+		});
+	}
+
+	void Tilemap::CollectBuilds()
+	{
+		m_BuildResults.Collect(m_Completed);
+		for (BuildResult& result : m_Completed)
+		{
+			Chunk& chunk = m_Chunks[result.Chunk];
+			chunk.Building = false;
+			m_Stats.PendingBuilds--;
+			m_Stats.CompletedBuilds++;
+			m_Stats.BuildMilliseconds += result.Milliseconds;
+
+			// Tiles changed again while it was building; the next Render asks for another
+			if (result.Revision != chunk.Revision)
+				continue;
+			// Left the view while it was building, and may have been evicted since.
+			// Keeping the mesh would make it resident again; it is rebuilt once it
+			// comes back into view.
+			if (chunk.LastVisibleFrame + 1 < m_Frame)
+				continue;
+
+			bool wasResident = chunk.Mesh != MeshHeap::InvalidMesh;
+			m_MeshHeap.Destroy(chunk.Mesh);
+			chunk.Mesh = MeshHeap::InvalidMesh;
+			if (!result.Indices.empty())
+			{
+				chunk.Mesh = m_MeshHeap.Create(result.Vertices.data(), (uint32_t)result.Vertices.size(),
+					result.Indices.data(), (uint32_t)result.Indices.size());
+			}
+			chunk.BuiltRevision = result.Revision;
+
+			bool isResident = chunk.Mesh != MeshHeap::InvalidMesh;
+			if (isResident && !wasResident)
+				m_Resident.push_back(result.Chunk);
+			else if (!isResident && wasResident)
+				m_Resident.erase(std::find(m_Resident.begin(), m_Resident.end(), result.Chunk));
+		}
+		m_Completed.clear();
+	}
+
+	void Tilemap::EvictChunks()
+	{
+		if (m_Resident.size() <= m_MaxResidentChunks)
+			return;
+
+		// Least recently seen first; chunks in view this frame are never evicted
+		std::sort(m_Resident.begin(), m_Resident.end(), [this](uint32_t a, uint32_t b)
+		{
+			return m_Chunks[a].LastVisibleFrame < m_Chunks[b].LastVisibleFrame;
+		});
+
+		size_t evict = 0;
+		while (m_Resident.size() - evict > m_MaxResidentChunks && m_Chunks[m_Resident[evict]].LastVisibleFrame != m_Frame)
+		{
+			Chunk& chunk = m_Chunks[m_Resident[evict]];
+			m_MeshHeap.Destroy(chunk.Mesh);
+			chunk.Mesh = MeshHeap::InvalidMesh;
+			chunk.BuiltRevision = 0;
+			evict++;
+		}
+		m_Resident.erase(m_Resident.begin(), m_Resident.begin() + evict);
+		m_Stats.EvictedChunks += (uint32_t)evict;
+	}
+
+	void Tilemap::Render(const OrthographicCamera& camera)
+	{
+		m_Frame++;
+		m_Stats.CompletedBuilds = 0;
+		m_Stats.EvictedChunks = 0;
+		m_Stats.BuildMilliseconds = 0.0;
+		CollectBuilds();
+
+		// Only the chunks under the view are visited, however large the map is
+		glm::vec4 bounds = camera.GetWorldBounds();
+		float chunkExtent = ChunkSize * m_TileSize;
+		int32_t minX = std::max((int32_t)std::floor(bounds.x / chunkExtent), 0);
+		int32_t minY = std::max((int32_t)std::floor(bounds.y / chunkExtent), 0);
+		int32_t maxX = std::min((int32_t)std::floor(bounds.z / chunkExtent), (int32_t)m_ChunkCountX - 1);
+		int32_t maxY = std::min((int32_t)std::floor(bounds.w / chunkExtent), (int32_t)m_ChunkCountY - 1);
+
+		m_Draws.clear();
+		uint32_t requested = 0, visible = 0;
+		for (int32_t y = minY; y <= maxY; y++)
+		{
+			for (int32_t x = minX; x <= maxX; x++)
+			{
+				uint32_t index = y * m_ChunkCountX + x;
+				Chunk& chunk = m_Chunks[index];
+				chunk.LastVisibleFrame = m_Frame;
+				visible++;
+
+				if (chunk.BuiltRevision != chunk.Revision && !chunk.Building && requested < MaxBuildsPerFrame)
+				{
+					RequestBuild(index);
+					requested++;
+				}
+				if (chunk.Mesh != MeshHeap::InvalidMesh)
+					m_Draws.push_back(chunk.Mesh);
+			}
+		}
+
+		m_MeshHeap.Draw(m_Draws.data(), m_Draws.size());
+		EvictChunks();
+
+		m_Stats.VisibleChunks = visible;
+		m_Stats.DrawnChunks = (uint32_t)m_Draws.size();
+		m_Stats.ResidentChunks = (uint32_t)m_Resident.size();
+	}
+
+}
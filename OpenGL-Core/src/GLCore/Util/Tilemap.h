@@ -0,0 +1,123 @@
+#pragma once
+
+#include "MeshHeap.h"
+#include "OrthographicCamera.h"
+#include "GLCore/Core/JobSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace GLCore::Utils {
+
+	// The tilemap's vertex format, read by test.vert.glsl as position and color
+	struct TileVertex
+	{
+		float X, Y, Z;
+		uint32_t Color;  // RGBA unorm8, red in the low byte
+	};
+
+	struct TilemapStats
+	{
+		uint32_t VisibleChunks = 0;
+		uint32_t DrawnChunks = 0;
+		uint32_t ResidentChunks = 0;
+		uint32_t PendingBuilds = 0;
+		// Since the previous Render
+		uint32_t CompletedBuilds = 0;
+		uint32_t EvictedChunks = 0;
+		// Worker time spent on the builds completed since the previous Render
+		double BuildMilliseconds = 0.0;
+	};
+
+	// A grid of tile ids split into ChunkSize x ChunkSize chunks. Each chunk
+	// has a static mesh in a MeshHeap that is only rebuilt when its tiles
+	// change, and only chunks under the camera are drawn or built, so the
+	// per-frame cost depends on the view and not the map size. Meshes are
+	// built on the JobSystem from a copy of the chunk's tiles and uploaded
+	// when done. Chunks that haven't been seen for a while are evicted once
+	// more than maxResidentChunks have meshes.
+	class Tilemap
+	{
+	public:
+		static constexpr uint32_t ChunkSize = 64;
+		// Keeps a camera jump from queueing hundreds of builds in one frame
+		static constexpr uint32_t MaxBuildsPerFrame = 8;
+		// Tile id 0 is empty and never drawn
+		static constexpr uint8_t EmptyTile = 0;
+
+		Tilemap(uint32_t width, uint32_t height, float tileSize, JobSystem& jobSystem, uint32_t maxResidentChunks = 128);
+
+		Tilemap(const Tilemap&) = delete;
+		Tilemap& operator=(const Tilemap&) = delete;
+
+		void SetTile(uint32_t x, uint32_t y, uint8_t tile);
+		inline uint8_t GetTile(uint32_t x, uint32_t y) const { return m_Tiles[(size_t)y * m_Width + x]; }
+		// Sets every tile at once, marking every chunk for a rebuild
+		void Fill(const std::function<uint8_t(uint32_t x, uint32_t y)>& generator);
+
+		// Also marks every chunk for a rebuild
+		void SetTileColor(uint8_t tile, const glm::vec4& color);
+		void SetDepth(float z);
+
+		// Picks up finished builds, queues builds for stale chunks in view and
+		// draws the chunks in view with the bound program. A chunk whose
+		// rebuild is still running keeps drawing its old mesh.
+		void Render(const OrthographicCamera& camera);
+
+		inline uint32_t GetWidth() const { return m_Width; }
+		inline uint32_t GetHeight() const { return m_Height; }
+		inline const TilemapStats& GetStats() const { return m_Stats; }
+		inline BufferHeapStats GetHeapStats() const { return m_MeshHeap.GetStats(); }
+	private:
+		struct Chunk
+		{
+			MeshHeap::Mesh Mesh = MeshHeap::InvalidMesh;
+			// The chunk is stale while BuiltRevision != Revision
+			uint32_t Revision = 1;
+			uint32_t BuiltRevision = 0;
+			bool Building = false;
+			uint64_t LastVisibleFrame = 0;
+		};
+
+		struct BuildResult
+		{
+			uint32_t Chunk;
+			uint32_t Revision;
+			std::vector<TileVertex> Vertices;
+			std::vector<uint32_t> Indices;
+			double Milliseconds;
+		};
+
+		void InvalidateAll();
+		void RequestBuild(uint32_t chunkIndex);
+		void CollectBuilds();
+		void EvictChunks();
+	private:
+		uint32_t m_Width, m_Height;
+		uint32_t m_ChunkCountX, m_ChunkCountY;
+		float m_TileSize;
+		float m_Depth = 0.0f;
+		JobSystem& m_JobSystem;
+		uint32_t m_MaxResidentChunks;
+
+		std::vector<uint8_t> m_Tiles;
+		std::array<uint32_t, 256> m_Palette;
+		std::vector<Chunk> m_Chunks;
+
+		MeshHeap m_MeshHeap;
+		JobResults<BuildResult> m_BuildResults;
+		uint64_t m_Frame = 0;
+
+		// Kept between frames so Render doesn't allocate
+		std::vector<uint32_t> m_Resident;
+		std::vector<MeshHeap::Mesh> m_Draws;
+		std::vector<BuildResult> m_Completed;
+
+		TilemapStats m_Stats;
+	};
+
+}
@@ -2,7 +2,27 @@
 
 // Utility header file - include into application for access to utility classes/functions
 
+#include "GLCore/Util/GLResource.h"
 #include "GLCore/Util/Shader.h"
 #include "GLCore/Util/OrthographicCamera.h"
 #include "GLCore/Util/OrthographicCameraController.h"
-#include "GLCore/Util/OpenGLDebug.h"
\ No newline at end of file
+#include "GLCore/Util/OpenGLDebug.h"
+#include "GLCore/Util/Framebuffer.h"
+#include "GLCore/Util/CachedRenderLayer.h"
+#include "GLCore/Util/DrawQueue.h"
+#include "GLCore/Util/BufferHeap.h"
+#include "GLCore/Util/MeshHeap.h"
+#include "GLCore/Util/IndirectDrawBatch.h"
+#include "GLCore/Util/Prefab.h"
+#include "GLCore/Util/SpriteBatch.h"
+#include "GLCore/Util/ParticleSystem.h"
+#include "GLCore/Util/Tilemap.h"
+#include "GLCore/Util/TiledLighting.h"
+#include "GLCore/Util/FrameUniforms.h"
+#include "GLCore/Util/FrameGraph.h"
+#include "GLCore/Util/DynamicResolution.h"
+#include "GLCore/Util/ImageWriter.h"
+#include "GLCore/Util/FrameCapture.h"
+#include "GLCore/Util/ShaderPreprocessor.h"
+#include "GLCore/Util/ShaderVariants.h"
+#include "GLCore/Util/AssetManager.h"
@@ -157,24 +157,54 @@ namespace GLCore {
 	}
 
 	void WindowsWindow::OnUpdate()
+	{
+		PollEvents();
+		SwapBuffers();
+	}
+
+	void WindowsWindow::PollEvents()
 	{
 		glfwPollEvents();
+	}
+
+	void WindowsWindow::WaitEvents(double timeoutSeconds)
+	{
+		glfwWaitEventsTimeout(timeoutSeconds);
+	}
+
+	void WindowsWindow::SwapBuffers()
+	{
 		glfwSwapBuffers(m_Window);
 	}
 
 	void WindowsWindow::SetVSync(bool enabled)
 	{
-		if (enabled)
-			glfwSwapInterval(1);
-		else
-			glfwSwapInterval(0);
-
-		m_Data.VSync = enabled;
+		SetVSyncMode(enabled ? VSyncMode::On : VSyncMode::Off);
 	}
 
 	bool WindowsWindow::IsVSync() const
 	{
-		return m_Data.VSync;
+		return m_Data.VSync != VSyncMode::Off;
+	}
+
+	void WindowsWindow::SetVSyncMode(VSyncMode mode)
+	{
+		if (mode == VSyncMode::Adaptive &&
+			!glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+			!glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+		{
+			LOG_WARN("Adaptive VSync is not supported, using regular VSync");
+			mode = VSyncMode::On;
+		}
+
+		switch (mode)
+		{
+			case VSyncMode::Off:      glfwSwapInterval(0); break;
+			case VSyncMode::On:       glfwSwapInterval(1); break;
+			case VSyncMode::Adaptive: glfwSwapInterval(-1); break;
+		}
+
+		m_Data.VSync = mode;
 	}
 
 }
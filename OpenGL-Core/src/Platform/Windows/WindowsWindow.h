@@ -13,6 +13,9 @@ namespace GLCore {
 		virtual ~WindowsWindow();
 
 		void OnUpdate() override;
+		void PollEvents() override;
+		void WaitEvents(double timeoutSeconds) override;
+		void SwapBuffers() override;
 
 		inline uint32_t GetWidth() const override { return m_Data.Width; }
 		inline uint32_t GetHeight() const override { return m_Data.Height; }
@@ -21,6 +24,8 @@ namespace GLCore {
 		inline void SetEventCallback(const EventCallbackFn& callback) override { m_Data.EventCallback = callback; }
 		void SetVSync(bool enabled) override;
 		bool IsVSync() const override;
+		void SetVSyncMode(VSyncMode mode) override;
+		inline VSyncMode GetVSyncMode() const override { return m_Data.VSync; }
 
 		inline virtual void* GetNativeWindow() const { return m_Window; }
 	private:
@@ -33,7 +38,7 @@ namespace GLCore {
 		{
 			std::string Title;
 			uint32_t Width, Height;
-			bool VSync;
+			VSyncMode VSync;
 
 			EventCallbackFn EventCallback;
 		};
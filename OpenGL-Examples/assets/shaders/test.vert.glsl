@@ -2,7 +2,15 @@
 
 layout (location = 0) in vec3 a_Position;
 
-uniform mat4 u_ViewProjection;
+layout (std140, binding = 0) uniform Frame
+{
+	mat4 u_ViewProjection;
+	mat4 u_View;
+	mat4 u_Projection;
+	vec4 u_Viewport;
+	float u_Time;
+	float u_DeltaTime;
+};
 
 void main()
 {
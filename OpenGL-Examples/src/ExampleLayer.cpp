@@ -27,7 +27,7 @@ void ExampleLayer::OnAttach()
 		"assets/shaders/test.frag.glsl"
 	);
 
-	glCreateVertexArrays(1, &m_QuadVA);
+	m_QuadVA = CreateGLVertexArray();
 	glBindVertexArray(m_QuadVA);
 
 	float vertices[] = {
@@ -37,7 +37,7 @@ void ExampleLayer::OnAttach()
 		-0.5f,  0.5f, 0.0f
 	};
 
-	glCreateBuffers(1, &m_QuadVB);
+	m_QuadVB = CreateGLBuffer();
 	glBindBuffer(GL_ARRAY_BUFFER, m_QuadVB);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
@@ -45,16 +45,17 @@ void ExampleLayer::OnAttach()
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, 0);
 
 	uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
-	glCreateBuffers(1, &m_QuadIB);
+	m_QuadIB = CreateGLBuffer();
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_QuadIB);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 }
 
 void ExampleLayer::OnDetach()
 {
-	glDeleteVertexArrays(1, &m_QuadVA);
-	glDeleteBuffers(1, &m_QuadVB);
-	glDeleteBuffers(1, &m_QuadIB);
+	m_QuadVA.Reset();
+	m_QuadVB.Reset();
+	m_QuadIB.Reset();
+	m_Shader.reset();
 }
 
 void ExampleLayer::OnEvent(Event& event)
@@ -83,12 +84,13 @@ void ExampleLayer::OnUpdate(Timestep ts)
 	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	glUseProgram(m_Shader->GetRendererID());
+	FrameUniformBuffer& frameUniforms = Application::Get().GetFrameUniforms();
+	frameUniforms.SetCamera(m_CameraController.GetCamera());
+	frameUniforms.Upload();
 
-	int location = glGetUniformLocation(m_Shader->GetRendererID(), "u_ViewProjection");
-	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(m_CameraController.GetCamera().GetViewProjectionMatrix()));
+	glUseProgram(m_Shader->GetRendererID());
 
-	location = glGetUniformLocation(m_Shader->GetRendererID(), "u_Color");
+	int location = glGetUniformLocation(m_Shader->GetRendererID(), "u_Color");
 	glUniform4fv(location, 1, glm::value_ptr(m_SquareColor));
 
 	glBindVertexArray(m_QuadVA);
@@ -15,10 +15,11 @@ public:
 	virtual void OnUpdate(GLCore::Timestep ts) override;
 	virtual void OnImGuiRender() override;
 private:
-	GLCore::Utils::Shader* m_Shader;
+	GLCore::Ref<GLCore::Utils::Shader> m_Shader;
 	GLCore::Utils::OrthographicCameraController m_CameraController;
 	
-	GLuint m_QuadVA, m_QuadVB, m_QuadIB;
+	GLCore::Utils::GLVertexArray m_QuadVA;
+	GLCore::Utils::GLBuffer m_QuadVB, m_QuadIB;
 
 	glm::vec4 m_SquareBaseColor = { 0.8f, 0.2f, 0.3f, 1.0f };
 	glm::vec4 m_SquareAlternateColor = { 0.2f, 0.3f, 0.8f, 1.0f };
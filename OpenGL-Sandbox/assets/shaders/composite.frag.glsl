@@ -0,0 +1,12 @@
+#version 450 core
+
+layout (location = 0) out vec4 o_Color;
+
+in vec2 v_TexCoord;
+
+layout (binding = 0) uniform sampler2D u_Texture;
+
+void main()
+{
+	o_Color = texture(u_Texture, v_TexCoord);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 450 core
+
+out vec2 v_TexCoord;
+
+void main()
+{
+	// Full-screen quad generated from the vertex index, drawn as a triangle strip
+	vec2 corner = vec2(gl_VertexID & 1, (gl_VertexID >> 1) & 1);
+	v_TexCoord = corner;
+	gl_Position = vec4(corner * 2.0f - 1.0f, 0.0f, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+// Per-frame constants shared by every pass, written by FrameUniformBuffer
+layout (std140, binding = 0) uniform Frame
+{
+	mat4 u_ViewProjection;
+	mat4 u_View;
+	mat4 u_Projection;
+	vec4 u_Viewport;
+	float u_Time;
+	float u_DeltaTime;
+};
@@ -0,0 +1,22 @@
+// Per-draw data for IndirectDrawBatch, matching IndirectDrawData
+struct DrawData
+{
+	vec4 Transform;  // xy offset, zw scale
+	vec4 Color;
+	vec4 Bounds;     // World-space min xy, max xy
+	float Depth;
+};
+
+layout (std430, binding = 1) readonly buffer DrawDataBuffer
+{
+	DrawData s_DrawData[];
+};
+
+// Maps a command slot back to its DrawData entry. The cull shader writes it
+#ifndef DRAW_INDEX_ACCESS
+#define DRAW_INDEX_ACCESS readonly
+#endif
+layout (std430, binding = 2) DRAW_INDEX_ACCESS buffer DrawIndexBuffer
+{
+	uint s_DrawIndices[];
+};
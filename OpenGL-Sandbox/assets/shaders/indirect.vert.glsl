@@ -0,0 +1,22 @@
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec4 a_Color;
+
+out vec4 v_Color;
+
+#include "include/frame.glsl"
+#include "include/indirect.glsl"
+
+// First command slot of the current multi-draw, since gl_DrawIDARB restarts at zero
+uniform uint u_FirstDraw;
+
+void main()
+{
+	DrawData draw = s_DrawData[s_DrawIndices[u_FirstDraw + gl_DrawIDARB]];
+
+	vec3 position = vec3(a_Position.xy * draw.Transform.zw + draw.Transform.xy, a_Position.z + draw.Depth);
+	gl_Position = u_ViewProjection * vec4(position, 1.0f);
+	v_Color = a_Color * draw.Color;
+}
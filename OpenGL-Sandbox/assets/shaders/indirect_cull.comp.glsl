@@ -0,0 +1,63 @@
+#version 450 core
+
+layout (local_size_x = 64) in;
+
+#define DRAW_INDEX_ACCESS writeonly
+#include "include/indirect.glsl"
+
+struct DrawCommand
+{
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;  // Index of the draw's group
+};
+
+struct DrawGroup
+{
+	uint First;
+	uint Count;
+};
+
+layout (std430, binding = 3) readonly buffer InputCommandBuffer
+{
+	DrawCommand s_InputCommands[];
+};
+
+layout (std430, binding = 4) writeonly buffer OutputCommandBuffer
+{
+	DrawCommand s_OutputCommands[];
+};
+
+layout (std430, binding = 5) buffer GroupBuffer
+{
+	DrawGroup s_Groups[];
+};
+
+layout (std430, binding = 6) readonly buffer InputDrawIndexBuffer
+{
+	uint s_InputDrawIndices[];
+};
+
+uniform vec4 u_ViewBounds;  // min xy, max xy
+uniform uint u_DrawCount;
+
+void main()
+{
+	uint slot = gl_GlobalInvocationID.x;
+	if (slot >= u_DrawCount)
+		return;
+
+	uint drawIndex = s_InputDrawIndices[slot];
+	vec4 bounds = s_DrawData[drawIndex].Bounds;
+	if (bounds.z < u_ViewBounds.x || bounds.x > u_ViewBounds.z || bounds.w < u_ViewBounds.y || bounds.y > u_ViewBounds.w)
+		return;
+
+	// Survivors are packed to the front of their group's range
+	DrawCommand command = s_InputCommands[slot];
+	uint group = command.BaseInstance;
+	uint outputSlot = s_Groups[group].First + atomicAdd(s_Groups[group].Count, 1);
+	s_OutputCommands[outputSlot] = command;
+	s_DrawIndices[outputSlot] = drawIndex;
+}
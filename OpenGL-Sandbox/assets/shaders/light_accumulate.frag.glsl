@@ -0,0 +1,53 @@
+#version 450 core
+
+layout (location = 0) out vec4 o_Color;
+
+// Matches TiledLighting's TargetLight; positions and radii are in target pixels
+struct Light
+{
+	vec2 Position;
+	float Radius;
+	vec4 Color;
+};
+
+struct Tile
+{
+	uint Offset;
+	uint Count;
+};
+
+layout (std430, binding = 7) readonly buffer LightBuffer
+{
+	Light s_Lights[];
+};
+
+layout (std430, binding = 8) readonly buffer TileBuffer
+{
+	Tile s_Tiles[];
+};
+
+layout (std430, binding = 9) readonly buffer LightIndexBuffer
+{
+	uint s_LightIndices[];
+};
+
+uniform vec3 u_Ambient;
+uniform uint u_TileSize;
+uniform uint u_TileCountX;
+
+void main()
+{
+	uvec2 tileCoord = uvec2(gl_FragCoord.xy) / u_TileSize;
+	Tile tile = s_Tiles[tileCoord.y * u_TileCountX + tileCoord.x];
+
+	// Only the lights binned into this tile, rather than every light
+	vec3 light = u_Ambient;
+	for (uint i = 0; i < tile.Count; i++)
+	{
+		Light pointLight = s_Lights[s_LightIndices[tile.Offset + i]];
+		float distance = length(gl_FragCoord.xy - pointLight.Position) / pointLight.Radius;
+		float falloff = clamp(1.0f - distance * distance, 0.0f, 1.0f);
+		light += pointLight.Color.rgb * falloff * falloff;
+	}
+	o_Color = vec4(light, 1.0f);
+}
@@ -0,0 +1,23 @@
+#version 450 core
+
+layout (location = 0) out vec4 o_Color;
+
+in vec2 v_TexCoord;
+
+// Number of fragments shaded per pixel, accumulated by overdraw.frag.glsl
+layout (binding = 0) uniform sampler2D u_Count;
+
+const vec3 c_Ramp[5] = vec3[](
+	vec3(0.0f, 0.0f, 0.0f),  // Never drawn
+	vec3(0.1f, 0.2f, 0.8f),  // Drawn once
+	vec3(0.1f, 0.8f, 0.2f),
+	vec3(0.9f, 0.9f, 0.1f),
+	vec3(0.9f, 0.1f, 0.1f)   // Drawn four or more times
+);
+
+void main()
+{
+	float count = clamp(texture(u_Count, v_TexCoord).r, 0.0f, 4.0f);
+	int index = min(int(count), 3);
+	o_Color = vec4(mix(c_Ramp[index], c_Ramp[index + 1], count - float(index)), 1.0f);
+}
@@ -0,0 +1,32 @@
+#version 450 core
+
+// Per instance, one attribute per ParticleSystem array
+layout (location = 0) in float i_PositionX;
+layout (location = 1) in float i_PositionY;
+layout (location = 2) in float i_SizeX;
+layout (location = 3) in float i_SizeY;
+layout (location = 4) in float i_Life;
+layout (location = 5) in vec4 i_Color;
+
+out vec4 v_Color;
+
+#include "include/frame.glsl"
+
+void main()
+{
+	// Free slots collapse to a point outside the view and produce no fragments
+	if (i_Life <= 0.0f)
+	{
+		gl_Position = vec4(2.0f, 2.0f, 2.0f, 1.0f);
+		v_Color = vec4(0.0f);
+		return;
+	}
+
+	// Centered quad corner from the vertex index, drawn as a triangle strip
+	vec2 corner = vec2(gl_VertexID & 1, (gl_VertexID >> 1) & 1) - 0.5f;
+	vec2 position = vec2(i_PositionX, i_PositionY) + corner * vec2(i_SizeX, i_SizeY);
+	gl_Position = u_ViewProjection * vec4(position, 0.0f, 1.0f);
+
+	// Fades out over the last fifth of its life
+	v_Color = vec4(i_Color.rgb, i_Color.a * clamp(i_Life * 5.0f, 0.0f, 1.0f));
+}
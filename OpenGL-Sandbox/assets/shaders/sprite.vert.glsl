@@ -0,0 +1,41 @@
+#version 450 core
+
+// Vertex pulling: no vertex attributes, every sprite is six vertices
+// and its corners are generated from gl_VertexID
+
+struct Sprite
+{
+	vec2 Position;
+	vec2 Size;
+	uint UVMin;
+	uint UVMax;
+	uint Color;
+	float Depth;
+};
+
+layout (std430, binding = 0) readonly buffer Sprites
+{
+	Sprite s_Sprites[];
+};
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+
+#include "include/frame.glsl"
+
+const vec2 c_Corners[6] = vec2[](
+	vec2(0.0f, 0.0f), vec2(1.0f, 0.0f), vec2(1.0f, 1.0f),
+	vec2(1.0f, 1.0f), vec2(0.0f, 1.0f), vec2(0.0f, 0.0f)
+);
+
+void main()
+{
+	Sprite sprite = s_Sprites[gl_VertexID / 6];
+	vec2 corner = c_Corners[gl_VertexID % 6];
+
+	vec2 position = sprite.Position + corner * sprite.Size;
+	gl_Position = u_ViewProjection * vec4(position, sprite.Depth, 1.0f);
+
+	v_Color = unpackUnorm4x8(sprite.Color);
+	v_TexCoord = mix(unpackUnorm2x16(sprite.UVMin), unpackUnorm2x16(sprite.UVMax), corner);
+}
@@ -6,8 +6,17 @@ in vec4 v_Color;
 
 uniform vec4 u_Color;
 
+#ifdef OVERDRAW
+// Added once per shaded fragment, so the target counts how often each pixel was drawn
+uniform vec4 u_Increment;
+#endif
+
 void main()
 {
+#ifdef OVERDRAW
+	o_Color = u_Increment;
+#else
 	//o_Color = u_Color;
 	o_Color = v_Color;
+#endif
 }
\ No newline at end of file
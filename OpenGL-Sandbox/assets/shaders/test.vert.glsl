@@ -3,12 +3,25 @@
 layout (location = 0) in vec3 a_Position;
 layout (location = 1) in vec4 a_Color;
 
+#ifdef INSTANCED
+// Per instance
+layout (location = 2) in vec3 i_Position;
+layout (location = 3) in vec2 i_Scale;
+layout (location = 4) in vec4 i_Tint;
+#endif
+
 out vec4 v_Color;
 
-uniform mat4 u_ViewProjection;
+#include "include/frame.glsl"
 
 void main()
 {
+#ifdef INSTANCED
+	vec3 position = vec3(a_Position.xy * i_Scale, a_Position.z) + i_Position;
+	gl_Position = u_ViewProjection * vec4(position, 1.0f);
+	v_Color = a_Color * i_Tint;
+#else
 	gl_Position = u_ViewProjection * vec4(a_Position, 1.0f);
 	v_Color = a_Color;
+#endif
 }
\ No newline at end of file
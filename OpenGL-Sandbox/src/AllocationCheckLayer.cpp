@@ -0,0 +1,68 @@
+#include "AllocationCheckLayer.h"
+
+using namespace GLCore;
+
+AllocationCheckLayer::AllocationCheckLayer(uint32_t warmupFrames, uint32_t measuredFrames)
+	: Layer("AllocationCheckLayer"), m_WarmupFrames(warmupFrames), m_MeasuredFrames(measuredFrames)
+{
+}
+
+void AllocationCheckLayer::OnAttach()
+{
+	if (!AllocationTracker::IsEnabled())
+	{
+		LOG_ERROR("Allocation check: this build doesn't count allocations, rebuild with GLCORE_TRACK_ALLOCATIONS");
+		Finish();
+		return;
+	}
+
+	// Every frame has to be rendered for the count to mean anything
+	Application::Get().SetOnDemandRendering(false);
+}
+
+void AllocationCheckLayer::OnUpdate(Timestep ts)
+{
+	if (m_Finished)
+		return;
+
+	// The previous frame is complete by now, including ImGui and the swap
+	if (m_Frame++ <= m_WarmupFrames)
+		return;
+
+	const AllocationStats& frame = Application::Get().GetFrameAllocations();
+	if (frame.Count > 0)
+	{
+		m_AllocatingFrames++;
+		m_Total += frame;
+		if (frame.Count > m_Worst.Count)
+			m_Worst = frame;
+	}
+
+	if (m_Frame > m_WarmupFrames + m_MeasuredFrames)
+	{
+		m_Passed = m_AllocatingFrames == 0;
+		Finish();
+	}
+}
+
+void AllocationCheckLayer::Finish()
+{
+	m_Finished = true;
+
+	if (m_Passed)
+	{
+		LOG_INFO("Allocation check passed: no heap allocations in {0} frames", m_MeasuredFrames);
+	}
+	else if (AllocationTracker::IsEnabled())
+	{
+		LOG_ERROR("Allocation check failed: {0} of {1} frames allocated, {2} allocations ({3} bytes) in total, worst frame {4}",
+			m_AllocatingFrames, m_MeasuredFrames, m_Total.Count, m_Total.Bytes, m_Worst.Count);
+
+		std::vector<AllocationScopeStats> scopes;
+		AllocationTracker::GetScopeStats(scopes);
+		for (const AllocationScopeStats& scope : scopes)
+			LOG_ERROR("  {0}: {1} allocations", scope.Name, scope.Total.Count);
+	}
+
+	Application::Get().Close();
+}
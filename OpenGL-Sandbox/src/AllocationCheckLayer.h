@@ -0,0 +1,30 @@
+#pragma once
+
+#include <GLCore.h>
+
+// Runs the application for a fixed number of frames and checks that none of
+// the frames after the warmup touched the heap on the main thread. Closes
+// the application when done; the result decides the process exit code.
+class AllocationCheckLayer : public GLCore::Layer
+{
+public:
+	AllocationCheckLayer(uint32_t warmupFrames = 120, uint32_t measuredFrames = 600);
+	virtual ~AllocationCheckLayer() = default;
+
+	virtual void OnAttach() override;
+	virtual void OnUpdate(GLCore::Timestep ts) override;
+
+	inline bool IsFinished() const { return m_Finished; }
+	inline bool HasPassed() const { return m_Finished && m_Passed; }
+private:
+	void Finish();
+private:
+	uint32_t m_WarmupFrames, m_MeasuredFrames;
+	uint32_t m_Frame = 0;
+
+	uint32_t m_AllocatingFrames = 0;
+	GLCore::AllocationStats m_Total, m_Worst;
+
+	bool m_Finished = false;
+	bool m_Passed = false;
+};
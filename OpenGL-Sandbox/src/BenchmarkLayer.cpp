@@ -0,0 +1,730 @@
+#include "BenchmarkLayer.h"
+
+using namespace GLCore;
+using namespace GLCore::Utils;
+
+BenchmarkLayer::BenchmarkLayer()
+	: Layer("BenchmarkLayer"), m_ViewProjection(glm::ortho(0.0f, 1280.0f, 720.0f, 0.0f, -1.0f, 1.0f)),
+	m_TilemapCamera(0.0f, 1280.0f, 720.0f, 0.0f)
+{
+	for (uint32_t count : { 10000u, 100000u, 1000000u })
+	{
+		m_SpriteCases.push_back({ SpritePath::CreateQuad, count });
+		m_SpriteCases.push_back({ SpritePath::VertexPulling, count });
+		m_SpriteCases.push_back({ SpritePath::MultiDrawIndirect, count });
+		m_SpriteCases.push_back({ SpritePath::MultiDrawIndirectCulled, count });
+	}
+	m_LightCases = { 1000u, 10000u, 100000u };
+	for (uint32_t count : { 100000u, 1000000u })
+	{
+		m_ParticleCases.push_back({ count, false });
+		m_ParticleCases.push_back({ count, true });
+	}
+	m_TilemapCases = { 256u, 1024u, 4096u };
+}
+
+void BenchmarkLayer::OnAttach()
+{
+	FramebufferSpecification spec;
+	spec.Width = 1280;
+	spec.Height = 720;
+	spec.DepthAttachment = false;
+	m_Target = std::make_unique<Framebuffer>(spec);
+
+	AssetManager& assets = Application::Get().GetAssets();
+	m_QuadShader = assets.LoadShader("assets/shaders/test.vert.glsl", "assets/shaders/test.frag.glsl");
+	m_SpriteShader = assets.LoadShader("assets/shaders/sprite.vert.glsl", "assets/shaders/test.frag.glsl");
+	m_IndirectShader = assets.LoadShader("assets/shaders/indirect.vert.glsl", "assets/shaders/test.frag.glsl");
+	m_IndirectCullShader = assets.LoadComputeShader("assets/shaders/indirect_cull.comp.glsl");
+	m_CompositeShader = assets.LoadShader("assets/shaders/composite.vert.glsl", "assets/shaders/composite.frag.glsl");
+	m_LightAccumulateShader = assets.LoadShader("assets/shaders/composite.vert.glsl", "assets/shaders/light_accumulate.frag.glsl");
+	m_ParticleShader = assets.LoadShader("assets/shaders/particle.vert.glsl", "assets/shaders/test.frag.glsl");
+
+	glCreateQueries(GL_TIME_ELAPSED, MeasuredFrames, m_TimerQueries);
+
+	m_Capture = std::make_unique<FrameCapture>(Application::Get().GetJobSystem());
+}
+
+void BenchmarkLayer::OnDetach()
+{
+	if (m_Running)
+		EndCase();
+
+	glDeleteQueries(MeasuredFrames, m_TimerQueries);
+	m_QuadShader.reset();
+	m_SpriteShader.reset();
+	m_IndirectShader.reset();
+	m_IndirectCullShader.reset();
+	m_CompositeShader.reset();
+	m_LightAccumulateShader.reset();
+	m_ParticleShader.reset();
+	m_Capture.reset();
+	m_Target.reset();
+}
+
+const char* BenchmarkLayer::GetPathName(SpritePath path)
+{
+	switch (path)
+	{
+		case SpritePath::CreateQuad:    return "CreateQuad";
+		case SpritePath::VertexPulling: return "Vertex pulling";
+		case SpritePath::MultiDrawIndirect: return "Multi-draw indirect";
+		case SpritePath::MultiDrawIndirectCulled: return "Multi-draw indirect, GPU culled";
+	}
+	return "Unknown";
+}
+
+void BenchmarkLayer::BeginSpriteCase()
+{
+	const SpriteCase& spriteCase = m_SpriteCases[m_CaseIndex];
+	m_Current = SpriteResult();
+	m_Current.Case = spriteCase;
+	m_Frame = 0;
+
+	uint32_t seed = 1;
+	auto random = [&seed]()
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / (float)(1u << 24);
+	};
+
+	// The culled path scatters sprites over four times the view, so about
+	// three quarters of them are rejected by the cull shader
+	float spread = spriteCase.Path == SpritePath::MultiDrawIndirectCulled ? 2.0f : 1.0f;
+
+	m_Sources.resize(spriteCase.SpriteCount);
+	for (SpriteSource& source : m_Sources)
+	{
+		source.Position = { random() * 1280.0f * spread, random() * 720.0f * spread };
+		source.Size = { 2.0f + random() * 14.0f, 2.0f + random() * 14.0f };
+		source.Color = { random(), random(), random(), 1.0f };
+	}
+
+	if (spriteCase.Path == SpritePath::CreateQuad)
+	{
+		// Same layout and index pattern as the village's quads
+		size_t vertexCount = (size_t)spriteCase.SpriteCount * 4;
+		m_Vertices.resize(vertexCount);
+
+		m_QuadVA = CreateGLVertexArray();
+		glBindVertexArray(m_QuadVA);
+
+		m_QuadVB = CreateGLBuffer();
+		glBindBuffer(GL_ARRAY_BUFFER, m_QuadVB);
+		glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, Position));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, Color));
+
+		std::vector<uint32_t> indices((size_t)spriteCase.SpriteCount * 6);
+		for (uint32_t quad = 0; quad < spriteCase.SpriteCount; quad++)
+		{
+			uint32_t* index = &indices[quad * 6];
+			uint32_t offset = quad * 4;
+			index[0] = offset + 0; index[1] = offset + 1; index[2] = offset + 2;
+			index[3] = offset + 2; index[4] = offset + 3; index[5] = offset + 0;
+		}
+		m_QuadIB = CreateGLBuffer();
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_QuadIB);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+	}
+	else if (spriteCase.Path == SpritePath::VertexPulling)
+	{
+		m_SpriteBatch = std::make_unique<SpriteBatch>();
+	}
+	else
+	{
+		m_MeshHeap = std::make_unique<MeshHeap>((uint32_t)sizeof(Vertex), std::vector<VertexAttribute>{
+			{ 0, 3, GL_FLOAT, (GLuint)offsetof(Vertex, Position) },
+			{ 1, 4, GL_FLOAT, (GLuint)offsetof(Vertex, Color) },
+		});
+
+		// Regular polygons of 3 to 10 sides in the unit square, so every draw
+		// has its own mesh and the commands can't collapse into one instanced draw
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		for (uint32_t mesh = 0; mesh < IndirectMeshCount; mesh++)
+		{
+			uint32_t sides = 3 + mesh % 8;
+			float shade = 0.5f + 0.5f * (mesh / 8) / (float)(IndirectMeshCount / 8);
+
+			vertices.clear();
+			indices.clear();
+			vertices.push_back(Vertex({ 0.5f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }));
+			for (uint32_t side = 0; side < sides; side++)
+			{
+				float angle = 6.2831853f * side / sides;
+				vertices.push_back(Vertex({ 0.5f + 0.5f * std::cos(angle), 0.5f + 0.5f * std::sin(angle), 0.0f }, { shade, shade, shade, 1.0f }));
+				indices.insert(indices.end(), { 0, side + 1, (side + 1) % sides + 1 });
+			}
+			m_IndirectMeshes.push_back(m_MeshHeap->Create(vertices.data(), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size()));
+		}
+
+		m_IndirectBatch = std::make_unique<IndirectDrawBatch>();
+	}
+}
+
+void BenchmarkLayer::RunSpriteFrame()
+{
+	const SpriteCase& spriteCase = m_SpriteCases[m_CaseIndex];
+	// Sprites drift every frame, so nothing can be reused from the last one
+	float drift = (float)(m_Frame % 64);
+
+	FrameUniformBuffer& frameUniforms = Application::Get().GetFrameUniforms();
+	frameUniforms.SetViewProjection(m_ViewProjection);
+	frameUniforms.Upload();
+
+	m_Current.CpuMilliseconds += RunTimedSuiteFrame({ 0.0f, 0.0f, 0.0f, 1.0f }, [&](bool)
+	{
+		if (spriteCase.Path == SpritePath::CreateQuad)
+		{
+			Vertex* target = m_Vertices.data();
+			for (const SpriteSource& source : m_Sources)
+			{
+				Vec4 color = { source.Color.x, source.Color.y, source.Color.z, source.Color.w };
+				target = CreateQuad(target, { source.Position.x + drift, source.Position.y }, 0.0f,
+					{ source.Size.x, source.Size.y }, color, color, color, color);
+			}
+
+			size_t size = m_Vertices.size() * sizeof(Vertex);
+			glNamedBufferSubData(m_QuadVB, 0, size, m_Vertices.data());
+			m_Current.UploadBytes = size;
+
+			glUseProgram(m_QuadShader->GetRendererID());
+			glBindVertexArray(m_QuadVA);
+			glDrawElements(GL_TRIANGLES, spriteCase.SpriteCount * 6, GL_UNSIGNED_INT, nullptr);
+		}
+		else if (spriteCase.Path == SpritePath::VertexPulling)
+		{
+			m_SpriteBatch->Begin();
+			for (const SpriteSource& source : m_Sources)
+				m_SpriteBatch->Submit({ source.Position.x + drift, source.Position.y }, source.Size, source.Color);
+			m_Current.UploadBytes = m_SpriteBatch->GetUploadSize();
+
+			glUseProgram(m_SpriteShader->GetRendererID());
+			m_SpriteBatch->Flush();
+		}
+		else
+		{
+			m_IndirectBatch->Begin();
+			for (size_t i = 0; i < m_Sources.size(); i++)
+			{
+				const SpriteSource& source = m_Sources[i];
+				glm::vec2 position = { source.Position.x + drift, source.Position.y };
+
+				IndirectDrawData data;
+				data.Transform = { position.x, position.y, source.Size.x, source.Size.y };
+				data.Color = source.Color;
+				data.Bounds = { position.x, position.y, position.x + source.Size.x, position.y + source.Size.y };
+				data.Depth = 0.0f;
+				m_IndirectBatch->Submit(m_MeshHeap->GetDraw(m_IndirectMeshes[i % IndirectMeshCount]), data);
+			}
+
+			glUseProgram(m_IndirectShader->GetRendererID());
+			if (spriteCase.Path == SpritePath::MultiDrawIndirectCulled)
+				m_IndirectBatch->FlushCulled(*m_IndirectCullShader, { 0.0f, 0.0f, 1280.0f, 720.0f });
+			else
+				m_IndirectBatch->Flush();
+			m_Current.UploadBytes = m_IndirectBatch->GetStats().UploadBytes;
+		}
+	});
+}
+
+double BenchmarkLayer::RunTimedSuiteFrame(const glm::vec4& clearColor, const std::function<void(bool measured)>& render)
+{
+	bool measured = m_Frame >= WarmupFrames;
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+	glDisable(GL_DEPTH_TEST);
+
+	m_Target->Bind();
+	glClearColor(clearColor.x, clearColor.y, clearColor.z, clearColor.w);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	if (measured)
+		glBeginQuery(GL_TIME_ELAPSED, m_TimerQueries[m_Frame - WarmupFrames]);
+	uint64_t start = FrameClock::Now();
+
+	render(measured);
+
+	uint64_t end = FrameClock::Now();
+	if (measured)
+		glEndQuery(GL_TIME_ELAPSED);
+
+	m_Target->Unbind();
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	if (depthTest)
+		glEnable(GL_DEPTH_TEST);
+
+	m_Frame++;
+	return measured ? (end - start) * 1e-6 : 0.0;
+}
+
+uint32_t BenchmarkLayer::EndTimedSuiteCase(const std::string& captureName, double& gpuMilliseconds)
+{
+	// Waiting on the queries stalls, but only once per case
+	uint32_t measuredFrames = m_Frame > WarmupFrames ? m_Frame - WarmupFrames : 0;
+	gpuMilliseconds = 0.0;
+	for (uint32_t i = 0; i < measuredFrames; i++)
+	{
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(m_TimerQueries[i], GL_QUERY_RESULT, &nanoseconds);
+		gpuMilliseconds += nanoseconds * 1e-6;
+	}
+	if (measuredFrames > 0)
+		gpuMilliseconds /= measuredFrames;
+
+	if (m_SaveCaseImages)
+	{
+		m_Capture->RequestScreenshot("captures/benchmark_" + captureName);
+		m_Capture->Capture(m_Target->GetRendererID(), m_Target->GetSpecification().Width, m_Target->GetSpecification().Height);
+	}
+	return measuredFrames;
+}
+
+void BenchmarkLayer::EndSpriteCase()
+{
+	uint32_t measuredFrames = EndTimedSuiteCase(std::string(GetPathName(m_Current.Case.Path)) + "_" + std::to_string(m_Current.Case.SpriteCount),
+		m_Current.GpuMilliseconds);
+	if (measuredFrames > 0)
+	{
+		m_Current.CpuMilliseconds /= measuredFrames;
+		m_SpriteResults.push_back(m_Current);
+
+		LOG_INFO("Sprite benchmark: {0} x {1}: CPU {2:.3f} ms, GPU {3:.3f} ms, {4} KiB uploaded per frame",
+			GetPathName(m_Current.Case.Path), m_Current.Case.SpriteCount, m_Current.CpuMilliseconds,
+			m_Current.GpuMilliseconds, m_Current.UploadBytes / 1024);
+	}
+
+	m_QuadVA.Reset();
+	m_QuadVB.Reset();
+	m_QuadIB.Reset();
+	m_Vertices = std::vector<Vertex>();
+	m_Sources = std::vector<SpriteSource>();
+	m_SpriteBatch.reset();
+	m_IndirectBatch.reset();
+	m_IndirectMeshes.clear();
+	m_MeshHeap.reset();
+}
+
+void BenchmarkLayer::BeginLightCase()
+{
+	uint32_t lightCount = m_LightCases[m_CaseIndex];
+	m_CurrentLight = LightResult();
+	m_CurrentLight.LightCount = lightCount;
+	m_Frame = 0;
+
+	uint32_t seed = 1;
+	auto random = [&seed]()
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / (float)(1u << 24);
+	};
+
+	// Lantern-sized lights, so denser cases mostly add overlap per pixel
+	m_LightSources.resize(lightCount);
+	for (PointLight& light : m_LightSources)
+	{
+		light.Position = { random() * 1280.0f, random() * 720.0f };
+		light.Radius = 8.0f + random() * 32.0f;
+		light.Color = glm::vec3(random(), random(), random()) * 0.5f;
+	}
+
+	m_Lighting = std::make_unique<TiledLighting>();
+	m_Lighting->SetAmbient(glm::vec3(0.1f));
+}
+
+void BenchmarkLayer::RunLightFrame()
+{
+	// Lights drift every frame, so they are re-binned every frame
+	float drift = (float)(m_Frame % 64);
+
+	m_CurrentLight.CpuMilliseconds += RunTimedSuiteFrame({ 0.6f, 0.6f, 0.6f, 1.0f }, [&](bool)
+	{
+		m_Lighting->Begin();
+		for (const PointLight& light : m_LightSources)
+			m_Lighting->Submit({ { light.Position.x + drift, light.Position.y }, light.Radius, light.Color });
+
+		const FramebufferSpecification& spec = m_Target->GetSpecification();
+		m_Lighting->Render(spec.Width, spec.Height, m_ViewProjection, *m_LightAccumulateShader);
+		m_Lighting->Composite(*m_CompositeShader);
+	});
+}
+
+void BenchmarkLayer::EndLightCase()
+{
+	uint32_t measuredFrames = EndTimedSuiteCase("lights_" + std::to_string(m_CurrentLight.LightCount), m_CurrentLight.GpuMilliseconds);
+	if (measuredFrames > 0)
+	{
+		const TiledLightingStats& stats = m_Lighting->GetStats();
+		m_CurrentLight.CpuMilliseconds /= measuredFrames;
+		m_CurrentLight.TileEntries = stats.TileEntries;
+		m_CurrentLight.MaxLightsPerTile = stats.MaxLightsPerTile;
+		m_LightResults.push_back(m_CurrentLight);
+
+		LOG_INFO("Lighting benchmark: {0} lights: CPU {1:.3f} ms, GPU {2:.3f} ms, {3} light/tile pairs, at most {4} per tile",
+			m_CurrentLight.LightCount, m_CurrentLight.CpuMilliseconds, m_CurrentLight.GpuMilliseconds,
+			m_CurrentLight.TileEntries, m_CurrentLight.MaxLightsPerTile);
+	}
+
+	m_LightSources = std::vector<PointLight>();
+	m_Lighting.reset();
+}
+
+// Snow-like drift over the whole target, living two seconds on average
+static ParticleProps GetBenchmarkParticle()
+{
+	ParticleProps props;
+	props.Position = { 640.0f, 360.0f };
+	props.PositionVariation = { 1280.0f, 720.0f };
+	props.VelocityVariation = { 60.0f, 60.0f };
+	props.Gravity = 20.0f;
+	props.Size = { 2.0f, 2.0f };
+	props.SizeVariation = 0.5f;
+	props.Color = { 0.9f, 0.9f, 1.0f, 0.6f };
+	props.Lifetime = 2.0f;
+	props.LifetimeVariation = 2.0f;
+	return props;
+}
+
+void BenchmarkLayer::BeginParticleCase()
+{
+	const ParticleCase& particleCase = m_ParticleCases[m_CaseIndex];
+	m_CurrentParticles = ParticleResult();
+	m_CurrentParticles.Case = particleCase;
+	m_Frame = 0;
+
+	m_Particles = std::make_unique<ParticleSystem>(particleCase.ParticleCount, &Application::Get().GetJobSystem());
+	m_Particles->SetParallel(particleCase.Parallel);
+	m_Particles->Emit(GetBenchmarkParticle(), particleCase.ParticleCount);
+}
+
+void BenchmarkLayer::RunParticleFrame()
+{
+	FrameUniformBuffer& frameUniforms = Application::Get().GetFrameUniforms();
+	frameUniforms.SetViewProjection(m_ViewProjection);
+	frameUniforms.Upload();
+
+	// Update and render are timed separately, so the frame's total isn't kept
+	RunTimedSuiteFrame({ 0.0f, 0.0f, 0.0f, 1.0f }, [&](bool measured)
+	{
+		// A fixed step, so every case simulates the same thing; whatever died last
+		// frame is replaced before the update
+		uint64_t start = FrameClock::Now();
+		m_Particles->Emit(GetBenchmarkParticle(), m_Particles->GetStats().Killed);
+		m_Particles->Update(Timestep(1.0f / 60.0f));
+		uint64_t updated = FrameClock::Now();
+
+		glUseProgram(m_ParticleShader->GetRendererID());
+		m_Particles->Render();
+		uint64_t end = FrameClock::Now();
+
+		if (measured)
+		{
+			m_CurrentParticles.UpdateMilliseconds += (updated - start) * 1e-6;
+			m_CurrentParticles.RenderMilliseconds += (end - updated) * 1e-6;
+		}
+	});
+}
+
+void BenchmarkLayer::EndParticleCase()
+{
+	uint32_t measuredFrames = EndTimedSuiteCase("particles_" + std::to_string(m_CurrentParticles.Case.ParticleCount)
+		+ (m_CurrentParticles.Case.Parallel ? "_parallel" : ""), m_CurrentParticles.GpuMilliseconds);
+	if (measuredFrames > 0)
+	{
+		m_CurrentParticles.UpdateMilliseconds /= measuredFrames;
+		m_CurrentParticles.RenderMilliseconds /= measuredFrames;
+		// Emit and update throughput; rendering is reported separately
+		if (m_CurrentParticles.UpdateMilliseconds > 0.0)
+			m_CurrentParticles.ParticlesPerSecond = m_Particles->GetLiveCount() / (m_CurrentParticles.UpdateMilliseconds * 1e-3);
+		m_ParticleResults.push_back(m_CurrentParticles);
+
+		LOG_INFO("Particle benchmark: {0} particles ({1}): update {2:.3f} ms ({3:.1f} M/s), render CPU {4:.3f} ms, GPU {5:.3f} ms",
+			m_CurrentParticles.Case.ParticleCount, m_CurrentParticles.Case.Parallel ? "parallel" : "serial",
+			m_CurrentParticles.UpdateMilliseconds, m_CurrentParticles.ParticlesPerSecond * 1e-6,
+			m_CurrentParticles.RenderMilliseconds, m_CurrentParticles.GpuMilliseconds);
+	}
+
+	m_Particles.reset();
+}
+
+void BenchmarkLayer::BeginTilemapCase()
+{
+	uint32_t mapSize = m_TilemapCases[m_CaseIndex];
+	m_CurrentTilemap = TilemapResult();
+	m_CurrentTilemap.MapSize = mapSize;
+	m_Frame = 0;
+
+	m_Tilemap = std::make_unique<Tilemap>(mapSize, mapSize, 16.0f, Application::Get().GetJobSystem());
+	m_Tilemap->SetTileColor(1, { 0.20f, 0.35f, 0.70f, 1.0f });  // Water
+	m_Tilemap->SetTileColor(2, { 0.85f, 0.80f, 0.55f, 1.0f });  // Sand
+	m_Tilemap->SetTileColor(3, { 0.45f, 0.70f, 0.30f, 1.0f });  // Grass
+	m_Tilemap->SetTileColor(4, { 0.20f, 0.50f, 0.20f, 1.0f });  // Forest
+
+	// Smooth bands of terrain with per-tile speckle, so rows break into several runs
+	uint64_t start = FrameClock::Now();
+	m_Tilemap->Fill([](uint32_t x, uint32_t y)
+	{
+		float height = std::sin(x * 0.021f) + std::sin(y * 0.017f) + 0.5f * std::sin((x + y) * 0.05f);
+		uint32_t hash = (x * 73856093u) ^ (y * 19349663u);
+		height += ((hash >> 7) & 15) * 0.02f;
+		return (uint8_t)(height < -0.6f ? 1 : height < -0.3f ? 2 : height < 0.8f ? 3 : 4);
+	});
+	m_CurrentTilemap.FillMilliseconds = (FrameClock::Now() - start) * 1e-6;
+}
+
+void BenchmarkLayer::RunTilemapFrame()
+{
+	// Pans diagonally at a steady pace, so chunks keep streaming in and out
+	float extent = m_Tilemap->GetWidth() * 16.0f;
+	float x = std::fmod(m_Frame * 37.0f, extent - 1280.0f);
+	float y = std::fmod(m_Frame * 23.0f, extent - 720.0f);
+	m_TilemapCamera.SetPosition({ x, y, 0.0f });
+
+	FrameUniformBuffer& frameUniforms = Application::Get().GetFrameUniforms();
+	frameUniforms.SetCamera(m_TilemapCamera);
+	frameUniforms.Upload();
+
+	m_CurrentTilemap.CpuMilliseconds += RunTimedSuiteFrame({ 0.0f, 0.0f, 0.0f, 1.0f }, [&](bool measured)
+	{
+		glUseProgram(m_QuadShader->GetRendererID());
+		m_Tilemap->Render(m_TilemapCamera);
+		if (measured)
+			m_CurrentTilemap.Builds += m_Tilemap->GetStats().CompletedBuilds;
+	});
+}
+
+void BenchmarkLayer::EndTilemapCase()
+{
+	uint32_t measuredFrames = EndTimedSuiteCase("tilemap_" + std::to_string(m_CurrentTilemap.MapSize), m_CurrentTilemap.GpuMilliseconds);
+	if (measuredFrames > 0)
+	{
+		const TilemapStats& stats = m_Tilemap->GetStats();
+		m_CurrentTilemap.CpuMilliseconds /= measuredFrames;
+		m_CurrentTilemap.VisibleChunks = stats.VisibleChunks;
+		m_CurrentTilemap.ResidentChunks = stats.ResidentChunks;
+		m_TilemapResults.push_back(m_CurrentTilemap);
+
+		LOG_INFO("Tilemap benchmark: {0}x{0} tiles: fill {1:.1f} ms, CPU {2:.3f} ms, GPU {3:.3f} ms, {4} chunks visible, {5} resident, {6} built",
+			m_CurrentTilemap.MapSize, m_CurrentTilemap.FillMilliseconds, m_CurrentTilemap.CpuMilliseconds, m_CurrentTilemap.GpuMilliseconds,
+			m_CurrentTilemap.VisibleChunks, m_CurrentTilemap.ResidentChunks, m_CurrentTilemap.Builds);
+	}
+
+	m_Tilemap.reset();
+}
+
+void BenchmarkLayer::StartSuite(Suite suite)
+{
+	m_Suite = suite;
+	switch (suite)
+	{
+		case Suite::Sprites:   m_SpriteResults.clear(); break;
+		case Suite::Lights:    m_LightResults.clear(); break;
+		case Suite::Particles: m_ParticleResults.clear(); break;
+		case Suite::Tilemap:   m_TilemapResults.clear(); break;
+	}
+	m_CaseIndex = 0;
+	m_Running = true;
+	BeginCase();
+}
+
+void BenchmarkLayer::BeginCase()
+{
+	switch (m_Suite)
+	{
+		case Suite::Sprites:   BeginSpriteCase(); break;
+		case Suite::Lights:    BeginLightCase(); break;
+		case Suite::Particles: BeginParticleCase(); break;
+		case Suite::Tilemap:   BeginTilemapCase(); break;
+	}
+}
+
+void BenchmarkLayer::RunFrame()
+{
+	switch (m_Suite)
+	{
+		case Suite::Sprites:   RunSpriteFrame(); break;
+		case Suite::Lights:    RunLightFrame(); break;
+		case Suite::Particles: RunParticleFrame(); break;
+		case Suite::Tilemap:   RunTilemapFrame(); break;
+	}
+}
+
+void BenchmarkLayer::EndCase()
+{
+	switch (m_Suite)
+	{
+		case Suite::Sprites:   EndSpriteCase(); break;
+		case Suite::Lights:    EndLightCase(); break;
+		case Suite::Particles: EndParticleCase(); break;
+		case Suite::Tilemap:   EndTilemapCase(); break;
+	}
+}
+
+size_t BenchmarkLayer::GetCaseCount() const
+{
+	switch (m_Suite)
+	{
+		case Suite::Sprites:   return m_SpriteCases.size();
+		case Suite::Lights:    return m_LightCases.size();
+		case Suite::Particles: return m_ParticleCases.size();
+		case Suite::Tilemap:   return m_TilemapCases.size();
+	}
+	return 0;
+}
+
+void BenchmarkLayer::OnUpdate(Timestep ts)
+{
+	// Hands finished readbacks to the workers
+	m_Capture->Capture(m_Target->GetRendererID(), m_Target->GetSpecification().Width, m_Target->GetSpecification().Height);
+
+	if (!m_Running)
+		return;
+
+	// Keep frames coming while on-demand rendering is enabled
+	Application::Get().RequestRedraw();
+
+	RunFrame();
+	if (m_Frame < WarmupFrames + MeasuredFrames)
+		return;
+
+	EndCase();
+	if (++m_CaseIndex < GetCaseCount())
+		BeginCase();
+	else
+		m_Running = false;
+}
+
+void BenchmarkLayer::OnImGuiRender()
+{
+	ImGui::Begin("Benchmarks");
+
+	if (m_Running && m_Suite == Suite::Sprites)
+	{
+		const SpriteCase& spriteCase = m_SpriteCases[m_CaseIndex];
+		ImGui::Text("Running %s x %u (%zu/%zu)", GetPathName(spriteCase.Path), spriteCase.SpriteCount, m_CaseIndex + 1, m_SpriteCases.size());
+	}
+	else if (m_Running && m_Suite == Suite::Lights)
+	{
+		ImGui::Text("Running %u lights (%zu/%zu)", m_LightCases[m_CaseIndex], m_CaseIndex + 1, m_LightCases.size());
+	}
+	else if (m_Running && m_Suite == Suite::Tilemap)
+	{
+		uint32_t mapSize = m_TilemapCases[m_CaseIndex];
+		ImGui::Text("Running %ux%u tilemap (%zu/%zu)", mapSize, mapSize, m_CaseIndex + 1, m_TilemapCases.size());
+	}
+	else if (m_Running)
+	{
+		const ParticleCase& particleCase = m_ParticleCases[m_CaseIndex];
+		ImGui::Text("Running %u particles, %s (%zu/%zu)", particleCase.ParticleCount, particleCase.Parallel ? "parallel" : "serial",
+			m_CaseIndex + 1, m_ParticleCases.size());
+	}
+	else
+	{
+		if (ImGui::Button("Run sprite benchmark"))
+			StartSuite(Suite::Sprites);
+		ImGui::SameLine();
+		if (ImGui::Button("Run lighting benchmark"))
+			StartSuite(Suite::Lights);
+		ImGui::SameLine();
+		if (ImGui::Button("Run particle benchmark"))
+			StartSuite(Suite::Particles);
+		ImGui::SameLine();
+		if (ImGui::Button("Run tilemap benchmark"))
+			StartSuite(Suite::Tilemap);
+	}
+	ImGui::Checkbox("Save an image of each case", &m_SaveCaseImages);
+
+	if (!m_SpriteResults.empty())
+	{
+		ImGui::Columns(5, "SpriteResults");
+		ImGui::Text("Path"); ImGui::NextColumn();
+		ImGui::Text("Sprites"); ImGui::NextColumn();
+		ImGui::Text("CPU (ms)"); ImGui::NextColumn();
+		ImGui::Text("GPU (ms)"); ImGui::NextColumn();
+		ImGui::Text("Upload (KiB)"); ImGui::NextColumn();
+		ImGui::Separator();
+		for (const SpriteResult& result : m_SpriteResults)
+		{
+			ImGui::Text("%s", GetPathName(result.Case.Path)); ImGui::NextColumn();
+			ImGui::Text("%u", result.Case.SpriteCount); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.CpuMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.GpuMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%zu", result.UploadBytes / 1024); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+	if (!m_LightResults.empty())
+	{
+		ImGui::Separator();
+		ImGui::Columns(5, "LightResults");
+		ImGui::Text("Lights"); ImGui::NextColumn();
+		ImGui::Text("CPU (ms)"); ImGui::NextColumn();
+		ImGui::Text("GPU (ms)"); ImGui::NextColumn();
+		ImGui::Text("Light/tile pairs"); ImGui::NextColumn();
+		ImGui::Text("Max per tile"); ImGui::NextColumn();
+		ImGui::Separator();
+		for (const LightResult& result : m_LightResults)
+		{
+			ImGui::Text("%u", result.LightCount); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.CpuMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.GpuMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%u", result.TileEntries); ImGui::NextColumn();
+			ImGui::Text("%u", result.MaxLightsPerTile); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+	if (!m_ParticleResults.empty())
+	{
+		ImGui::Separator();
+		ImGui::Columns(6, "ParticleResults");
+		ImGui::Text("Particles"); ImGui::NextColumn();
+		ImGui::Text("Update"); ImGui::NextColumn();
+		ImGui::Text("Update (ms)"); ImGui::NextColumn();
+		ImGui::Text("M particles/s"); ImGui::NextColumn();
+		ImGui::Text("Render CPU (ms)"); ImGui::NextColumn();
+		ImGui::Text("GPU (ms)"); ImGui::NextColumn();
+		ImGui::Separator();
+		for (const ParticleResult& result : m_ParticleResults)
+		{
+			ImGui::Text("%u", result.Case.ParticleCount); ImGui::NextColumn();
+			ImGui::Text("%s", result.Case.Parallel ? "Parallel" : "Serial"); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.UpdateMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%.1f", result.ParticlesPerSecond * 1e-6); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.RenderMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.GpuMilliseconds); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+	if (!m_TilemapResults.empty())
+	{
+		ImGui::Separator();
+		ImGui::Columns(6, "TilemapResults");
+		ImGui::Text("Map"); ImGui::NextColumn();
+		ImGui::Text("Fill (ms)"); ImGui::NextColumn();
+		ImGui::Text("CPU (ms)"); ImGui::NextColumn();
+		ImGui::Text("GPU (ms)"); ImGui::NextColumn();
+		ImGui::Text("Chunks visible/resident"); ImGui::NextColumn();
+		ImGui::Text("Chunks built"); ImGui::NextColumn();
+		ImGui::Separator();
+		for (const TilemapResult& result : m_TilemapResults)
+		{
+			ImGui::Text("%ux%u", result.MapSize, result.MapSize); ImGui::NextColumn();
+			ImGui::Text("%.1f", result.FillMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.CpuMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%.3f", result.GpuMilliseconds); ImGui::NextColumn();
+			ImGui::Text("%u/%u", result.VisibleChunks, result.ResidentChunks); ImGui::NextColumn();
+			ImGui::Text("%u", result.Builds); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+	ImGui::End();
+}
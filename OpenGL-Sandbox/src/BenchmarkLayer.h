@@ -0,0 +1,173 @@
+#pragma once
+
+#include <GLCore.h>
+#include <GLCoreUtils.h>
+
+#include "Quad.h"
+
+#include <functional>
+#include <string>
+
+// Renders synthetic workloads into an offscreen target and reports CPU and
+// GPU cost per frame. Nothing it draws reaches the window.
+class BenchmarkLayer : public GLCore::Layer
+{
+public:
+	BenchmarkLayer();
+	virtual ~BenchmarkLayer() = default;
+
+	virtual void OnAttach() override;
+	virtual void OnDetach() override;
+	virtual void OnUpdate(GLCore::Timestep ts) override;
+	virtual void OnImGuiRender() override;
+private:
+	enum class Suite { Sprites, Lights, Particles, Tilemap };
+	enum class SpritePath { CreateQuad, VertexPulling, MultiDrawIndirect, MultiDrawIndirectCulled };
+
+	struct SpriteCase
+	{
+		SpritePath Path;
+		uint32_t SpriteCount;
+	};
+
+	struct SpriteResult
+	{
+		SpriteCase Case;
+		double CpuMilliseconds = 0.0;
+		double GpuMilliseconds = 0.0;
+		size_t UploadBytes = 0;
+	};
+
+	struct SpriteSource
+	{
+		glm::vec2 Position, Size;
+		glm::vec4 Color;
+	};
+
+	struct LightResult
+	{
+		uint32_t LightCount = 0;
+		double CpuMilliseconds = 0.0;
+		double GpuMilliseconds = 0.0;
+		uint32_t TileEntries = 0;
+		uint32_t MaxLightsPerTile = 0;
+	};
+
+	void BeginSpriteCase();
+	void RunSpriteFrame();
+	void EndSpriteCase();
+
+	void BeginLightCase();
+	void RunLightFrame();
+	void EndLightCase();
+
+	struct ParticleCase
+	{
+		uint32_t ParticleCount;
+		bool Parallel;
+	};
+
+	struct ParticleResult
+	{
+		ParticleCase Case;
+		double UpdateMilliseconds = 0.0;
+		double RenderMilliseconds = 0.0;
+		double GpuMilliseconds = 0.0;
+		double ParticlesPerSecond = 0.0;
+	};
+
+	void BeginParticleCase();
+	void RunParticleFrame();
+	void EndParticleCase();
+
+	struct TilemapResult
+	{
+		uint32_t MapSize = 0;
+		double FillMilliseconds = 0.0;
+		double CpuMilliseconds = 0.0;
+		double GpuMilliseconds = 0.0;
+		uint32_t VisibleChunks = 0;
+		uint32_t ResidentChunks = 0;
+		uint32_t Builds = 0;
+	};
+
+	void BeginTilemapCase();
+	void RunTilemapFrame();
+	void EndTilemapCase();
+
+	void StartSuite(Suite suite);
+	void BeginCase();
+	void RunFrame();
+	void EndCase();
+	size_t GetCaseCount() const;
+
+	// Fixture shared by every suite. Draws one frame of the current case into
+	// the offscreen target with render, which is told whether the frame is
+	// measured, and times it on the GPU once warmup is over. Returns the CPU
+	// time of render in milliseconds, or 0 during warmup.
+	double RunTimedSuiteFrame(const glm::vec4& clearColor, const std::function<void(bool measured)>& render);
+	// Resolves the GPU time per measured frame and saves the last frame as
+	// captures/benchmark_<captureName> when asked. Returns the measured frame count.
+	uint32_t EndTimedSuiteCase(const std::string& captureName, double& gpuMilliseconds);
+
+	static const char* GetPathName(SpritePath path);
+private:
+	static constexpr uint32_t WarmupFrames = 5;
+	static constexpr uint32_t MeasuredFrames = 30;
+	// Distinct meshes the indirect paths cycle through
+	static constexpr uint32_t IndirectMeshCount = 64;
+
+	std::unique_ptr<GLCore::Utils::Framebuffer> m_Target;
+	GLCore::Ref<GLCore::Utils::Shader> m_QuadShader, m_SpriteShader, m_IndirectShader, m_IndirectCullShader;
+	GLCore::Ref<GLCore::Utils::Shader> m_CompositeShader, m_LightAccumulateShader, m_ParticleShader;
+	glm::mat4 m_ViewProjection;
+	GLuint m_TimerQueries[MeasuredFrames] = {};
+
+	std::vector<SpriteCase> m_SpriteCases;
+	std::vector<SpriteResult> m_SpriteResults;
+	Suite m_Suite = Suite::Sprites;
+	bool m_Running = false;
+	size_t m_CaseIndex = 0;
+	uint32_t m_Frame = 0;
+	SpriteResult m_Current;
+
+	// Sprites are described once per case; each frame turns them into GPU data
+	std::vector<SpriteSource> m_Sources;
+
+	// CreateQuad path
+	GLCore::Utils::GLVertexArray m_QuadVA;
+	GLCore::Utils::GLBuffer m_QuadVB, m_QuadIB;
+	std::vector<Vertex> m_Vertices;
+
+	// Vertex pulling path
+	std::unique_ptr<GLCore::Utils::SpriteBatch> m_SpriteBatch;
+
+	// Multi-draw indirect paths
+	std::unique_ptr<GLCore::Utils::MeshHeap> m_MeshHeap;
+	std::vector<GLCore::Utils::MeshHeap::Mesh> m_IndirectMeshes;
+	std::unique_ptr<GLCore::Utils::IndirectDrawBatch> m_IndirectBatch;
+
+	// Lighting suite: light counts per case, then one result per case
+	std::vector<uint32_t> m_LightCases;
+	std::vector<LightResult> m_LightResults;
+	LightResult m_CurrentLight;
+	std::vector<GLCore::Utils::PointLight> m_LightSources;
+	std::unique_ptr<GLCore::Utils::TiledLighting> m_Lighting;
+
+	// Particle suite: the pool is refilled every frame to hold the count steady
+	std::vector<ParticleCase> m_ParticleCases;
+	std::vector<ParticleResult> m_ParticleResults;
+	ParticleResult m_CurrentParticles;
+	std::unique_ptr<GLCore::Utils::ParticleSystem> m_Particles;
+
+	// Tilemap suite: square maps of each size, panned across
+	std::vector<uint32_t> m_TilemapCases;
+	std::vector<TilemapResult> m_TilemapResults;
+	TilemapResult m_CurrentTilemap;
+	std::unique_ptr<GLCore::Utils::Tilemap> m_Tilemap;
+	GLCore::Utils::OrthographicCamera m_TilemapCamera;
+
+	// Saves the last frame of each case, read back from the offscreen target
+	std::unique_ptr<GLCore::Utils::FrameCapture> m_Capture;
+	bool m_SaveCaseImages = false;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+// CPU-built quads: four full vertices per quad, drawn with a shared index pattern
+
+struct Vec2 { float x, y; Vec2(float x, float y) : x(x), y(y) {} };
+struct Vec3 { float x, y, z; Vec3(float x, float y, float z) : x(x), y(y), z(z) {} };
+struct Vec4 { float x, y, z, w; Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {} };
+
+struct Vertex
+{
+	Vec3 Position;
+	Vec4 Color;
+	Vec2 TexCoords;
+	float TexID;
+	Vertex(
+		Vec3 pos = { 0.0f, 0.0f, 0.0f }, 
+		Vec4 color = { 0.0f, 0.0f, 0.0f, 0.0f }, 
+		Vec2 texCoords = { 0.0f, 0.0f }, 
+		float texID = 0.0f)
+		: Position(pos), Color(color), TexCoords(texCoords), TexID(texID) {}
+};
+
+inline Vertex* CreateQuad(
+	Vertex* target,
+	const Vec2& pos,
+	const float textureID,
+	const Vec2& size = { 1.0f, 1.0f },
+	const Vec4& color1 = { 0.8f, 0.2f, 0.3f, 1.0f },
+	const Vec4& color2 = { 0.8f, 0.2f, 0.3f, 1.0f },
+	const Vec4& color3 = { 0.8f, 0.2f, 0.3f, 1.0f },
+	const Vec4& color4 = { 0.8f, 0.2f, 0.3f, 1.0f }
+)
+{
+	target->Position = { pos.x, pos.y, 0.0f };
+	target->Color = color1;
+	target->TexCoords = { 0.0f, 0.0f };
+	target->TexID = textureID;
+	target++;
+
+	target->Position = { pos.x + size.x, pos.y, 0.0f };
+	target->Color = color2;
+	target->TexCoords = { 1.0f, 0.0f };
+	target->TexID = textureID;
+	target++;
+
+	target->Position = { pos.x + size.x, pos.y + size.y, 0.0f };
+	target->Color = color3;
+	target->TexCoords = { 1.0f, 1.0f };
+	target->TexID = textureID;
+	target++;
+
+	target->Position = { pos.x, pos.y + size.y, 0.0f };
+	target->Color = color4;
+	target->TexCoords = { 0.0f, 1.0f };
+	target->TexID = textureID;
+	target++;
+
+	return target;
+}
@@ -1,19 +1,57 @@
 #include "GLCore.h"
 #include "VillageLayer.h"
+#include "BenchmarkLayer.h"
+#include "AllocationCheckLayer.h"
+
+#include <cstring>
 
 using namespace GLCore;
 
 class Sandbox : public Application
 {
 public:
-	Sandbox()
+	Sandbox(bool checkAllocations)
 	{
 		PushLayer(new VillageLayer());
+		PushOverlay(new BenchmarkLayer());
+
+		if (checkAllocations)
+		{
+			m_AllocationCheck = new AllocationCheckLayer();
+			PushOverlay(m_AllocationCheck);
+		}
+	}
+
+	// Exit code for the allocation check, which CI runs as --check-allocations
+	int GetExitCode() const
+	{
+		return m_AllocationCheck && !m_AllocationCheck->HasPassed() ? 1 : 0;
 	}
+private:
+	AllocationCheckLayer* m_AllocationCheck = nullptr;
 };
 
-int main()
+int main(int argc, char** argv)
 {
-	std::unique_ptr<Sandbox> app = std::make_unique<Sandbox>();
+	bool checkAllocations = false, packAssets = false;
+	for (int i = 1; i < argc; i++)
+	{
+		checkAllocations = checkAllocations || strcmp(argv[i], "--check-allocations") == 0;
+		packAssets = packAssets || strcmp(argv[i], "--pack-assets") == 0;
+	}
+
+	// Keep console/file output off the render thread
+	Log::Init(LogProps(true, "SimpleVillage.log"));
+
+	// Bundles assets/ into assets.pak, which is mounted over the loose files on the next run
+	if (packAssets)
+	{
+		bool packed = VirtualFileSystem::WritePack("assets.pak", "assets", "assets");
+		Log::Shutdown();
+		return packed ? 0 : 1;
+	}
+
+	std::unique_ptr<Sandbox> app = std::make_unique<Sandbox>(checkAllocations);
 	app->Run();
+	return app->GetExitCode();
 }
\ No newline at end of file
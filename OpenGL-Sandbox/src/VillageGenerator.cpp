@@ -0,0 +1,294 @@
+#include "VillageGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+// In world units
+static constexpr uint16_t ArterialWidth = 32;
+static constexpr uint16_t StreetWidth = 18;
+// Density is interpolated between random values on a grid this coarse
+static constexpr float DistrictSize = 4096.0f;
+
+// Keeps the hashes for different decisions about the same chunk unrelated
+static constexpr uint64_t ChunkSalt = 0x43484e4bull;
+static constexpr uint64_t DensitySalt = 0x44454e53ull;
+
+// splitmix64's finalizer
+static uint64_t Mix(uint64_t value)
+{
+	value += 0x9e3779b97f4a7c15ull;
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+	return value ^ (value >> 31);
+}
+
+static uint64_t Hash(uint64_t seed, int32_t x, int32_t y, uint64_t salt)
+{
+	uint64_t coordinate = ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	return Mix(Mix(seed ^ salt) ^ coordinate);
+}
+
+// The standard library's distributions differ between implementations, which
+// would make the same seed build a different village on each platform
+class Random
+{
+public:
+	explicit Random(uint64_t state)
+		: m_State(state) {}
+
+	uint32_t Next()
+	{
+		m_State += 0x9e3779b97f4a7c15ull;
+		return (uint32_t)(Mix(m_State) >> 32);
+	}
+
+	// In [min, max]
+	uint32_t Range(uint32_t min, uint32_t max) { return min + Next() % (max - min + 1); }
+	// In [0, 1)
+	float Float() { return (Next() >> 8) / 16777216.0f; }
+private:
+	uint64_t m_State;
+};
+
+VillageGenerator::VillageGenerator(uint64_t seed)
+	: m_Seed(seed)
+{
+}
+
+float VillageGenerator::GetDensity(float worldX, float worldY) const
+{
+	float cellX = std::floor(worldX / DistrictSize), cellY = std::floor(worldY / DistrictSize);
+	float tx = worldX / DistrictSize - cellX, ty = worldY / DistrictSize - cellY;
+	tx = tx * tx * (3.0f - 2.0f * tx);
+	ty = ty * ty * (3.0f - 2.0f * ty);
+
+	int32_t x = (int32_t)cellX, y = (int32_t)cellY;
+	auto corner = [this](int32_t x, int32_t y) { return (Hash(m_Seed, x, y, DensitySalt) >> 40) / 16777216.0f; };
+	float top = corner(x, y) + (corner(x + 1, y) - corner(x, y)) * tx;
+	float bottom = corner(x, y + 1) + (corner(x + 1, y + 1) - corner(x, y + 1)) * tx;
+	return top + (bottom - top) * ty;
+}
+
+// Splits [start, end) into count + 1 blocks separated by streets at jittered,
+// roughly even spacing. Returns the street positions and the blocks.
+static void SplitBlocks(Random& random, uint32_t start, uint32_t end, uint32_t count,
+	std::vector<uint16_t>& streets, std::vector<std::pair<uint16_t, uint16_t>>& blocks)
+{
+	uint32_t spacing = (end - start) / (count + 1);
+	uint32_t blockStart = start;
+	for (uint32_t i = 1; i <= count; i++)
+	{
+		uint32_t jitter = spacing / 4;
+		uint32_t street = start + spacing * i - jitter + random.Range(0, jitter * 2) - StreetWidth / 2;
+		streets.push_back((uint16_t)street);
+		blocks.push_back({ (uint16_t)blockStart, (uint16_t)street });
+		blockStart = street + StreetWidth;
+	}
+	blocks.push_back({ (uint16_t)blockStart, (uint16_t)end });
+}
+
+VillageChunk VillageGenerator::Generate(int32_t x, int32_t y) const
+{
+	VillageChunk chunk;
+	chunk.X = x;
+	chunk.Y = y;
+
+	Random random(Hash(m_Seed, x, y, ChunkSalt));
+	float originX = (float)x * ChunkSize, originY = (float)y * ChunkSize;
+	float chunkDensity = GetDensity(originX + ChunkSize * 0.5f, originY + ChunkSize * 0.5f);
+
+	// Arterials along the top and left edges meet the next chunk's at its border
+	chunk.Roads.push_back({ 0, 0, (uint16_t)ChunkSize, ArterialWidth });
+	chunk.Roads.push_back({ 0, ArterialWidth, ArterialWidth, (uint16_t)(ChunkSize - ArterialWidth) });
+
+	// Side streets run from arterial to arterial; the busier the chunk, the more there are
+	std::vector<uint16_t> streetsX, streetsY;
+	std::vector<std::pair<uint16_t, uint16_t>> blocksX, blocksY;
+	SplitBlocks(random, ArterialWidth, ChunkSize, std::min(3u, (uint32_t)(chunkDensity * 3.5f + random.Float() * 0.5f)), streetsX, blocksX);
+	SplitBlocks(random, ArterialWidth, ChunkSize, std::min(3u, (uint32_t)(chunkDensity * 3.5f + random.Float() * 0.5f)), streetsY, blocksY);
+	for (uint16_t street : streetsX)
+		chunk.Roads.push_back({ street, ArterialWidth, StreetWidth, (uint16_t)(ChunkSize - ArterialWidth) });
+	for (uint16_t street : streetsY)
+		chunk.Roads.push_back({ ArterialWidth, street, (uint16_t)(ChunkSize - ArterialWidth), StreetWidth });
+
+	// Blocks are divided into lots. Lots on a block's edge face a road and are
+	// mostly built on; inner lots are gardens. Out in the fields, lots are
+	// larger and mostly wooded.
+	uint32_t lotSize = 56 + (uint32_t)((1.0f - chunkDensity) * 48.0f);
+	for (const auto& [blockX0, blockX1] : blocksX)
+	{
+		for (const auto& [blockY0, blockY1] : blocksY)
+		{
+			uint32_t lotsX = std::max(1u, (uint32_t)(blockX1 - blockX0) / lotSize);
+			uint32_t lotsY = std::max(1u, (uint32_t)(blockY1 - blockY0) / lotSize);
+			uint32_t lotWidth = (blockX1 - blockX0) / lotsX, lotHeight = (blockY1 - blockY0) / lotsY;
+
+			for (uint32_t lotY = 0; lotY < lotsY; lotY++)
+			{
+				for (uint32_t lotX = 0; lotX < lotsX; lotX++)
+				{
+					uint32_t left = blockX0 + lotX * lotWidth, top = blockY0 + lotY * lotHeight;
+					float density = GetDensity(originX + left + lotWidth * 0.5f, originY + top + lotHeight * 0.5f);
+					bool facesRoad = lotX == 0 || lotY == 0 || lotX == lotsX - 1 || lotY == lotsY - 1;
+
+					float houseChance = facesRoad ? density * 1.1f + 0.05f : density * 0.3f;
+					if (random.Float() < houseChance && lotWidth >= 32 && lotHeight >= 32)
+					{
+						uint32_t marginLeft = random.Range(4, 10), marginRight = random.Range(4, 10);
+						uint32_t marginTop = random.Range(4, 10), marginBottom = random.Range(4, 10);
+
+						VillageHouse& house = chunk.Houses.emplace_back();
+						house.Footprint = { (uint16_t)(left + marginLeft), (uint16_t)(top + marginTop),
+							(uint16_t)(lotWidth - marginLeft - marginRight), (uint16_t)(lotHeight - marginTop - marginBottom) };
+						house.Roof = (uint16_t)random.Range(0, RoofStyleCount - 1);
+						continue;
+					}
+
+					if (random.Float() >= (1.0f - density) * 0.9f + 0.1f)
+						continue;
+
+					uint32_t treeCount = random.Range(1, 2 + (uint32_t)((1.0f - density) * 3.0f));
+					for (uint32_t i = 0; i < treeCount; i++)
+					{
+						uint32_t radius = random.Range(8, 14 + (uint32_t)((1.0f - density) * 10.0f));
+						radius = std::min(radius, std::min(lotWidth, lotHeight) / 2);
+
+						VillageTree& tree = chunk.Trees.emplace_back();
+						tree.X = (uint16_t)(left + radius + random.Range(0, lotWidth - radius * 2));
+						tree.Y = (uint16_t)(top + radius + random.Range(0, lotHeight - radius * 2));
+						tree.Radius = (uint8_t)radius;
+						tree.Shade = (uint8_t)random.Range(0, 255);
+					}
+				}
+			}
+		}
+	}
+	return chunk;
+}
+
+// Cache file layout: a CacheHeader, then the roads, houses and trees arrays
+// exactly as they are in memory (little-endian)
+struct CacheHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint64_t Seed;
+	int32_t X, Y;
+	uint32_t RoadCount, HouseCount, TreeCount;
+	// FNV-1a over the three arrays
+	uint32_t Checksum;
+};
+
+static_assert(sizeof(CacheHeader) == 40, "CacheHeader must not contain padding");
+
+static constexpr char CacheMagic[4] = { 'V', 'C', 'H', 'K' };
+// Far more than a chunk can hold; a larger count means the file is damaged
+static constexpr uint32_t MaxCacheRecords = 1 << 16;
+
+static uint32_t Fnv1a(const void* data, size_t size, uint32_t hash = 2166136261u)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+static uint32_t ChecksumChunk(const VillageChunk& chunk)
+{
+	uint32_t hash = Fnv1a(chunk.Roads.data(), chunk.Roads.size() * sizeof(VillageRect));
+	hash = Fnv1a(chunk.Houses.data(), chunk.Houses.size() * sizeof(VillageHouse), hash);
+	return Fnv1a(chunk.Trees.data(), chunk.Trees.size() * sizeof(VillageTree), hash);
+}
+
+template<typename T>
+static bool ReadArray(FILE* file, std::vector<T>& values, uint32_t count)
+{
+	values.resize(count);
+	return count == 0 || std::fread(values.data(), sizeof(T), count, file) == count;
+}
+
+template<typename T>
+static bool WriteArray(FILE* file, const std::vector<T>& values)
+{
+	return values.empty() || std::fwrite(values.data(), sizeof(T), values.size(), file) == values.size();
+}
+
+std::string VillageGenerator::GetCachePath(const std::string& directory, int32_t x, int32_t y) const
+{
+	char name[96];
+	std::snprintf(name, sizeof(name), "/v%u_%016llx_%d_%d.chunk", Version, (unsigned long long)m_Seed, x, y);
+	return directory + name;
+}
+
+bool VillageGenerator::LoadChunk(const std::string& path, int32_t x, int32_t y, VillageChunk& chunk) const
+{
+	FILE* file = std::fopen(path.c_str(), "rb");
+	if (!file)
+		return false;
+
+	CacheHeader header;
+	bool valid = std::fread(&header, sizeof(header), 1, file) == 1
+		&& std::memcmp(header.Magic, CacheMagic, sizeof(CacheMagic)) == 0
+		&& header.Version == Version && header.Seed == m_Seed && header.X == x && header.Y == y
+		&& header.RoadCount <= MaxCacheRecords && header.HouseCount <= MaxCacheRecords && header.TreeCount <= MaxCacheRecords;
+
+	if (valid)
+	{
+		chunk.X = x;
+		chunk.Y = y;
+		valid = ReadArray(file, chunk.Roads, header.RoadCount)
+			&& ReadArray(file, chunk.Houses, header.HouseCount)
+			&& ReadArray(file, chunk.Trees, header.TreeCount)
+			&& std::fgetc(file) == EOF
+			&& ChecksumChunk(chunk) == header.Checksum;
+	}
+
+	std::fclose(file);
+	return valid;
+}
+
+bool VillageGenerator::SaveChunk(const std::string& path, const VillageChunk& chunk) const
+{
+	CacheHeader header;
+	std::memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+	header.Version = Version;
+	header.Seed = m_Seed;
+	header.X = chunk.X;
+	header.Y = chunk.Y;
+	header.RoadCount = (uint32_t)chunk.Roads.size();
+	header.HouseCount = (uint32_t)chunk.Houses.size();
+	header.TreeCount = (uint32_t)chunk.Trees.size();
+	header.Checksum = ChecksumChunk(chunk);
+
+	// Every write gets its own temporary file. Two writers of the same chunk,
+	// such as a job left over from a previous seed or another instance sharing
+	// the directory, would otherwise truncate each other's file mid-write.
+	static const uint32_t s_ProcessTag = std::random_device()();
+	static std::atomic<uint32_t> s_WriteCount = 0;
+	char suffix[32];
+	std::snprintf(suffix, sizeof(suffix), ".%08x_%u.tmp", s_ProcessTag, s_WriteCount++);
+	std::string temporary = path + suffix;
+	FILE* file = std::fopen(temporary.c_str(), "wb");
+	if (!file)
+		return false;
+
+	bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+		&& WriteArray(file, chunk.Roads)
+		&& WriteArray(file, chunk.Houses)
+		&& WriteArray(file, chunk.Trees);
+	written = std::fclose(file) == 0 && written;
+
+	// rename doesn't replace an existing file on every platform
+	if (written)
+	{
+		std::remove(path.c_str());
+		written = std::rename(temporary.c_str(), path.c_str()) == 0;
+	}
+	if (!written)
+		std::remove(temporary.c_str());
+	return written;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Positions and sizes are whole world units relative to the chunk's top-left
+// corner, so a chunk read back from the cache is identical to a fresh one
+struct VillageRect
+{
+	uint16_t X, Y, Width, Height;
+};
+
+struct VillageHouse
+{
+	VillageRect Footprint;
+	// Index into the renderer's roof palette, below VillageGenerator::RoofStyleCount
+	uint16_t Roof;
+};
+
+struct VillageTree
+{
+	uint16_t X, Y;
+	uint8_t Radius;
+	// 0 is the darkest green, 255 the lightest
+	uint8_t Shade;
+};
+
+// The cache stores these arrays as they are in memory
+static_assert(sizeof(VillageRect) == 8, "VillageRect is part of the cache format");
+static_assert(sizeof(VillageHouse) == 10, "VillageHouse is part of the cache format");
+static_assert(sizeof(VillageTree) == 6, "VillageTree is part of the cache format");
+
+struct VillageChunk
+{
+	int32_t X = 0, Y = 0;
+	std::vector<VillageRect> Roads;
+	std::vector<VillageHouse> Houses;
+	std::vector<VillageTree> Trees;
+};
+
+// Lays out roads, houses and trees for one ChunkSize x ChunkSize square of an
+// endless, top-down village. Every chunk is generated from a hash of the seed
+// and its coordinate alone, so chunks can be built in any order, on any
+// thread, and always come out the same. Arterial roads run along every
+// chunk's top and left edges, which keeps the road grid continuous without
+// looking at neighbouring chunks.
+class VillageGenerator
+{
+public:
+	// Bump whenever Generate's output changes so old cache files are ignored
+	static constexpr uint32_t Version = 1;
+	// In world units, which are the village scene's pixels
+	static constexpr uint32_t ChunkSize = 1024;
+	static constexpr uint32_t RoofStyleCount = 6;
+
+	explicit VillageGenerator(uint64_t seed);
+
+	VillageChunk Generate(int32_t x, int32_t y) const;
+
+	// Cache files hold one chunk each and are named after the generator
+	// version, the seed and the chunk coordinate. Loading fails on a missing,
+	// stale or damaged file. Saving writes a temporary file unique to the call
+	// and renames it into place, so concurrent writers of the same chunk don't
+	// corrupt each other; a reader racing the rename finds no file and builds
+	// the chunk itself. Both are safe to call from worker threads.
+	std::string GetCachePath(const std::string& directory, int32_t x, int32_t y) const;
+	bool LoadChunk(const std::string& path, int32_t x, int32_t y, VillageChunk& chunk) const;
+	bool SaveChunk(const std::string& path, const VillageChunk& chunk) const;
+
+	inline uint64_t GetSeed() const { return m_Seed; }
+private:
+	// How built-up the village is around a world position, from 0 (fields and
+	// woods) to 1 (town centre). Smooth across chunk borders.
+	float GetDensity(float worldX, float worldY) const;
+private:
+	uint64_t m_Seed;
+};
@@ -1,32 +1,24 @@
 #include "VillageLayer.h"
+#include "Quad.h"
+
+#include "GLCore/Core/Input.h"
+#include "GLCore/Core/KeyCodes.h"
 
 #include <vector>
+#include <algorithm>
+#include <limits>
 
 using namespace GLCore;
 using namespace GLCore::Utils;
 
-struct Vec2 { float x, y; Vec2(float x, float y) : x(x), y(y) {} };
-struct Vec3 { float x, y, z; Vec3(float x, float y, float z) : x(x), y(y), z(z) {} };
-struct Vec4 { float x, y, z, w; Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {} };
-
-struct Vertex
-{
-	Vec3 Position;
-	Vec4 Color;
-	Vec2 TexCoords;
-	float TexID;
-	Vertex(
-		Vec3 pos = { 0.0f, 0.0f, 0.0f }, 
-		Vec4 color = { 0.0f, 0.0f, 0.0f, 0.0f }, 
-		Vec2 texCoords = { 0.0f, 0.0f }, 
-		float texID = 0.0f)
-		: Position(pos), Color(color), TexCoords(texCoords), TexID(texID) {}
-};
+// The scene is laid out in pixels of a 1280x720 window
+static constexpr float DesignWidth = 1280.0f;
+static constexpr float DesignHeight = 720.0f;
 
 VillageLayer::VillageLayer()
 	: m_CameraController(16.0f / 9.0f)
 {
-	m_CameraController.GetCamera().SetProjection(0.0f, 1280.0f, 720.0f, 0.0f);
+	m_CameraController.GetCamera().SetProjection(0.0f, DesignWidth, DesignHeight, 0.0f);
 }
 
 VillageLayer::~VillageLayer()
@@ -35,16 +27,61 @@ VillageLayer::~VillageLayer()
 
 void VillageLayer::OnAttach()
 {
-	EnableGLDebugging();
+	EnableGLDebugging(DebugOutputMode::Aggregated);
 
 	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	m_Shader = Shader::FromGLSLTextFiles(
+	// Shaders are shared with any other layer that loads the same pair
+	AssetManager& assets = Application::Get().GetAssets();
+	// One source for flat and instanced quads; the overdraw permutations are
+	// only compiled once the overdraw view is first turned on
+	m_SceneShaders = assets.LoadShaderVariants(
 		"assets/shaders/test.vert.glsl",
+		"assets/shaders/test.frag.glsl",
+		{ "INSTANCED", "OVERDRAW" }
+	);
+	m_InstancedBit = m_SceneShaders->GetKeywordBit("INSTANCED");
+	m_OverdrawBit = m_SceneShaders->GetKeywordBit("OVERDRAW");
+	m_Shader = m_SceneShaders->Get();
+
+	m_CompositeShader = assets.LoadShader(
+		"assets/shaders/composite.vert.glsl",
+		"assets/shaders/composite.frag.glsl"
+	);
+
+	CreatePrefabs();
+	m_OverdrawHeatmapShader = assets.LoadShader(
+		"assets/shaders/composite.vert.glsl",
+		"assets/shaders/overdraw_heatmap.frag.glsl"
+	);
+	glCreateQueries(GL_SAMPLES_PASSED, 2, m_OverdrawQueries);
+	// The full-screen quad is generated from gl_VertexID
+	m_FullscreenVA = CreateGLVertexArray();
+
+	m_BackgroundCache = std::make_unique<CachedRenderLayer>();
+	m_ForegroundCache = std::make_unique<CachedRenderLayer>();
+
+	m_LightAccumulateShader = assets.LoadShader(
+		"assets/shaders/composite.vert.glsl",
+		"assets/shaders/light_accumulate.frag.glsl"
+	);
+	m_Lighting = std::make_unique<TiledLighting>();
+
+	m_ParticleShader = assets.LoadShader(
+		"assets/shaders/particle.vert.glsl",
 		"assets/shaders/test.frag.glsl"
 	);
+	m_Particles = std::make_unique<ParticleSystem>(512 * 1024, &Application::Get().GetJobSystem());
+
+	FramebufferSpecification sceneSpec;
+	sceneSpec.Width = Application::Get().GetWindow().GetWidth();
+	sceneSpec.Height = Application::Get().GetWindow().GetHeight();
+	m_SceneFramebuffer = std::make_unique<Framebuffer>(sceneSpec);
+	ResizeView(sceneSpec.Width, sceneSpec.Height);
+
+	m_DynamicResolution = std::make_unique<DynamicResolution>();
 
 	glUseProgram(m_Shader->GetRendererID());
 
@@ -52,25 +89,14 @@ void VillageLayer::OnAttach()
 	const size_t MaxVertexCount = MaxQuadCount * 4;
 	const size_t MaxIndexCount = MaxQuadCount * 6;
 
-	glCreateVertexArrays(1, &m_QuadVA);
-	glBindVertexArray(m_QuadVA);
-
-	glCreateBuffers(1, &m_QuadVB);
-	glBindBuffer(GL_ARRAY_BUFFER, m_QuadVB);
-	glBufferData(GL_ARRAY_BUFFER, MaxVertexCount * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
-
-	// Define position (3 floats)
-	glEnableVertexArrayAttrib(m_QuadVB, 0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, Position));
-	// Define color (4 floats)
-	glEnableVertexArrayAttrib(m_QuadVB, 1);
-	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, Color));
-	// Define texture position (2 floats)
-	glEnableVertexArrayAttrib(m_QuadVB, 2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, TexCoords));
-	// Define texture ID (1 float)
-	glEnableVertexArrayAttrib(m_QuadVB, 3);
-	glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, TexID));
+	// The quads are one mesh in a shared heap; other meshes with the same
+	// layout can join the same buffer and vertex array
+	m_MeshHeap = std::make_unique<MeshHeap>((uint32_t)sizeof(Vertex), std::vector<VertexAttribute>{
+		{ 0, 3, GL_FLOAT, (GLuint)offsetof(Vertex, Position) },
+		{ 1, 4, GL_FLOAT, (GLuint)offsetof(Vertex, Color) },
+		{ 2, 2, GL_FLOAT, (GLuint)offsetof(Vertex, TexCoords) },
+		{ 3, 1, GL_FLOAT, (GLuint)offsetof(Vertex, TexID) },
+	});
 
 	uint32_t indices[MaxIndexCount];
 	uint32_t offset = 0;
@@ -86,27 +112,60 @@ void VillageLayer::OnAttach()
 
 		offset += 4;
 	}
-	glCreateBuffers(1, &m_QuadIB);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_QuadIB);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+	m_QuadMesh = m_MeshHeap->Create(nullptr, (uint32_t)MaxVertexCount, indices, (uint32_t)MaxIndexCount);
 }
 
 void VillageLayer::OnDetach()
 {
-	glDeleteVertexArrays(1, &m_QuadVA);
-	glDeleteBuffers(1, &m_QuadVB);
-	glDeleteBuffers(1, &m_QuadIB);
+	m_BackgroundCache.reset();
+	m_ForegroundCache.reset();
+	m_Lighting.reset();
+	m_LightAccumulateShader.reset();
+	m_Particles.reset();
+	m_ParticleShader.reset();
+	m_SceneFramebuffer.reset();
+	m_DynamicResolution.reset();
+	m_HousePrefab.reset();
+	m_TreePrefab.reset();
+	m_RoadPrefab.reset();
+	m_RoofPrefab.reset();
+	m_CanopyPrefab.reset();
+	m_VillageStreamer.reset();
+	m_Shader.reset();
+	m_CompositeShader.reset();
+	m_SceneShaders.reset();
+	m_OverdrawHeatmapShader.reset();
+
+	m_MeshHeap.reset();
+	m_QuadMesh = MeshHeap::InvalidMesh;
+	glDeleteQueries(2, m_OverdrawQueries);
+	m_FullscreenVA.Reset();
 }
 
 void VillageLayer::OnEvent(Event& event)
 {
-	// Events here
+	EventDispatcher dispatcher(event);
+	dispatcher.Dispatch<WindowResizeEvent>(
+		[this](WindowResizeEvent& e)
+		{
+			ResizeView(e.GetWidth(), e.GetHeight());
+			return false;
+		});
 }
 
-static void SetUniformMat4(uint32_t shader, const char* name, const glm::mat4& matrix)
+void VillageLayer::ResizeView(uint32_t width, uint32_t height)
 {
-	int location = glGetUniformLocation(shader, name);
-	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+	if (width == 0 || height == 0)
+		return;
+
+	// Keep one scene pixel square and the whole 1280x720 scene in view; the
+	// extra room on the longer axis is split between both sides
+	float scale = std::min(width / DesignWidth, height / DesignHeight);
+	float halfWidth = width / scale * 0.5f, halfHeight = height / scale * 0.5f;
+	float centerX = DesignWidth * 0.5f, centerY = DesignHeight * 0.5f;
+	m_CameraController.GetCamera().SetProjection(centerX - halfWidth, centerX + halfWidth, centerY + halfHeight, centerY - halfHeight);
+
+	m_FullRedrawRequested = true;
 }
 
 static void SetUniformVec4(uint32_t shader, const char* name, const glm::vec4& vec)
@@ -115,42 +174,310 @@ static void SetUniformVec4(uint32_t shader, const char* name, const glm::vec4& v
 	glUniform4f(location, vec.x, vec.y, vec.z, vec.w);
 }
 
-static Vertex* CreateQuad(
-	Vertex* target,
-	const Vec2& pos,
-	const float textureID,
-	const Vec2& size = { 1.0f, 1.0f },
-	const Vec4& color1 = { 0.8f, 0.2f, 0.3f, 1.0f },
-	const Vec4& color2 = { 0.8f, 0.2f, 0.3f, 1.0f },
-	const Vec4& color3 = { 0.8f, 0.2f, 0.3f, 1.0f },
-	const Vec4& color4 = { 0.8f, 0.2f, 0.3f, 1.0f }
-)
-{
-	target->Position = { pos.x, pos.y, 0.0f };
-	target->Color = color1;
-	target->TexCoords = { 0.0f, 0.0f };
-	target->TexID = textureID;
-	target++;
-
-	target->Position = { pos.x + size.x, pos.y, 0.0f };
-	target->Color = color2;
-	target->TexCoords = { 1.0f, 0.0f };
-	target->TexID = textureID;
-	target++;
-
-	target->Position = { pos.x + size.x, pos.y + size.y, 0.0f };
-	target->Color = color3;
-	target->TexCoords = { 1.0f, 1.0f };
-	target->TexID = textureID;
-	target++;
-
-	target->Position = { pos.x, pos.y + size.y, 0.0f };
-	target->Color = color4;
-	target->TexCoords = { 0.0f, 1.0f };
-	target->TexID = textureID;
-	target++;
-
-	return target;
+// Quad ranges within the vertex array built in OnUpdate
+static constexpr uint32_t ForegroundFirstQuad = 0, ForegroundQuadCount = 12; // Tree, house and ground
+static constexpr uint32_t MovingFirstQuad = 12, MovingQuadCount = 5;         // Clouds and birds
+static constexpr uint32_t BackgroundFirstQuad = 17, BackgroundQuadCount = 2; // Sun and sky
+
+static constexpr uint32_t QuadCount = 19;
+
+// Quads earlier in the vertex array are in front of later ones. Returns the
+// normalized depth used for sorting, with 0 nearest the viewer.
+static float QuadDepth(uint32_t quad)
+{
+	return (quad + 1) / (float)(QuadCount + 1);
+}
+
+// The distant village sits between the ground (quad 10) and the far ground (quad 11)
+static constexpr float DistantVillageNearDepth = 11.1f / (QuadCount + 1);
+static constexpr float DistantVillageFarDepth = 11.9f / (QuadCount + 1);
+static constexpr uint32_t DistantVillageRows = 12;
+
+static float DepthToZ(float depth)
+{
+	// The camera looks down -z with its near plane at z = 1
+	return 1.0f - 2.0f * depth;
+}
+
+uint64_t VillageLayer::MakeSortKey(float depth, GLuint shader) const
+{
+	// Painter's order draws back to front, so invert depth to sort far draws first
+	if (m_DrawOrder == DrawOrder::Painters)
+		depth = 1.0f - depth;
+	return DrawKey::Make(0, false, depth, shader);
+}
+
+void VillageLayer::SubmitQuads(uint32_t first, uint32_t count)
+{
+	GLuint shader = m_SceneShaders->Get(m_ShowOverdraw ? m_OverdrawBit : 0)->GetRendererID();
+	MeshDraw mesh = m_MeshHeap->GetDraw(m_QuadMesh);
+	for (uint32_t quad = first; quad < first + count; quad++)
+	{
+		DrawItem item;
+		item.Key = MakeSortKey(QuadDepth(quad), shader);
+		item.VertexArray = mesh.VertexArray;
+		item.Shader = shader;
+		item.FirstIndex = mesh.FirstIndex + quad * 6;
+		item.IndexCount = 6;
+		item.BaseVertex = mesh.BaseVertex;
+		m_DrawQueue.Submit(item);
+	}
+}
+
+void VillageLayer::SubmitPrefabs(const glm::vec4& worldBounds)
+{
+	GLuint shader = m_SceneShaders->Get(m_InstancedBit | (m_ShowOverdraw ? m_OverdrawBit : 0))->GetRendererID();
+
+	// Trees are planted in front of the houses in the same row
+	float middle = (DistantVillageNearDepth + DistantVillageFarDepth) * 0.5f;
+	m_HousePrefab->Prepare(worldBounds);
+	m_DrawQueue.Submit(m_HousePrefab->GetDrawItem(MakeSortKey(middle + 0.001f, shader), shader));
+	m_TreePrefab->Prepare(worldBounds);
+	m_DrawQueue.Submit(m_TreePrefab->GetDrawItem(MakeSortKey(middle - 0.001f, shader), shader));
+}
+
+void VillageLayer::FlushDraws()
+{
+	if (m_DrawOrder == DrawOrder::FrontToBack)
+	{
+		m_DrawQueue.Flush();
+		return;
+	}
+
+	glDisable(GL_DEPTH_TEST);
+	m_DrawQueue.Flush();
+	glEnable(GL_DEPTH_TEST);
+}
+
+// Builds a prefab from quads given as 4 corners each, the first quad being in front.
+// Positions are relative to the anchor, which becomes the prefab's origin.
+static std::unique_ptr<Prefab> CreateQuadPrefab(const std::vector<PrefabVertex>& quads, const glm::vec2& anchor)
+{
+	std::vector<PrefabVertex> vertices = quads;
+	uint32_t quadCount = (uint32_t)vertices.size() / 4;
+	for (uint32_t quad = 0; quad < quadCount; quad++)
+	{
+		for (uint32_t corner = 0; corner < 4; corner++)
+		{
+			PrefabVertex& vertex = vertices[quad * 4 + corner];
+			vertex.Position = { vertex.Position.x - anchor.x, vertex.Position.y - anchor.y, -0.0002f * quad };
+		}
+	}
+
+	// Indexed back to front so the prefab also looks right with depth testing off
+	std::vector<uint32_t> indices;
+	for (uint32_t quad = quadCount; quad-- > 0;)
+	{
+		uint32_t offset = quad * 4;
+		indices.insert(indices.end(), { offset + 0, offset + 1, offset + 2, offset + 2, offset + 3, offset + 0 });
+	}
+	return std::make_unique<Prefab>(vertices, indices);
+}
+
+void VillageLayer::CreatePrefabs()
+{
+	// Same shapes as the house and tree in OnUpdate
+	const glm::vec4 trunk = { 0.70f, 0.50f, 0.30f, 1.0f }, glass = { 0.40f, 0.45f, 0.60f, 1.0f };
+	const glm::vec4 leaves = { 0.20f, 0.60f, 0.18f, 1.0f }, roofSide = { 0.25f, 0.25f, 0.35f, 1.0f };
+	const glm::vec4 wallFront = { 0.85f, 0.85f, 0.85f, 1.0f }, wallSide = { 0.55f, 0.55f, 0.55f, 1.0f };
+
+	m_HousePrefab = CreateQuadPrefab({
+		// Door
+		{ { 830.0f, 550.0f, 0.0f }, trunk }, { { 910.0f, 550.0f, 0.0f }, trunk }, { { 910.0f, 430.0f, 0.0f }, trunk }, { { 830.0f, 430.0f, 0.0f }, trunk },
+		// Window - front
+		{ { 940.0f, 490.0f, 0.0f }, glass }, { { 995.0f, 490.0f, 0.0f }, glass }, { { 995.0f, 440.0f, 0.0f }, glass }, { { 940.0f, 440.0f, 0.0f }, glass },
+		// Window - side
+		{ { 1060.0f, 500.0f, 0.0f }, glass }, { { 1110.0f, 500.0f, 0.0f }, glass }, { { 1110.0f, 410.0f, 0.0f }, glass }, { { 1060.0f, 410.0f, 0.0f }, glass },
+		// Wall - front
+		{ { 720.0f, 550.0f, 0.0f }, wallFront }, { { 1020.0f, 550.0f, 0.0f }, wallFront }, { { 1020.0f, 350.0f, 0.0f }, wallFront }, { { 720.0f, 350.0f, 0.0f }, wallFront },
+		// Wall - side
+		{ { 1020.0f, 550.0f, 0.0f }, wallSide }, { { 1150.0f, 550.0f, 0.0f }, wallSide }, { { 1150.0f, 350.0f, 0.0f }, wallSide }, { { 1020.0f, 350.0f, 0.0f }, wallSide },
+		// Roof - front
+		{ { 720.0f, 350.0f, 0.0f }, glass }, { { 1020.0f, 350.0f, 0.0f }, glass }, { { 1090.0f, 240.0f, 0.0f }, glass }, { { 790.0f, 240.0f, 0.0f }, glass },
+		// Roof - side
+		{ { 1020.0f, 350.0f, 0.0f }, roofSide }, { { 1150.0f, 350.0f, 0.0f }, roofSide }, { { 1090.0f, 240.0f, 0.0f }, roofSide }, { { 1090.0f, 240.0f, 0.0f }, roofSide },
+	}, { 935.0f, 550.0f });
+
+	m_TreePrefab = CreateQuadPrefab({
+		// Leaves - Square 1 (Rotated)
+		{ { 125.0f, 490.0f, 0.0f }, leaves }, { { 195.0f, 415.0f, 0.0f }, leaves }, { { 125.0f, 340.0f, 0.0f }, leaves }, { { 55.0f, 415.0f, 0.0f }, leaves },
+		// Leaves - Square 2 (Straight)
+		{ { 80.0f, 470.0f, 0.0f }, leaves }, { { 170.0f, 470.0f, 0.0f }, leaves }, { { 170.0f, 380.0f, 0.0f }, leaves }, { { 80.0f, 380.0f, 0.0f }, leaves },
+		// Trunk
+		{ { 110.0f, 540.0f, 0.0f }, trunk }, { { 140.0f, 540.0f, 0.0f }, trunk }, { { 140.0f, 470.0f, 0.0f }, trunk }, { { 110.0f, 470.0f, 0.0f }, trunk },
+	}, { 125.0f, 540.0f });
+
+	PopulateDistantVillage();
+
+	// The procedural village is seen from above, in unit sizes scaled per instance
+	const glm::vec4 road = { 0.62f, 0.56f, 0.46f, 1.0f }, chimney = { 0.45f, 0.40f, 0.40f, 1.0f };
+	const glm::vec4 roofLit = { 1.0f, 1.0f, 1.0f, 1.0f }, roofShaded = { 0.72f, 0.72f, 0.72f, 1.0f }, ridge = { 0.55f, 0.55f, 0.55f, 1.0f };
+	const glm::vec4 leavesLit = { 0.34f, 0.72f, 0.28f, 1.0f }, leavesDark = { 0.14f, 0.42f, 0.14f, 1.0f };
+
+	m_RoadPrefab = CreateQuadPrefab({
+		{ { 0.0f, 1.0f, 0.0f }, road }, { { 1.0f, 1.0f, 0.0f }, road }, { { 1.0f, 0.0f, 0.0f }, road }, { { 0.0f, 0.0f, 0.0f }, road },
+	}, { 0.0f, 0.0f });
+
+	// A gable roof with its ridge running left to right, lit from the top
+	m_RoofPrefab = CreateQuadPrefab({
+		// Chimney
+		{ { 0.70f, 0.32f, 0.0f }, chimney }, { { 0.80f, 0.32f, 0.0f }, chimney }, { { 0.80f, 0.16f, 0.0f }, chimney }, { { 0.70f, 0.16f, 0.0f }, chimney },
+		// Ridge
+		{ { 0.0f, 0.53f, 0.0f }, ridge }, { { 1.0f, 0.53f, 0.0f }, ridge }, { { 1.0f, 0.47f, 0.0f }, ridge }, { { 0.0f, 0.47f, 0.0f }, ridge },
+		// Roof - top slope
+		{ { 0.0f, 0.5f, 0.0f }, roofLit }, { { 1.0f, 0.5f, 0.0f }, roofLit }, { { 1.0f, 0.0f, 0.0f }, roofLit }, { { 0.0f, 0.0f, 0.0f }, roofLit },
+		// Roof - bottom slope
+		{ { 0.0f, 1.0f, 0.0f }, roofShaded }, { { 1.0f, 1.0f, 0.0f }, roofShaded }, { { 1.0f, 0.5f, 0.0f }, roofShaded }, { { 0.0f, 0.5f, 0.0f }, roofShaded },
+	}, { 0.0f, 0.0f });
+
+	// Same two squares as the tree's leaves, centered with a radius of one
+	m_CanopyPrefab = CreateQuadPrefab({
+		// Leaves - Square 2 (Straight)
+		{ { -0.64f, 0.64f, 0.0f }, leavesLit }, { { 0.64f, 0.64f, 0.0f }, leavesLit }, { { 0.64f, -0.64f, 0.0f }, leavesLit }, { { -0.64f, -0.64f, 0.0f }, leavesLit },
+		// Leaves - Square 1 (Rotated)
+		{ { 0.0f, 1.0f, 0.0f }, leavesDark }, { { 1.0f, 0.0f, 0.0f }, leavesDark }, { { 0.0f, -1.0f, 0.0f }, leavesDark }, { { -1.0f, 0.0f, 0.0f }, leavesDark },
+	}, { 0.0f, 0.0f });
+}
+
+void VillageLayer::PopulateDistantVillage()
+{
+	std::vector<PrefabInstance>& houses = m_HousePrefab->GetInstances();
+	std::vector<PrefabInstance>& trees = m_TreePrefab->GetInstances();
+	houses.clear();
+	trees.clear();
+
+	// Rows run from the horizon towards the viewer, so instances are stored back
+	// to front. Columns extend far beyond the screen and are culled per frame.
+	uint32_t columns = (m_DistantHouseCount + DistantVillageRows - 1) / DistantVillageRows;
+	uint32_t seed = 1;
+	auto random = [&seed]()
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / (float)(1u << 24);
+	};
+
+	for (uint32_t row = 0; row < DistantVillageRows && houses.size() < m_DistantHouseCount; row++)
+	{
+		float nearness = row / (float)(DistantVillageRows - 1);
+		float y = 320.0f + nearness * 150.0f;
+		float scale = 0.06f + nearness * 0.06f;
+		float z = DepthToZ(DistantVillageFarDepth + (DistantVillageNearDepth - DistantVillageFarDepth) * nearness);
+		float spacing = 480.0f * scale;
+		float start = 640.0f - columns * spacing * 0.5f;
+
+		for (uint32_t column = 0; column < columns && houses.size() < m_DistantHouseCount; column++)
+		{
+			float x = start + column * spacing + random() * spacing * 0.3f;
+			float shade = 0.85f + random() * 0.15f;
+
+			PrefabInstance& house = houses.emplace_back();
+			house.Position = { x, y, z };
+			house.Scale = { scale, scale };
+			house.Tint = { shade, shade, shade, 1.0f };
+
+			PrefabInstance& tree = trees.emplace_back();
+			tree.Position = { x + spacing * 0.5f, y + 2.0f, z };
+			tree.Scale = { scale * (random() < 0.5f ? -1.0f : 1.0f), scale * (0.8f + random() * 0.4f) };
+		}
+	}
+}
+
+// The procedural village replaces the scene, so it has the whole depth range
+static constexpr float VillageRoadDepth = 0.9f;
+static constexpr float VillageRoofDepth = 0.5f;
+static constexpr float VillageCanopyDepth = 0.3f;
+
+void VillageLayer::PopulateProceduralVillage()
+{
+	// Indexed by VillageHouse::Roof: terracotta, slate, thatch, moss, brick and lead
+	const glm::vec4 roofColors[VillageGenerator::RoofStyleCount] = {
+		{ 0.80f, 0.42f, 0.28f, 1.0f }, { 0.38f, 0.42f, 0.52f, 1.0f }, { 0.78f, 0.66f, 0.40f, 1.0f },
+		{ 0.42f, 0.52f, 0.34f, 1.0f }, { 0.62f, 0.26f, 0.22f, 1.0f }, { 0.56f, 0.58f, 0.60f, 1.0f },
+	};
+
+	std::vector<PrefabInstance>& roads = m_RoadPrefab->GetInstances();
+	std::vector<PrefabInstance>& roofs = m_RoofPrefab->GetInstances();
+	std::vector<PrefabInstance>& canopies = m_CanopyPrefab->GetInstances();
+	roads.clear();
+	roofs.clear();
+	canopies.clear();
+
+	float roadZ = DepthToZ(VillageRoadDepth), roofZ = DepthToZ(VillageRoofDepth), canopyZ = DepthToZ(VillageCanopyDepth);
+	for (const auto& [key, chunk] : m_VillageStreamer->GetChunks())
+	{
+		float originX = (float)chunk.X * VillageGenerator::ChunkSize, originY = (float)chunk.Y * VillageGenerator::ChunkSize;
+
+		for (const VillageRect& rect : chunk.Roads)
+		{
+			PrefabInstance& road = roads.emplace_back();
+			road.Position = { originX + rect.X, originY + rect.Y, roadZ };
+			road.Scale = { (float)rect.Width, (float)rect.Height };
+		}
+
+		for (const VillageHouse& house : chunk.Houses)
+		{
+			PrefabInstance& roof = roofs.emplace_back();
+			roof.Position = { originX + house.Footprint.X, originY + house.Footprint.Y, roofZ };
+			roof.Scale = { (float)house.Footprint.Width, (float)house.Footprint.Height };
+			roof.Tint = roofColors[house.Roof % VillageGenerator::RoofStyleCount];
+		}
+
+		for (const VillageTree& tree : chunk.Trees)
+		{
+			float shade = 0.75f + tree.Shade / 255.0f * 0.4f;
+			PrefabInstance& canopy = canopies.emplace_back();
+			canopy.Position = { originX + tree.X, originY + tree.Y, canopyZ };
+			canopy.Scale = { (float)tree.Radius, (float)tree.Radius };
+			canopy.Tint = { shade, shade, shade, 1.0f };
+		}
+	}
+}
+
+void VillageLayer::SubmitProceduralVillage(const glm::vec4& worldBounds)
+{
+	GLuint shader = m_SceneShaders->Get(m_InstancedBit | (m_ShowOverdraw ? m_OverdrawBit : 0))->GetRendererID();
+
+	m_RoadPrefab->Prepare(worldBounds);
+	m_DrawQueue.Submit(m_RoadPrefab->GetDrawItem(MakeSortKey(VillageRoadDepth, shader), shader));
+	m_RoofPrefab->Prepare(worldBounds);
+	m_DrawQueue.Submit(m_RoofPrefab->GetDrawItem(MakeSortKey(VillageRoofDepth, shader), shader));
+	m_CanopyPrefab->Prepare(worldBounds);
+	m_DrawQueue.Submit(m_CanopyPrefab->GetDrawItem(MakeSortKey(VillageCanopyDepth, shader), shader));
+}
+
+// WASD, in world space where y points down
+static glm::vec2 GetPanDirection()
+{
+	glm::vec2 direction = { 0.0f, 0.0f };
+	if (Input::IsKeyPressed(HZ_KEY_A))
+		direction.x -= 1.0f;
+	if (Input::IsKeyPressed(HZ_KEY_D))
+		direction.x += 1.0f;
+	if (Input::IsKeyPressed(HZ_KEY_W))
+		direction.y -= 1.0f;
+	if (Input::IsKeyPressed(HZ_KEY_S))
+		direction.y += 1.0f;
+	return direction;
+}
+
+void VillageLayer::UpdateProceduralVillage(Timestep ts)
+{
+	// The camera controller moves a few pixels per second, far too slow to
+	// cross a chunk, so this view pans the camera itself
+	glm::vec2 direction = GetPanDirection();
+	if (m_AutoPan && direction.x == 0.0f && direction.y == 0.0f)
+		direction = { 1.0f, 0.4f };
+	float distance = m_PanSpeed * ts.GetSeconds();
+	m_VillageCameraPosition[0] += direction.x * distance;
+	m_VillageCameraPosition[1] += direction.y * distance;
+
+	OrthographicCamera& camera = m_CameraController.GetCamera();
+	camera.SetPosition({ m_VillageCameraPosition[0], m_VillageCameraPosition[1], 0.0f });
+	if (m_VillageStreamer->Update(camera.GetWorldBounds()))
+	{
+		PopulateProceduralVillage();
+		m_FullRedrawRequested = true;
+	}
 }
 
 static float KeepLocationWithinBounds(float& val, float min, float max)
@@ -168,9 +495,187 @@ static float KeepLocationWithinBounds(float& val, float min, float max)
 	return val;
 }
 
+static float Interpolate(float previous, float current, float alpha)
+{
+	return previous + (current - previous) * alpha;
+}
+
+static void Advance(float& offset, float& previous, float speed, float seconds, const int borders[2])
+{
+	previous = offset;
+	offset += speed * seconds;
+
+	// Don't interpolate across the screen when wrapping around
+	float unwrapped = offset;
+	KeepLocationWithinBounds(offset, (float)borders[0], (float)borders[1]);
+	if (offset != unwrapped)
+		previous = offset;
+}
+
+// Extents of the moving sprites relative to their offsets, see the vertices in OnUpdate
+static const DamageRect SmallCloudExtent = { 0.0f, 75.0f, 165.0f, 120.0f };
+static const DamageRect BirdsExtent = { 0.0f, 35.0f, 190.0f, 120.0f };
+static const DamageRect BigCloudExtent = { 0.0f, 20.0f, 245.0f, 100.0f };
+
+static DamageRect SweptBounds(const DamageRect& extent, float previousX, float currentX, float offsetY)
+{
+	return {
+		std::min(previousX, currentX) + extent.MinX, offsetY + extent.MinY,
+		std::max(previousX, currentX) + extent.MaxX, offsetY + extent.MaxY
+	};
+}
+
+void VillageLayer::OnFixedUpdate(Timestep ts)
+{
+	Advance(m_BigCloudOffset[0], m_BigCloudPreviousX, m_BigCloudSpeed, ts, m_Borders);
+	Advance(m_SmallCloudOffset[0], m_SmallCloudPreviousX, m_SmallCloudSpeed, ts, m_Borders);
+	Advance(m_BirdsOffset[0], m_BirdsPreviousX, m_BirdSpeed, ts, m_Borders);
+
+	// Light changes everywhere with the day cycle. Damaged here, as on demand
+	// a frame without damage is skipped before OnUpdate ever runs.
+	if (m_LightingEnabled && m_DayLength > 0.0f)
+	{
+		m_TimeOfDay = std::fmod(m_TimeOfDay + ts.GetSeconds() / m_DayLength, 1.0f);
+		Application::Get().GetDamage().AddFull();
+	}
+
+	// Until the next step, sprites are drawn anywhere between their previous and
+	// current positions. Damage that sweep, plus the previous step's sweep where
+	// they were last drawn.
+	AddSweptDamage(m_BigCloudSweep, SweptBounds(BigCloudExtent, m_BigCloudPreviousX, m_BigCloudOffset[0], m_BigCloudOffset[1]));
+	AddSweptDamage(m_SmallCloudSweep, SweptBounds(SmallCloudExtent, m_SmallCloudPreviousX, m_SmallCloudOffset[0], m_SmallCloudOffset[1]));
+	AddSweptDamage(m_BirdsSweep, SweptBounds(BirdsExtent, m_BirdsPreviousX, m_BirdsOffset[0], m_BirdsOffset[1]));
+
+	// Particles step with the frame in OnUpdate and aren't tracked as damage,
+	// so keep frames coming while any are alive or an emitter is running
+	if (m_Particles->GetLiveCount() > 0 || m_Weather != Weather::Clear || m_ChimneySmoke)
+		Application::Get().GetDamage().AddFull();
+
+	// Panning, and chunks that are still on their way, change the whole view
+	if (m_ProceduralVillage)
+	{
+		glm::vec2 direction = GetPanDirection();
+		if (m_AutoPan || direction.x != 0.0f || direction.y != 0.0f || m_VillageStreamer->GetStats().PendingChunks > 0)
+			Application::Get().GetDamage().AddFull();
+	}
+}
+
+void VillageLayer::AddSweptDamage(DamageRect& lastSweep, const DamageRect& sweep)
+{
+	bool unchanged = sweep.MinX == lastSweep.MinX && sweep.MinY == lastSweep.MinY
+		&& sweep.MaxX == lastSweep.MaxX && sweep.MaxY == lastSweep.MaxY;
+	if (!unchanged)
+	{
+		AddWorldDamage(lastSweep);
+		AddWorldDamage(sweep);
+	}
+	lastSweep = sweep;
+}
+
+void VillageLayer::AddWorldDamage(const DamageRect& rect)
+{
+	if (rect.IsEmpty())
+		return;
+
+	// Project to framebuffer pixels, which have their origin at the bottom left
+	const glm::mat4& viewProjection = m_CameraController.GetCamera().GetViewProjectionMatrix();
+	Window& window = Application::Get().GetWindow();
+	float width = (float)window.GetWidth(), height = (float)window.GetHeight();
+
+	DamageRect pixels = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+		std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	const glm::vec2 corners[] = { { rect.MinX, rect.MinY }, { rect.MaxX, rect.MinY }, { rect.MaxX, rect.MaxY }, { rect.MinX, rect.MaxY } };
+	for (const glm::vec2& corner : corners)
+	{
+		glm::vec4 clip = viewProjection * glm::vec4(corner.x, corner.y, 0.0f, 1.0f);
+		float x = (clip.x * 0.5f + 0.5f) * width;
+		float y = (clip.y * 0.5f + 0.5f) * height;
+		pixels = pixels.Union({ x, y, x, y });
+	}
+
+	// Pad for rasterization of edges that fall between pixels
+	Application::Get().GetDamage().Add({ pixels.MinX - 1.0f, pixels.MinY - 1.0f, pixels.MaxX + 1.0f, pixels.MaxY + 1.0f });
+}
+
+static uint32_t TakeEmitCount(float rate, float dt, float& accumulator)
+{
+	accumulator += rate * dt;
+	uint32_t count = (uint32_t)accumulator;
+	accumulator -= count;
+	return count;
+}
+
+void VillageLayer::UpdateWeather(Timestep ts)
+{
+	float dt = ts;
+
+	if (m_Weather == Weather::Rain)
+	{
+		// Thin streaks that cross the view in under a second; spawned wide so wind doesn't leave a gap
+		ParticleProps rain;
+		rain.Position = { DesignWidth * 0.5f - m_Wind * 0.5f, -20.0f };
+		rain.PositionVariation = { DesignWidth + std::abs(m_Wind) * 2.0f, 20.0f };
+		rain.Velocity = { m_Wind, 900.0f };
+		rain.VelocityVariation = { 20.0f, 200.0f };
+		rain.Size = { 1.5f, 14.0f };
+		rain.SizeVariation = 0.4f;
+		rain.Color = { 0.70f, 0.75f, 0.90f, 0.5f };
+		rain.Lifetime = 0.9f;
+		rain.LifetimeVariation = 0.3f;
+		m_Particles->Emit(rain, TakeEmitCount(m_WeatherRate, dt, m_WeatherAccumulator));
+	}
+	else if (m_Weather == Weather::Snow)
+	{
+		ParticleProps snow;
+		snow.Position = { DesignWidth * 0.5f - m_Wind * 6.0f, -10.0f };
+		snow.PositionVariation = { DesignWidth + std::abs(m_Wind) * 12.0f, 10.0f };
+		snow.Velocity = { m_Wind * 0.5f, 60.0f };
+		snow.VelocityVariation = { 40.0f, 30.0f };
+		snow.Size = { 3.0f, 3.0f };
+		snow.SizeVariation = 0.6f;
+		snow.Color = { 1.0f, 1.0f, 1.0f, 0.9f };
+		snow.Lifetime = 12.0f;
+		snow.LifetimeVariation = 4.0f;
+		m_Particles->Emit(snow, TakeEmitCount(m_WeatherRate * 0.1f, dt, m_WeatherAccumulator));
+	}
+
+	if (m_ChimneySmoke)
+	{
+		// Rises from the back of the roof, spreading and thinning as it goes
+		ParticleProps smoke;
+		smoke.Position = { 1050.0f, 250.0f };
+		smoke.PositionVariation = { 12.0f, 4.0f };
+		smoke.Velocity = { m_Wind * 0.3f, -40.0f };
+		smoke.VelocityVariation = { 12.0f, 12.0f };
+		smoke.Gravity = -6.0f;
+		smoke.Size = { 10.0f, 10.0f };
+		smoke.SizeVariation = 0.4f;
+		smoke.Growth = 18.0f;
+		smoke.Color = { 0.55f, 0.55f, 0.58f, 0.35f };
+		smoke.Lifetime = 4.0f;
+		smoke.LifetimeVariation = 2.0f;
+		m_Particles->Emit(smoke, TakeEmitCount(40.0f, dt, m_SmokeAccumulator));
+	}
+
+	m_Particles->Update(ts);
+}
+
 void VillageLayer::OnUpdate(Timestep ts)
 {
-	m_CameraController.OnUpdate(ts);
+	// The controller puts the camera back where it left it once the village view is closed
+	if (m_ProceduralVillage)
+		UpdateProceduralVillage(ts);
+	else
+		m_CameraController.OnUpdate(ts);
+	// Particles step with the frame rather than the fixed update, as there
+	// are too many to keep a previous position for interpolation
+	UpdateWeather(ts);
+
+	// Moving sprites are drawn between their last two simulation steps
+	float alpha = Application::Get().GetFixedUpdateAlpha();
+	float birdsOffset[2] = { Interpolate(m_BirdsPreviousX, m_BirdsOffset[0], alpha), m_BirdsOffset[1] };
+	float bigCloudOffset[2] = { Interpolate(m_BigCloudPreviousX, m_BigCloudOffset[0], alpha), m_BigCloudOffset[1] };
+	float smallCloudOffset[2] = { Interpolate(m_SmallCloudPreviousX, m_SmallCloudOffset[0], alpha), m_SmallCloudOffset[1] };
 	
 	// Vertices.
 	// Keep in mind that the window is 1280x720 (0.0, 0.0 is TOP LEFT corner)
@@ -243,33 +748,33 @@ void VillageLayer::OnUpdate(Timestep ts)
 		0.0f,	312.0f,	0.0f,	0.8f, 0.9f, 0.5f, 1.0f, 0.0f, 0.0f, 0.0f,
 
 		// Cloud - Small
-		m_SmallCloudOffset[0] + 0.0f, m_SmallCloudOffset[1] + 120.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_SmallCloudOffset[0] + 165.0f, m_SmallCloudOffset[1] + 120.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_SmallCloudOffset[0] + 165.0f, m_SmallCloudOffset[1] + 75.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_SmallCloudOffset[0] + 0.0f, m_SmallCloudOffset[1] + 75.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
+		smallCloudOffset[0] + 0.0f, smallCloudOffset[1] + 120.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
+		smallCloudOffset[0] + 165.0f, smallCloudOffset[1] + 120.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
+		smallCloudOffset[0] + 165.0f, smallCloudOffset[1] + 75.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
+		smallCloudOffset[0] + 0.0f, smallCloudOffset[1] + 75.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
 
 		// Birds
 		// Bird 1
-		m_BirdsOffset[0] + 165.0f, m_BirdsOffset[1] + 120.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 165.0f, m_BirdsOffset[1] + 70.0f, 0.0f, 0.99f, 0.50f, 0.47f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 190.0f, m_BirdsOffset[1] + 90.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 105.0f, m_BirdsOffset[1] + 90.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 165.0f, birdsOffset[1] + 120.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 165.0f, birdsOffset[1] + 70.0f, 0.0f, 0.99f, 0.50f, 0.47f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 190.0f, birdsOffset[1] + 90.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 105.0f, birdsOffset[1] + 90.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
 		// Bird 3
-		m_BirdsOffset[0] + 115.0f, m_BirdsOffset[1] + 71.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 115.0f, m_BirdsOffset[1] + 35.0f, 0.0f, 0.99f, 0.50f, 0.47f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 135.0f, m_BirdsOffset[1] + 50.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 85.0f, m_BirdsOffset[1] + 50.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 115.0f, birdsOffset[1] + 71.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 115.0f, birdsOffset[1] + 35.0f, 0.0f, 0.99f, 0.50f, 0.47f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 135.0f, birdsOffset[1] + 50.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 85.0f, birdsOffset[1] + 50.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
 		// Bird 2
-		m_BirdsOffset[0] + 40.0f, m_BirdsOffset[1] + 90.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 40.0f, m_BirdsOffset[1] + 55.0f, 0.0f, 0.99f, 0.50f, 0.47f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 60.0f, m_BirdsOffset[1] + 70.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BirdsOffset[0] + 0.0f, m_BirdsOffset[1] + 70.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 40.0f, birdsOffset[1] + 90.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 40.0f, birdsOffset[1] + 55.0f, 0.0f, 0.99f, 0.50f, 0.47f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 60.0f, birdsOffset[1] + 70.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
+		birdsOffset[0] + 0.0f, birdsOffset[1] + 70.0f, 0.0f, 0.95f, 0.47f, 0.43f, 1.0f, 0.0f, 0.0f, 0.0f,
 
 		// Cloud - Big
-		m_BigCloudOffset[0] + 0.0f, m_BigCloudOffset[1] + 100.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BigCloudOffset[0] + 245.0f, m_BigCloudOffset[1] + 100.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BigCloudOffset[0] + 245.0f, m_BigCloudOffset[1] + 20.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
-		m_BigCloudOffset[0] + 0.0f, m_BigCloudOffset[1] + 20.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
+		bigCloudOffset[0] + 0.0f, bigCloudOffset[1] + 100.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
+		bigCloudOffset[0] + 245.0f, bigCloudOffset[1] + 100.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
+		bigCloudOffset[0] + 245.0f, bigCloudOffset[1] + 20.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
+		bigCloudOffset[0] + 0.0f, bigCloudOffset[1] + 20.0f, 0.0f, 0.95f, 0.95f, 0.95f, 1.0f, 0.0f, 0.0f, 0.0f,
 
 		// Sun - straight
 		72.0f, 40.0f, 0.0f, 1.00f, 0.83f, 0.47f, 1.0f, 0.0f, 0.0f, 0.0f,
@@ -284,43 +789,333 @@ void VillageLayer::OnUpdate(Timestep ts)
 		0.0f,	0.0f,	0.0f, 0.73f, 0.84f, 0.83f, 1.0f, 0.0f, 0.0f, 0.0f,
 	};
 
-	m_BigCloudOffset[0] += m_BigCloudSpeed;
-	KeepLocationWithinBounds(m_BigCloudOffset[0], m_Borders[0], m_Borders[1]);
-	m_SmallCloudOffset[0] += m_SmallCloudSpeed;
-	KeepLocationWithinBounds(m_SmallCloudOffset[0], m_Borders[0], m_Borders[1]);
-	m_BirdsOffset[0] += m_BirdSpeed;
-	KeepLocationWithinBounds(m_BirdsOffset[0], m_Borders[0], m_Borders[1]);
+	// Each vertex is 10 floats, and a quad's z places it in front of the quads after it
+	for (uint32_t quad = 0; quad < QuadCount; quad++)
+	{
+		for (uint32_t vertex = 0; vertex < 4; vertex++)
+			vertices[(quad * 4 + vertex) * 10 + 2] = DepthToZ(QuadDepth(quad));
+	}
+
+	m_MeshHeap->UpdateVertices(m_QuadMesh, vertices, (uint32_t)(sizeof(vertices) / sizeof(Vertex)));
+
+	FrameGraph& graph = Application::Get().GetFrameGraph();
+	if (m_ShowOverdraw)
+	{
+		AddOverdrawPasses(graph);
+		return;
+	}
+
+	// The scene is drawn at a reduced resolution when the GPU is over budget,
+	// then stretched over the window. ImGui is drawn after, at full resolution.
+	// At full scale, or with scaling off, it goes straight to the window.
+	Window& window = Application::Get().GetWindow();
+	uint32_t sceneWidth, sceneHeight;
+	m_DynamicResolution->GetScaledSize(window.GetWidth(), window.GetHeight(), sceneWidth, sceneHeight);
+	if (sceneWidth == window.GetWidth() && sceneHeight == window.GetHeight())
+	{
+		graph.AddPass("Village",
+			[&](FrameGraphBuilder& builder) { builder.Write(graph.GetBackbuffer()); },
+			[this, &window](const FrameGraphResources&)
+			{
+				m_DynamicResolution->BeginTiming();
+				RenderVillage(window.GetWidth(), window.GetHeight());
+				m_DynamicResolution->EndTiming();
+			});
+		return;
+	}
+
+	graph.AddPass("Village",
+		[&](FrameGraphBuilder& builder)
+		{
+			m_SceneColor = builder.Write(builder.CreateTexture("Scene color", { sceneWidth, sceneHeight, GL_RGBA8 }));
+			builder.WriteDepth(builder.CreateTexture("Scene depth", { sceneWidth, sceneHeight, GL_DEPTH24_STENCIL8 }));
+		},
+		[this, sceneWidth, sceneHeight](const FrameGraphResources&)
+		{
+			m_DynamicResolution->BeginTiming();
+			RenderVillage(sceneWidth, sceneHeight);
+		});
+
+	graph.AddPass("Upscale",
+		[&](FrameGraphBuilder& builder)
+		{
+			builder.Read(m_SceneColor);
+			builder.Write(graph.GetBackbuffer());
+		},
+		[this](const FrameGraphResources& resources)
+		{
+			// Scene textures are linearly filtered, so this is a bilinear upscale
+			glDisable(GL_DEPTH_TEST);
+			glDisable(GL_BLEND);
+			glUseProgram(m_CompositeShader->GetRendererID());
+			glBindTextureUnit(0, resources.GetTexture(m_SceneColor));
+			glBindVertexArray(m_FullscreenVA);
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			glEnable(GL_BLEND);
+			glEnable(GL_DEPTH_TEST);
+			m_DynamicResolution->EndTiming();
+		});
+}
+
+void VillageLayer::SubmitLights()
+{
+	// Daylight rises and sets with the sun; the windows light up as it fades
+	float sunHeight = -std::cos(m_TimeOfDay * 6.2831853f);
+	float daylight = glm::clamp((sunHeight + 0.2f) / 0.5f, 0.0f, 1.0f);
+	glm::vec3 night = { 0.10f, 0.12f, 0.28f };
+	m_Lighting->SetAmbient(glm::mix(night, glm::vec3(1.0f), daylight));
+	m_Lighting->Begin();
+	if (daylight >= 1.0f)
+		return;
+
+	glm::vec3 windowColor = glm::vec3(1.0f, 0.72f, 0.38f) * (1.0f - daylight) * 1.6f;
+
+	// Seen from above, each procedural house glows through its roof
+	if (m_ProceduralVillage)
+	{
+		for (const PrefabInstance& roof : m_RoofPrefab->GetInstances())
+		{
+			glm::vec2 center = { roof.Position.x + roof.Scale.x * 0.5f, roof.Position.y + roof.Scale.y * 0.5f };
+			m_Lighting->Submit({ center, std::max(roof.Scale.x, roof.Scale.y) * 1.2f, windowColor });
+		}
+		return;
+	}
+
+	// The house's two windows and a lantern by the door
+	m_Lighting->Submit({ { 967.5f, 465.0f }, 110.0f, windowColor });
+	m_Lighting->Submit({ { 1085.0f, 455.0f }, 110.0f, windowColor });
+	m_Lighting->Submit({ { 870.0f, 415.0f }, 70.0f, windowColor * 0.8f });
+
+	// Both windows of every distant house, relative to the prefab's origin
+	for (const PrefabInstance& house : m_HousePrefab->GetInstances())
+	{
+		glm::vec2 origin = { house.Position.x, house.Position.y };
+		m_Lighting->Submit({ origin + glm::vec2(32.5f, -85.0f) * house.Scale, 110.0f * house.Scale.y, windowColor });
+		m_Lighting->Submit({ origin + glm::vec2(150.0f, -95.0f) * house.Scale, 110.0f * house.Scale.y, windowColor });
+	}
+}
+
+void VillageLayer::RenderVillage(uint32_t width, uint32_t height)
+{
+	const glm::mat4& viewProjection = m_CameraController.GetCamera().GetViewProjectionMatrix();
+
+	// Shared by every program through the frame uniform block
+	FrameUniformBuffer& frameUniforms = Application::Get().GetFrameUniforms();
+	frameUniforms.SetCamera(m_CameraController.GetCamera());
+	frameUniforms.Upload();
+
+	if (m_CacheStaticLayers && !m_ProceduralVillage)
+		UpdateCaches(width, height, viewProjection);
+
+	// Lights don't depend on the scene, so the light target is ready before anything is drawn
+	if (m_LightingEnabled)
+	{
+		SubmitLights();
+		m_Lighting->Render(width, height, viewProjection, *m_LightAccumulateShader);
+	}
+
+	// Damage is tracked in window pixels, so partial redraws only work at native resolution
+	Window& window = Application::Get().GetWindow();
+	if (!Application::Get().IsOnDemandRendering() || width != window.GetWidth() || height != window.GetHeight())
+	{
+		RenderScene();
+		return;
+	}
+
+	// On demand, the scene lives in a persistent target and only the damaged
+	// parts are redrawn before it is copied to the window
+	DamageTracker& damage = Application::Get().GetDamage();
+	bool fullRedraw = m_FullRedrawRequested || damage.IsFull() || viewProjection != m_LastViewProjection
+		|| width != m_SceneFramebuffer->GetSpecification().Width || height != m_SceneFramebuffer->GetSpecification().Height;
+
+	m_SceneFramebuffer->Resize(width, height);
+	m_SceneFramebuffer->Bind();
+	if (fullRedraw)
+	{
+		RenderScene();
+	}
+	else if (!damage.IsEmpty())
+	{
+		glEnable(GL_SCISSOR_TEST);
+		for (size_t i = 0; i < damage.GetRectCount(); i++)
+		{
+			const DamageRect& rect = damage.GetRect(i);
+			GLint x = (GLint)std::floor(rect.MinX), y = (GLint)std::floor(rect.MinY);
+			glScissor(x, y, (GLsizei)std::ceil(rect.MaxX) - x, (GLsizei)std::ceil(rect.MaxY) - y);
+			RenderScene();
+		}
+		glDisable(GL_SCISSOR_TEST);
+	}
+	m_SceneFramebuffer->Unbind();
+
+	glBlitNamedFramebuffer(m_SceneFramebuffer->GetRendererID(), 0,
+		0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_QuadVB);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+	m_LastViewProjection = viewProjection;
+	m_FullRedrawRequested = false;
+}
+
+void VillageLayer::UpdateCaches(uint32_t width, uint32_t height, const glm::mat4& viewProjection)
+{
+	// The static scenery behind and in front of the moving sprites is only
+	// rasterized again when the camera or the window size changes
+	if (m_BackgroundCache->BeginUpdate(width, height, viewProjection))
+	{
+		SubmitQuads(BackgroundFirstQuad, BackgroundQuadCount);
+		FlushDraws();
+		m_BackgroundCache->EndUpdate();
+	}
+	if (m_ForegroundCache->BeginUpdate(width, height, viewProjection))
+	{
+		SubmitQuads(ForegroundFirstQuad, ForegroundQuadCount);
+		SubmitPrefabs(m_CameraController.GetCamera().GetWorldBounds());
+		FlushDraws();
+		m_ForegroundCache->EndUpdate();
+	}
+}
 
-	glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // Blue BG <- MAKE IT BLUE
+void VillageLayer::RenderScene()
+{
+	if (m_ProceduralVillage)
+		glClearColor(0.36f, 0.52f, 0.26f, 1.0f); // Grass between the lots
+	else
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // Blue BG <- MAKE IT BLUE
 	//glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // Grey BG
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	glUseProgram(m_Shader->GetRendererID());
+	if (m_ProceduralVillage)
+	{
+		SubmitProceduralVillage(m_CameraController.GetCamera().GetWorldBounds());
+		FlushDraws();
+	}
+	else if (!m_CacheStaticLayers)
+	{
+		SubmitQuads(0, QuadCount);
+		SubmitPrefabs(m_CameraController.GetCamera().GetWorldBounds());
+		FlushDraws();
+	}
+	else
+	{
+		m_BackgroundCache->Composite(*m_CompositeShader);
+
+		SubmitQuads(MovingFirstQuad, MovingQuadCount);
+		FlushDraws();
+
+		m_ForegroundCache->Composite(*m_CompositeShader);
+	}
+
+	// Weather sits in front of everything, so it's neither sorted nor depth tested
+	if (m_Particles->GetLiveCount() > 0)
+	{
+		glDisable(GL_DEPTH_TEST);
+		glUseProgram(m_ParticleShader->GetRendererID());
+		m_Particles->Render();
+		glEnable(GL_DEPTH_TEST);
+	}
+
+	// The scene keeps test.frag's flat colors; light modulates them afterwards
+	if (m_LightingEnabled)
+		m_Lighting->Composite(*m_CompositeShader);
+}
+
+void VillageLayer::AddOverdrawPasses(FrameGraph& graph)
+{
+	Window& window = Application::Get().GetWindow();
+	uint32_t width = window.GetWidth(), height = window.GetHeight();
+
+	graph.AddPass("Overdraw count",
+		[&](FrameGraphBuilder& builder)
+		{
+			m_OverdrawCount = builder.Write(builder.CreateTexture("Overdraw count", { width, height, GL_R16F }));
+			builder.WriteDepth(builder.CreateTexture("Overdraw depth", { width, height, GL_DEPTH24_STENCIL8 }));
+		},
+		[this](const FrameGraphResources&) { RenderOverdrawCount(); });
+
+	graph.AddPass("Overdraw heatmap",
+		[&](FrameGraphBuilder& builder)
+		{
+			builder.Read(m_OverdrawCount);
+			builder.Write(graph.GetBackbuffer());
+		},
+		[this](const FrameGraphResources& resources)
+		{
+			glDisable(GL_DEPTH_TEST);
+			glUseProgram(m_OverdrawHeatmapShader->GetRendererID());
+			glBindTextureUnit(0, resources.GetTexture(m_OverdrawCount));
+			glBindVertexArray(m_FullscreenVA);
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			glEnable(GL_DEPTH_TEST);
+		});
+}
+
+void VillageLayer::RenderOverdrawCount()
+{
+	// Reads last frame's query so the CPU never waits on the GPU
+	GLuint previousQuery = m_OverdrawQueries[(m_OverdrawFrame + 1) % 2];
+	GLuint available = GL_FALSE;
+	if (m_OverdrawFrame > 0)
+		glGetQueryObjectuiv(previousQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available)
+	{
+		GLuint64 samples = 0;
+		glGetQueryObjectui64v(previousQuery, GL_QUERY_RESULT, &samples);
+		Window& window = Application::Get().GetWindow();
+		m_FragmentsPerPixel = (float)((double)samples / ((double)window.GetWidth() * window.GetHeight()));
+	}
+
+	FrameUniformBuffer& frameUniforms = Application::Get().GetFrameUniforms();
+	frameUniforms.SetCamera(m_CameraController.GetCamera());
+	frameUniforms.Upload();
+
+	for (uint32_t mask : { m_OverdrawBit, m_OverdrawBit | m_InstancedBit })
+	{
+		Ref<Shader> shader = m_SceneShaders->Get(mask);
+		glUseProgram(shader->GetRendererID());
+		SetUniformVec4(shader->GetRendererID(), "u_Increment", { 1.0f, 1.0f, 1.0f, 1.0f });
+	}
+
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// Every fragment that survives the depth test adds one to its pixel
+	glBlendFunc(GL_ONE, GL_ONE);
+	glBeginQuery(GL_SAMPLES_PASSED, m_OverdrawQueries[m_OverdrawFrame % 2]);
 
-	SetUniformMat4(m_Shader->GetRendererID(), "u_ViewProjection", m_CameraController.GetCamera().GetViewProjectionMatrix());
+	if (m_ProceduralVillage)
+	{
+		SubmitProceduralVillage(m_CameraController.GetCamera().GetWorldBounds());
+	}
+	else
+	{
+		SubmitQuads(0, QuadCount);
+		SubmitPrefabs(m_CameraController.GetCamera().GetWorldBounds());
+	}
+	FlushDraws();
 
-	glBindVertexArray(m_QuadVA);
-	glDrawElements(GL_TRIANGLES, 128, GL_UNSIGNED_INT, nullptr);
+	glEndQuery(GL_SAMPLES_PASSED);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	m_OverdrawFrame++;
 }
 
 void VillageLayer::OnImGuiRender()
 {
 	ImGui::Begin("Controls");
-	ImGui::SliderFloat2("Bird offset", m_BirdsOffset, m_Borders[0], m_Borders[1]);
-	ImGui::SliderFloat2("Small cloud offset", m_SmallCloudOffset, m_Borders[0], m_Borders[1]);
-	ImGui::SliderFloat2("Big cloud offset", m_BigCloudOffset, m_Borders[0], m_Borders[1]);
+	// Moving a sprite by hand teleports it, so redraw everything rather than track it
+	if (ImGui::SliderFloat2("Bird offset", m_BirdsOffset, m_Borders[0], m_Borders[1]))
+		m_FullRedrawRequested = true;
+	if (ImGui::SliderFloat2("Small cloud offset", m_SmallCloudOffset, m_Borders[0], m_Borders[1]))
+		m_FullRedrawRequested = true;
+	if (ImGui::SliderFloat2("Big cloud offset", m_BigCloudOffset, m_Borders[0], m_Borders[1]))
+		m_FullRedrawRequested = true;
 
 	ImGui::Spacing();
 	ImGui::Spacing();
 	ImGui::Spacing();
 	ImGui::Spacing();
 
-	ImGui::SliderFloat("Bird speed", &m_BirdSpeed, -5.0f, 5.0f, "%.2f");
-	ImGui::SliderFloat("Small cloud speed", &m_SmallCloudSpeed, -5.0f, 5.0f, "%.2f");
-	ImGui::SliderFloat("Big cloud speed", &m_BigCloudSpeed, -5.0f, 5.0f, "%.2f");
+	ImGui::SliderFloat("Bird speed", &m_BirdSpeed, -300.0f, 300.0f, "%.1f px/s");
+	ImGui::SliderFloat("Small cloud speed", &m_SmallCloudSpeed, -300.0f, 300.0f, "%.1f px/s");
+	ImGui::SliderFloat("Big cloud speed", &m_BigCloudSpeed, -300.0f, 300.0f, "%.1f px/s");
 
 	ImGui::Spacing();
 	ImGui::Spacing();
@@ -328,5 +1123,335 @@ void VillageLayer::OnImGuiRender()
 	ImGui::Spacing();
 
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+	if (ImGui::CollapsingHeader("Render caching"))
+	{
+		if (ImGui::Checkbox("Cache static layers", &m_CacheStaticLayers))
+			m_FullRedrawRequested = true;
+		if (ImGui::Button("Invalidate caches"))
+		{
+			m_BackgroundCache->Invalidate();
+			m_ForegroundCache->Invalidate();
+			m_FullRedrawRequested = true;
+		}
+		ImGui::Text("Cache redraws: background %u, foreground %u", m_BackgroundCache->GetRedrawCount(), m_ForegroundCache->GetRedrawCount());
+	}
+
+	if (ImGui::CollapsingHeader("Draw ordering"))
+	{
+		const char* orders[] = { "Front to back (depth tested)", "Painter's (back to front)" };
+		int order = (int)m_DrawOrder;
+		if (ImGui::Combo("Draw order", &order, orders, IM_ARRAYSIZE(orders)))
+		{
+			m_DrawOrder = (DrawOrder)order;
+			m_BackgroundCache->Invalidate();
+			m_ForegroundCache->Invalidate();
+			m_FullRedrawRequested = true;
+		}
+
+		if (ImGui::Checkbox("Visualize overdraw", &m_ShowOverdraw))
+		{
+			m_OverdrawFrame = 0;
+			m_FullRedrawRequested = true;
+		}
+		if (m_ShowOverdraw)
+			ImGui::Text("Shaded fragments per pixel: %.2f", m_FragmentsPerPixel);
+
+		const DrawQueueStats& stats = m_DrawQueue.GetLastFlushStats();
+		ImGui::Text("Last flush: %u quads, %u draw calls, %u state changes", stats.Items, stats.DrawCalls, stats.StateChanges);
+	}
+
+	if (ImGui::CollapsingHeader("Frame graph"))
+	{
+		const FrameGraph& graph = Application::Get().GetFrameGraph();
+		const FrameGraphStats& stats = graph.GetStats();
+
+		m_ExecutedPasses.clear();
+		m_CulledPasses.clear();
+		graph.GetPassNames(m_ExecutedPasses, m_CulledPasses);
+		for (const char* name : m_ExecutedPasses)
+			ImGui::BulletText("%s", name);
+		for (const char* name : m_CulledPasses)
+			ImGui::BulletText("%s (culled)", name);
+
+		ImGui::Text("Transient textures: %u, backed by %u", stats.TransientTextureCount, stats.PhysicalTextureCount);
+		ImGui::Text("Transient memory: %.2f MiB, %.2f MiB without aliasing",
+			stats.PhysicalMemory / (1024.0f * 1024.0f), stats.TransientMemory / (1024.0f * 1024.0f));
+	}
+
+	if (ImGui::CollapsingHeader("Dynamic resolution"))
+	{
+		bool enabled = m_DynamicResolution->IsEnabled();
+		if (ImGui::Checkbox("Scale scene resolution", &enabled))
+		{
+			m_DynamicResolution->SetEnabled(enabled);
+			m_FullRedrawRequested = true;
+		}
+
+		DynamicResolutionSettings& settings = m_DynamicResolution->GetSettings();
+		ImGui::SliderFloat("GPU budget", &settings.TargetMilliseconds, 1.0f, 33.0f, "%.1f ms");
+
+		Window& window = Application::Get().GetWindow();
+		uint32_t sceneWidth, sceneHeight;
+		m_DynamicResolution->GetScaledSize(window.GetWidth(), window.GetHeight(), sceneWidth, sceneHeight);
+		ImGui::Text("Scene: %ux%u (%.0f%%)", sceneWidth, sceneHeight, m_DynamicResolution->GetScale() * 100.0f);
+		ImGui::Text("Scene GPU time: %.2f ms", m_DynamicResolution->GetGpuMilliseconds());
+		ImGui::Text("Scale changes: %u", m_DynamicResolution->GetScaleChangeCount());
+	}
+
+	if (ImGui::CollapsingHeader("Lighting"))
+	{
+		if (ImGui::Checkbox("Day/night lighting", &m_LightingEnabled))
+			m_FullRedrawRequested = true;
+		if (ImGui::SliderFloat("Time of day", &m_TimeOfDay, 0.0f, 1.0f, "%.2f"))
+			m_FullRedrawRequested = true;
+		ImGui::SliderFloat("Day length", &m_DayLength, 0.0f, 600.0f, "%.0f s");
+
+		const TiledLightingStats& stats = m_Lighting->GetStats();
+		ImGui::Text("Lights: %u submitted, %u visible", stats.Lights, stats.VisibleLights);
+		ImGui::Text("Tiles: %u, %u light/tile pairs, at most %u per tile", stats.Tiles, stats.TileEntries, stats.MaxLightsPerTile);
+		ImGui::Text("Binning: %.3f ms", stats.BinMilliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("Weather"))
+	{
+		const char* weathers[] = { "Clear", "Rain", "Snow" };
+		int weather = (int)m_Weather;
+		if (ImGui::Combo("Weather", &weather, weathers, IM_ARRAYSIZE(weathers)))
+			m_Weather = (Weather)weather;
+		ImGui::SliderFloat("Rate", &m_WeatherRate, 0.0f, 200000.0f, "%.0f particles/s");
+		ImGui::SliderFloat("Wind", &m_Wind, -300.0f, 300.0f, "%.1f px/s");
+		ImGui::Checkbox("Chimney smoke", &m_ChimneySmoke);
+		bool parallel = m_Particles->IsParallel();
+		if (ImGui::Checkbox("Parallel update", &parallel))
+			m_Particles->SetParallel(parallel);
+
+		const ParticleStats& stats = m_Particles->GetStats();
+		ImGui::Text("Particles: %u live of %u (%u slots in use)", stats.Live, stats.Capacity, stats.HighWater);
+		ImGui::Text("Emitted %u, killed %u this frame", stats.Emitted, stats.Killed);
+		ImGui::Text("Update: %.3f ms, upload: %zu KiB", stats.UpdateMilliseconds, stats.UploadBytes / 1024);
+	}
+
+	if (ImGui::CollapsingHeader("Distant village"))
+	{
+		int houseCount = (int)m_DistantHouseCount;
+		if (ImGui::SliderInt("Houses", &houseCount, 0, 20000))
+		{
+			m_DistantHouseCount = (uint32_t)houseCount;
+			PopulateDistantVillage();
+			m_ForegroundCache->Invalidate();
+			m_FullRedrawRequested = true;
+		}
+		ImGui::Text("Visible: %u houses, %u trees (%zu each in total)", m_HousePrefab->GetVisibleCount(),
+			m_TreePrefab->GetVisibleCount(), m_HousePrefab->GetInstances().size());
+	}
+
+	if (ImGui::CollapsingHeader("Procedural village"))
+	{
+		if (ImGui::Checkbox("Show procedural village", &m_ProceduralVillage))
+		{
+			// Created on first use, so the cache directory only appears once
+			// the village has actually been shown
+			if (m_ProceduralVillage && !m_VillageStreamer)
+				m_VillageStreamer = std::make_unique<VillageStreamer>((uint64_t)m_VillageSeed, Application::Get().GetJobSystem(), "cache/village");
+			m_FullRedrawRequested = true;
+		}
+		ImGui::TextDisabled("Pan with WASD");
+		ImGui::Checkbox("Auto pan", &m_AutoPan);
+		ImGui::SliderFloat("Pan speed", &m_PanSpeed, 50.0f, 4000.0f, "%.0f px/s");
+		if (ImGui::InputInt("Seed", &m_VillageSeed) && m_VillageStreamer)
+			m_VillageStreamer->SetSeed((uint64_t)m_VillageSeed);
+
+		if (m_VillageStreamer)
+		{
+			int margin = (int)m_VillageStreamer->GetMargin();
+			if (ImGui::SliderInt("Load margin", &margin, 0, 4, "%d chunks"))
+				m_VillageStreamer->SetMargin((uint32_t)margin);
+			bool cache = m_VillageStreamer->IsCacheEnabled();
+			if (ImGui::Checkbox("Disk cache", &cache))
+				m_VillageStreamer->SetCacheEnabled(cache);
+
+			const VillageStreamerStats& stats = m_VillageStreamer->GetStats();
+			ImGui::Text("Chunks: %u loaded, %u pending, %u unloaded", stats.LoadedChunks, stats.PendingChunks, stats.UnloadedChunks);
+			ImGui::Text("Loaded: %u houses, %u trees, %u roads", stats.Houses, stats.Trees, stats.Roads);
+			ImGui::Text("Visible: %u houses, %u trees", m_RoofPrefab->GetVisibleCount(), m_CanopyPrefab->GetVisibleCount());
+			ImGui::Text("Generated: %u chunks, %.3f ms each", stats.GeneratedChunks, stats.AverageGenerateMilliseconds);
+			ImGui::Text("From cache: %u chunks, %.3f ms each", stats.CachedChunks, stats.AverageCacheMilliseconds);
+			const auto& history = m_VillageStreamer->GetTimingHistory();
+			ImGui::PlotLines("Chunk time (ms)", history.data(), (int)history.size(), 0, nullptr, 0.0f, std::numeric_limits<float>::max(), ImVec2(0.0f, 60.0f));
+			ImGui::Text("Last chunk: %.3f ms", stats.LastChunkMilliseconds);
+		}
+	}
+
+	if (ImGui::CollapsingHeader("On-demand rendering"))
+	{
+		bool onDemand = Application::Get().IsOnDemandRendering();
+		if (ImGui::Checkbox("Render only when something changed", &onDemand))
+		{
+			Application::Get().SetOnDemandRendering(onDemand);
+			m_FullRedrawRequested = true;
+		}
+
+		const DamageTracker& damage = Application::Get().GetDamage();
+		if (damage.IsFull())
+			ImGui::Text("Damage: full frame");
+		else
+			ImGui::Text("Damage: %zu rects", damage.GetRectCount());
+	}
+
+	if (ImGui::CollapsingHeader("Frame clock"))
+	{
+		FrameClock& clock = Application::Get().GetFrameClock();
+
+		size_t count = clock.CopyHistoryMilliseconds(m_FrameTimes, FrameClock::HistorySize);
+		ImGui::PlotLines("Frame time (ms)", m_FrameTimes, (int)count, 0, nullptr, 0.0f, 50.0f, ImVec2(0.0f, 60.0f));
+		ImGui::Text("Frame %llu, smoothed %.3f ms, elapsed %.3f s", (unsigned long long)clock.GetFrameIndex(),
+			clock.GetSmoothedTimestep().GetMilliseconds(), clock.GetTime());
+		ImGui::Text("Frame uniform uploads: %u", Application::Get().GetFrameUniforms().GetUploadCount());
+
+		bool paused = clock.IsPaused();
+		if (ImGui::Checkbox("Paused", &paused))
+			clock.SetPaused(paused);
+		float timeScale = (float)clock.GetTimeScale();
+		if (ImGui::SliderFloat("Time scale", &timeScale, 0.0f, 4.0f, "%.2f"))
+			clock.SetTimeScale(timeScale);
+
+		Application& app = Application::Get();
+		float fixedRate = app.GetFixedUpdateRate();
+		if (ImGui::SliderFloat("Simulation rate (Hz)", &fixedRate, 10.0f, 240.0f, "%.0f"))
+			app.SetFixedUpdateRate(fixedRate);
+		int maxSteps = (int)app.GetMaxFixedUpdateSteps();
+		if (ImGui::SliderInt("Max steps per frame", &maxSteps, 1, 16))
+			app.SetMaxFixedUpdateSteps((uint32_t)maxSteps);
+	}
+
+	if (ImGui::CollapsingHeader("Frame pacing"))
+	{
+		FramePacer& pacer = Application::Get().GetFramePacer();
+
+		int mode = (int)pacer.GetMode();
+		const char* modeNames[] = {
+			FramePacer::GetModeName(FramePacingMode::VSync),
+			FramePacer::GetModeName(FramePacingMode::AdaptiveVSync),
+			FramePacer::GetModeName(FramePacingMode::Uncapped),
+			FramePacer::GetModeName(FramePacingMode::Limited),
+			FramePacer::GetModeName(FramePacingMode::LowLatency)
+		};
+		if (ImGui::Combo("Mode", &mode, modeNames, IM_ARRAYSIZE(modeNames)))
+			pacer.SetMode((FramePacingMode)mode);
+
+		float targetRate = pacer.GetTargetRate();
+		if (ImGui::SliderFloat("Target rate (Hz)", &targetRate, 24.0f, 240.0f, "%.0f"))
+			pacer.SetTargetRate(targetRate);
+
+		const FramePacingStats& stats = pacer.GetStats();
+		ImGui::Text("Present interval %.3f ms, jitter %.3f ms (worst %.3f ms)", stats.AverageIntervalMs, stats.JitterMs, stats.MaxDeviationMs);
+	}
+
+	if (ImGui::CollapsingHeader("Memory"))
+	{
+		Application& app = Application::Get();
+		const LinearAllocator& frameAllocator = app.GetFrameAllocator();
+		ImGui::Text("Frame allocator: %.1f / %.1f KiB (peak %.1f KiB, %u overflows)",
+			frameAllocator.GetUsed() / 1024.0f, frameAllocator.GetCapacity() / 1024.0f,
+			frameAllocator.GetPeak() / 1024.0f, frameAllocator.GetOverflowCount());
+
+		if (!AllocationTracker::IsEnabled())
+		{
+			ImGui::TextDisabled("Build with GLCORE_TRACK_ALLOCATIONS to count heap allocations");
+		}
+		else
+		{
+			const AllocationStats& frame = app.GetFrameAllocations();
+			ImGui::Text("Heap allocations last frame: %llu (%llu bytes), %llu frees",
+				(unsigned long long)frame.Count, (unsigned long long)frame.Bytes, (unsigned long long)frame.FreeCount);
+
+			AllocationTracker::GetScopeStats(m_AllocationScopes);
+			for (const AllocationScopeStats& scope : m_AllocationScopes)
+			{
+				ImGui::BulletText("%s: %llu allocations last frame, %llu total", scope.Name,
+					(unsigned long long)scope.LastFrame.Count, (unsigned long long)scope.Total.Count);
+			}
+		}
+
+		AssetStats assets = app.GetAssets().GetStats();
+		FileSystemStats files = app.GetFileSystem().GetStats();
+		ImGui::Text("Assets: %u requests, %u shared, %u files cached",
+			assets.Requests, assets.Hits, assets.CachedFiles);
+		ImGui::Text("Shader programs: %u alive, %u compiled (%zu of %u scene permutations)",
+			assets.LoadedShaders, assets.CompiledPrograms, m_SceneShaders->GetCompiledCount(), 1u << m_SceneShaders->GetKeywords().size());
+		ImGui::Text("File reads: %u from pack, %u loose, %u missing", files.PackReads, files.LooseReads, files.Misses);
+
+		GLResourceStats resources = app.GetDeletionQueue().GetStats();
+		ImGui::Text("GL objects: %u buffers, %u vertex arrays, %u textures, %u programs, %u framebuffers",
+			resources.Live[(size_t)GLResourceType::Buffer], resources.Live[(size_t)GLResourceType::VertexArray],
+			resources.Live[(size_t)GLResourceType::Texture], resources.Live[(size_t)GLResourceType::Program],
+			resources.Live[(size_t)GLResourceType::Framebuffer]);
+		ImGui::Text("Pending deletion: %u objects over %u frames (%llu deleted)",
+			resources.Pending, resources.PendingFrames, (unsigned long long)resources.Deleted);
+
+		BufferHeapStats meshes = m_MeshHeap->GetStats();
+		ImGui::Text("Mesh heap: %zu meshes, %.1f / %.1f KiB in %u pages",
+			m_MeshHeap->GetMeshCount(), meshes.Used / 1024.0f, meshes.Capacity / 1024.0f, meshes.Pages);
+		ImGui::Text("%u free ranges, largest %.1f KiB, %.0f%% fragmented",
+			meshes.FreeRanges, meshes.LargestFreeRange / 1024.0f, meshes.Fragmentation * 100.0f);
+		if (ImGui::Button("Defragment mesh heap"))
+			m_MeshHeap->Defragment();
+		if (meshes.LastDefragmentMovedBytes > 0)
+		{
+			ImGui::SameLine();
+			ImGui::Text("last pass moved %.1f KiB", meshes.LastDefragmentMovedBytes / 1024.0f);
+		}
+	}
+
+	if (ImGui::CollapsingHeader("Capture"))
+	{
+		FrameCapture& capture = Application::Get().GetFrameCapture();
+
+		const char* formatNames[] = {
+			GetCaptureFormatName(CaptureFormat::PNG),
+			GetCaptureFormatName(CaptureFormat::Raw),
+			GetCaptureFormatName(CaptureFormat::Y4M)
+		};
+		ImGui::Combo("Format", &m_CaptureFormat, formatNames, IM_ARRAYSIZE(formatNames));
+
+		if (!capture.IsRecording() && ImGui::Button("Record"))
+		{
+			CaptureSettings settings;
+			settings.Format = (CaptureFormat)m_CaptureFormat;
+			settings.OutputPath = "captures/village_" + std::to_string(m_RecordingCount++);
+			settings.FrameRate = (uint32_t)Application::Get().GetFramePacer().GetTargetRate();
+			capture.StartRecording(settings);
+			// Record every frame, not only the damaged ones
+			m_OnDemandBeforeRecording = Application::Get().IsOnDemandRendering();
+			Application::Get().SetOnDemandRendering(false);
+		}
+		else if (capture.IsRecording() && ImGui::Button("Stop"))
+		{
+			capture.StopRecording();
+			Application::Get().SetOnDemandRendering(m_OnDemandBeforeRecording);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Screenshot"))
+			capture.RequestScreenshot("captures/screenshot_" + std::to_string(m_ScreenshotCount++));
+
+		CaptureStats stats = capture.GetStats();
+		ImGui::Text("Captured %u, written %u, pending %u", stats.Captured, stats.Written, stats.Pending);
+		ImGui::Text("Dropped %u, failed %u", stats.Dropped, stats.Failed);
+	}
+
+	if (ImGui::CollapsingHeader("OpenGL debug output"))
+	{
+		GetGLDebugReport(m_GLDebugReport, 5, GL_DEBUG_TYPE_PERFORMANCE);
+		ImGui::Text("Top performance warnings:");
+		for (const auto& stats : m_GLDebugReport)
+			ImGui::TextWrapped("%u/frame (%llu total) #%u: %s", stats.LastFrameCount, (unsigned long long)stats.TotalCount, stats.ID, stats.Message);
+
+		GetGLDebugReport(m_GLDebugReport, 5);
+		ImGui::Text("Top messages:");
+		for (const auto& stats : m_GLDebugReport)
+			ImGui::TextWrapped("%u/frame (%llu total) [%s %s] #%u: %s", stats.LastFrameCount, (unsigned long long)stats.TotalCount,
+				GLDebugSourceName(stats.Source), GLDebugTypeName(stats.Type), stats.ID, stats.Message);
+	}
 	ImGui::End();
 }
@@ -3,6 +3,8 @@
 #include <GLCore.h>
 #include <GLCoreUtils.h>
 
+#include "VillageStreamer.h"
+
 class VillageLayer : public GLCore::Layer
 {
 public:
@@ -13,17 +15,128 @@ public:
 	virtual void OnDetach() override;
 	virtual void OnEvent(GLCore::Event& event) override;
 	virtual void OnUpdate(GLCore::Timestep ts) override;
+	virtual void OnFixedUpdate(GLCore::Timestep ts) override;
 	virtual void OnImGuiRender() override;
 private:
-	GLCore::Utils::Shader* m_Shader;
+	uint64_t MakeSortKey(float depth, GLuint shader) const;
+	void SubmitQuads(uint32_t first, uint32_t count);
+	void SubmitPrefabs(const glm::vec4& worldBounds);
+	void FlushDraws();
+
+	void CreatePrefabs();
+	void PopulateDistantVillage();
+
+	void UpdateProceduralVillage(GLCore::Timestep ts);
+	void PopulateProceduralVillage();
+	void SubmitProceduralVillage(const glm::vec4& worldBounds);
+
+	void ResizeView(uint32_t width, uint32_t height);
+
+	void RenderVillage(uint32_t width, uint32_t height);
+	void UpdateCaches(uint32_t width, uint32_t height, const glm::mat4& viewProjection);
+	void RenderScene();
+
+	void SubmitLights();
+	void UpdateWeather(GLCore::Timestep ts);
+
+	void AddOverdrawPasses(GLCore::Utils::FrameGraph& graph);
+	void RenderOverdrawCount();
+
+	void AddSweptDamage(GLCore::DamageRect& lastSweep, const GLCore::DamageRect& sweep);
+	void AddWorldDamage(const GLCore::DamageRect& rect);
+private:
+	// Permutations of test.vert/test.frag, keyed by INSTANCED and OVERDRAW
+	GLCore::Ref<GLCore::Utils::ShaderVariants> m_SceneShaders;
+	uint32_t m_InstancedBit = 0, m_OverdrawBit = 0;
+	GLCore::Ref<GLCore::Utils::Shader> m_Shader;
+	GLCore::Ref<GLCore::Utils::Shader> m_CompositeShader;
+	GLCore::Ref<GLCore::Utils::Shader> m_OverdrawHeatmapShader;
 	GLCore::Utils::OrthographicCameraController m_CameraController;
 
-	GLuint m_QuadVA = 0, m_QuadVB = 0, m_QuadIB = 0;
+	std::unique_ptr<GLCore::Utils::MeshHeap> m_MeshHeap;
+	GLCore::Utils::MeshHeap::Mesh m_QuadMesh = GLCore::Utils::MeshHeap::InvalidMesh;
+
+	// Copies of the house and tree on the far ground, drawn with instancing
+	std::unique_ptr<GLCore::Utils::Prefab> m_HousePrefab, m_TreePrefab;
+	uint32_t m_DistantHouseCount = 240;
+
+	// A top-down village of endless chunks streamed in around the camera,
+	// shown instead of the scene. Roads, roofs and tree tops are unit-sized
+	// prefabs scaled and tinted per instance.
+	std::unique_ptr<VillageStreamer> m_VillageStreamer;
+	std::unique_ptr<GLCore::Utils::Prefab> m_RoadPrefab, m_RoofPrefab, m_CanopyPrefab;
+	bool m_ProceduralVillage = false;
+	bool m_AutoPan = true;
+	int m_VillageSeed = 1;
+	// In pixels per second
+	float m_PanSpeed = 400.0f;
+	float m_VillageCameraPosition[2]{ 0.0f, 0.0f };
+
+	enum class DrawOrder { FrontToBack, Painters };
+	GLCore::Utils::DrawQueue m_DrawQueue;
+	DrawOrder m_DrawOrder = DrawOrder::FrontToBack;
+
+	bool m_ShowOverdraw = false;
+	GLuint m_OverdrawQueries[2] = {};
+	GLCore::Utils::GLVertexArray m_FullscreenVA;
+	GLCore::Utils::FrameGraphResource m_OverdrawCount = GLCore::Utils::InvalidFrameGraphResource;
+	uint32_t m_OverdrawFrame = 0;
+	float m_FragmentsPerPixel = 0.0f;
+
+	std::unique_ptr<GLCore::Utils::CachedRenderLayer> m_BackgroundCache, m_ForegroundCache;
+	bool m_CacheStaticLayers = true;
+
+	// Used for on-demand rendering, where only damaged regions are redrawn
+	std::unique_ptr<GLCore::Utils::Framebuffer> m_SceneFramebuffer;
+	glm::mat4 m_LastViewProjection = glm::mat4(1.0f);
+	bool m_FullRedrawRequested = true;
+	// Scene resolution follows the measured GPU time
+	std::unique_ptr<GLCore::Utils::DynamicResolution> m_DynamicResolution;
+	GLCore::Utils::FrameGraphResource m_SceneColor = GLCore::Utils::InvalidFrameGraphResource;
+
+	// Window lights over a day/night ambient, multiplied over the scene
+	std::unique_ptr<GLCore::Utils::TiledLighting> m_Lighting;
+	GLCore::Ref<GLCore::Utils::Shader> m_LightAccumulateShader;
+	bool m_LightingEnabled = false;
+	// 0 is midnight, 0.5 is noon
+	float m_TimeOfDay = 0.85f;
+	// In seconds per day; 0 stops the cycle
+	float m_DayLength = 60.0f;
+
+	// Rain or snow over the whole view, and smoke from the house's chimney
+	enum class Weather { Clear, Rain, Snow };
+	std::unique_ptr<GLCore::Utils::ParticleSystem> m_Particles;
+	GLCore::Ref<GLCore::Utils::Shader> m_ParticleShader;
+	Weather m_Weather = Weather::Clear;
+	bool m_ChimneySmoke = true;
+	// Particles per second
+	float m_WeatherRate = 4000.0f;
+	// In pixels per second
+	float m_Wind = 40.0f;
+	// Fractional particles carried to the next frame
+	float m_WeatherAccumulator = 0.0f, m_SmokeAccumulator = 0.0f;
+
+	GLCore::DamageRect m_BirdsSweep, m_BigCloudSweep, m_SmallCloudSweep;
 
 	int m_Borders[2]{-320, 1280};
 	float m_BirdsOffset[2]{465.0f, 0.0f}, m_BigCloudOffset[2]{ 505.0f, 0.0f }, m_SmallCloudOffset[2]{ 375.0f, 0.0f };
 
-	float m_BigCloudSpeed = 0.2f;
-	float m_SmallCloudSpeed = 0.4f;
-	float m_BirdSpeed = 1.65f;
+	float m_BirdsPreviousX = m_BirdsOffset[0], m_BigCloudPreviousX = m_BigCloudOffset[0], m_SmallCloudPreviousX = m_SmallCloudOffset[0];
+
+	// In pixels per second
+	float m_BigCloudSpeed = 12.0f;
+	float m_SmallCloudSpeed = 24.0f;
+	float m_BirdSpeed = 99.0f;
+
+	// Kept between frames so the debug UI doesn't allocate
+	std::vector<const char*> m_ExecutedPasses, m_CulledPasses;
+	std::vector<GLCore::AllocationScopeStats> m_AllocationScopes;
+
+	int m_CaptureFormat = 0;
+	uint32_t m_RecordingCount = 0, m_ScreenshotCount = 0;
+	// Recording renders every frame; the mode it replaced comes back on Stop
+	bool m_OnDemandBeforeRecording = false;
+
+	std::vector<GLCore::Utils::GLDebugMessageStats> m_GLDebugReport;
+	float m_FrameTimes[GLCore::FrameClock::HistorySize];
 };
\ No newline at end of file
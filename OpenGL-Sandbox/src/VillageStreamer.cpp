@@ -0,0 +1,177 @@
+#include "VillageStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+using namespace GLCore;
+
+VillageStreamer::VillageStreamer(uint64_t seed, JobSystem& jobSystem, const std::string& cacheDirectory)
+	: m_Generator(seed), m_JobSystem(jobSystem), m_CacheDirectory(cacheDirectory), m_CacheEnabled(!cacheDirectory.empty())
+{
+	if (!m_CacheEnabled)
+		return;
+
+	std::error_code error;
+	std::filesystem::create_directories(m_CacheDirectory, error);
+	if (error)
+	{
+		LOG_WARN("Can't create the village cache directory '{0}': {1}", m_CacheDirectory, error.message());
+		m_CacheDirectory.clear();
+		m_CacheEnabled = false;
+	}
+}
+
+void VillageStreamer::SetSeed(uint64_t seed)
+{
+	if (seed == m_Generator.GetSeed())
+		return;
+
+	m_Generator = VillageGenerator(seed);
+	Reset();
+}
+
+void VillageStreamer::SetCacheEnabled(bool enabled)
+{
+	// Without a directory there is nowhere to cache to
+	m_CacheEnabled = enabled && !m_CacheDirectory.empty();
+}
+
+void VillageStreamer::Reset()
+{
+	m_Chunks.clear();
+	m_Pending.clear();
+	m_Generation++;
+	m_ChunksChanged = true;
+
+	m_Stats = {};
+	m_GenerateMilliseconds = 0.0;
+	m_CacheMilliseconds = 0.0;
+	m_TimingHistory.fill(0.0f);
+}
+
+void VillageStreamer::RequestChunk(int32_t x, int32_t y)
+{
+	m_Pending.insert(MakeKey(x, y));
+
+	std::string path = m_CacheEnabled ? m_Generator.GetCachePath(m_CacheDirectory, x, y) : std::string();
+	m_JobSystem.Submit([results = m_Results.GetSink(), generator = m_Generator, generation = m_Generation, path = std::move(path), x, y]()
+	{
+		ChunkResult result;
+		result.Generation = generation;
+
+		uint64_t start = FrameClock::Now();
+		result.FromCache = !path.empty() && generator.LoadChunk(path, x, y, result.Chunk);
+		if (!result.FromCache)
+			result.Chunk = generator.Generate(x, y);
+		result.Milliseconds = (FrameClock::Now() - start) * 1e-6;
+
+		// Outside the timing, so generated and cached chunks are compared fairly.
+		// A failed write only means the chunk is generated again next time.
+		if (!result.FromCache && !path.empty())
+			generator.SaveChunk(path, result.Chunk);
+
+		results.Push(std::move(result));
+	});
+}
+
+bool VillageStreamer::CollectChunks()
+{
+	m_Results.Collect(m_Completed);
+
+	bool collected = false;
+	for (ChunkResult& result : m_Completed)
+	{
+		// Built for a seed that has since been replaced
+		if (result.Generation != m_Generation)
+			continue;
+
+		if (result.FromCache)
+		{
+			m_Stats.CachedChunks++;
+			m_CacheMilliseconds += result.Milliseconds;
+			m_Stats.AverageCacheMilliseconds = m_CacheMilliseconds / m_Stats.CachedChunks;
+		}
+		else
+		{
+			m_Stats.GeneratedChunks++;
+			m_GenerateMilliseconds += result.Milliseconds;
+			m_Stats.AverageGenerateMilliseconds = m_GenerateMilliseconds / m_Stats.GeneratedChunks;
+		}
+		m_Stats.LastChunkMilliseconds = result.Milliseconds;
+		std::copy(m_TimingHistory.begin() + 1, m_TimingHistory.end(), m_TimingHistory.begin());
+		m_TimingHistory.back() = (float)result.Milliseconds;
+
+		uint64_t key = MakeKey(result.Chunk.X, result.Chunk.Y);
+		m_Pending.erase(key);
+		m_Chunks[key] = std::move(result.Chunk);
+		collected = true;
+	}
+	m_Completed.clear();
+	return collected;
+}
+
+bool VillageStreamer::Update(const glm::vec4& worldBounds)
+{
+	bool changed = CollectChunks() || m_ChunksChanged;
+	m_ChunksChanged = false;
+
+	float size = (float)VillageGenerator::ChunkSize;
+	int32_t margin = (int32_t)m_Margin;
+	int32_t minX = (int32_t)std::floor(worldBounds.x / size) - margin, minY = (int32_t)std::floor(worldBounds.y / size) - margin;
+	int32_t maxX = (int32_t)std::floor(worldBounds.z / size) + margin, maxY = (int32_t)std::floor(worldBounds.w / size) + margin;
+
+	m_Missing.clear();
+	for (int32_t y = minY; y <= maxY; y++)
+	{
+		for (int32_t x = minX; x <= maxX; x++)
+		{
+			uint64_t key = MakeKey(x, y);
+			if (m_Chunks.find(key) == m_Chunks.end() && m_Pending.find(key) == m_Pending.end())
+				m_Missing.push_back({ x, y });
+		}
+	}
+
+	// Chunks under the middle of the view first
+	float centerX = (worldBounds.x + worldBounds.z) * 0.5f / size - 0.5f;
+	float centerY = (worldBounds.y + worldBounds.w) * 0.5f / size - 0.5f;
+	auto distance = [centerX, centerY](const std::pair<int32_t, int32_t>& chunk)
+	{
+		float dx = chunk.first - centerX, dy = chunk.second - centerY;
+		return dx * dx + dy * dy;
+	};
+	size_t requests = std::min(m_Missing.size(), (size_t)MaxRequestsPerFrame);
+	std::partial_sort(m_Missing.begin(), m_Missing.begin() + requests, m_Missing.end(),
+		[&distance](const auto& a, const auto& b) { return distance(a) < distance(b); });
+	for (size_t i = 0; i < requests; i++)
+		RequestChunk(m_Missing[i].first, m_Missing[i].second);
+
+	// One more chunk of slack, so panning back and forth along a border
+	// doesn't unload and reload the same chunks
+	for (auto it = m_Chunks.begin(); it != m_Chunks.end();)
+	{
+		const VillageChunk& chunk = it->second;
+		if (chunk.X >= minX - 1 && chunk.X <= maxX + 1 && chunk.Y >= minY - 1 && chunk.Y <= maxY + 1)
+		{
+			++it;
+			continue;
+		}
+		it = m_Chunks.erase(it);
+		m_Stats.UnloadedChunks++;
+		changed = true;
+	}
+
+	m_Stats.LoadedChunks = (uint32_t)m_Chunks.size();
+	m_Stats.PendingChunks = (uint32_t)m_Pending.size();
+	if (changed)
+	{
+		m_Stats.Roads = m_Stats.Houses = m_Stats.Trees = 0;
+		for (const auto& [key, chunk] : m_Chunks)
+		{
+			m_Stats.Roads += (uint32_t)chunk.Roads.size();
+			m_Stats.Houses += (uint32_t)chunk.Houses.size();
+			m_Stats.Trees += (uint32_t)chunk.Trees.size();
+		}
+	}
+	return changed;
+}
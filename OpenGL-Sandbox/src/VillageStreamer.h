@@ -0,0 +1,105 @@
+#pragma once
+
+#include <GLCore.h>
+
+#include "VillageGenerator.h"
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct VillageStreamerStats
+{
+	uint32_t LoadedChunks = 0;
+	uint32_t PendingChunks = 0;
+	uint32_t Roads = 0, Houses = 0, Trees = 0;
+	// Since the streamer was created or the seed last changed
+	uint32_t GeneratedChunks = 0;
+	uint32_t CachedChunks = 0;
+	uint32_t UnloadedChunks = 0;
+	// Worker time to generate or read one chunk, excluding cache writes
+	double LastChunkMilliseconds = 0.0;
+	double AverageGenerateMilliseconds = 0.0;
+	double AverageCacheMilliseconds = 0.0;
+};
+
+// Keeps the chunks of a VillageGenerator loaded around the camera. Missing
+// chunks are generated on the JobSystem, nearest first, or read back from the
+// disk cache when a previous run already built them; chunks that drift too
+// far out of view are dropped.
+class VillageStreamer
+{
+public:
+	// Chunks requested per Update. After a seed change or a jump the whole
+	// view is missing; asking for the nearest first fills the middle of the
+	// screen before the margin, and later frames pick up the rest.
+	static constexpr uint32_t MaxRequestsPerFrame = 8;
+	static constexpr size_t TimingHistorySize = 64;
+
+	// An empty cache directory turns the disk cache off
+	VillageStreamer(uint64_t seed, GLCore::JobSystem& jobSystem, const std::string& cacheDirectory);
+
+	VillageStreamer(const VillageStreamer&) = delete;
+	VillageStreamer& operator=(const VillageStreamer&) = delete;
+
+	// Drops every chunk; results of jobs still running for the old seed are discarded
+	void SetSeed(uint64_t seed);
+	inline uint64_t GetSeed() const { return m_Generator.GetSeed(); }
+
+	void SetCacheEnabled(bool enabled);
+	inline bool IsCacheEnabled() const { return m_CacheEnabled; }
+
+	// Chunks within this many chunks of the view are loaded ahead of the camera
+	inline void SetMargin(uint32_t margin) { m_Margin = margin; }
+	inline uint32_t GetMargin() const { return m_Margin; }
+
+	// Picks up finished chunks, requests the missing ones overlapping
+	// worldBounds (min x, min y, max x, max y) and unloads distant ones.
+	// Returns true when the set of loaded chunks changed.
+	bool Update(const glm::vec4& worldBounds);
+
+	// Keyed by MakeKey(x, y)
+	inline const std::unordered_map<uint64_t, VillageChunk>& GetChunks() const { return m_Chunks; }
+	inline const VillageStreamerStats& GetStats() const { return m_Stats; }
+	// Per-chunk worker time in milliseconds, oldest first
+	inline const std::array<float, TimingHistorySize>& GetTimingHistory() const { return m_TimingHistory; }
+
+	static inline uint64_t MakeKey(int32_t x, int32_t y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+private:
+	struct ChunkResult
+	{
+		uint32_t Generation;
+		VillageChunk Chunk;
+		bool FromCache;
+		double Milliseconds;
+	};
+
+	void Reset();
+	// Returns true when any chunk was added
+	bool CollectChunks();
+	void RequestChunk(int32_t x, int32_t y);
+private:
+	VillageGenerator m_Generator;
+	GLCore::JobSystem& m_JobSystem;
+	std::string m_CacheDirectory;
+	bool m_CacheEnabled;
+	uint32_t m_Margin = 1;
+
+	std::unordered_map<uint64_t, VillageChunk> m_Chunks;
+	std::unordered_set<uint64_t> m_Pending;
+	GLCore::JobResults<ChunkResult> m_Results;
+	// Bumped by SetSeed so in-flight chunks of the old village are ignored
+	uint32_t m_Generation = 0;
+	bool m_ChunksChanged = false;
+
+	// Scratch for CollectChunks and the missing-chunk scan; panning runs
+	// Update every frame, so they keep their capacity
+	std::vector<ChunkResult> m_Completed;
+	std::vector<std::pair<int32_t, int32_t>> m_Missing;
+
+	VillageStreamerStats m_Stats;
+	double m_GenerateMilliseconds = 0.0, m_CacheMilliseconds = 0.0;
+	std::array<float, TimingHistorySize> m_TimingHistory = {};
+};
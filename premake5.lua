@@ -1,3 +1,9 @@
+newoption
+{
+	trigger = "track-allocations",
+	description = "Count heap allocations per frame (defines GLCORE_TRACK_ALLOCATIONS)"
+}
+
 -- OpenGL-Sandbox
 workspace "OpenGL-Sandbox"
 	architecture "x64"